@@ -3,59 +3,146 @@
 
 // Silicon Labs Matter library for Arduino Nano Matter
 // #include <Matter.h>  // Temporarily commented out for compilation test
+// Report delivery only needs the stack's link state
+#if defined(ARDUINO_ARCH_SILABS) && __has_include(<Matter.h>)
+#include <Matter.h>
+#define MATTER_LINK_STATE 1
+#else
+#define MATTER_LINK_STATE 0
+#endif
 
 #include "src/config/Config.h"
+#include "src/config/ConfigStore.h"
 #include "src/matter/GreenThreadSoilSensorCluster.h"
 #include "src/matter/MatterStandardClusters.h"
 #include "src/matter/CommissioningManager.h"
+#include "src/matter/IcdPolicy.h"
+#include "src/matter/ReportUplink.h"
+#include "src/matter/ConnectivityMonitor.h"
+#include "src/matter/ReportPhase.h"
 #include "src/hardware/SensorManager.h"
 #include "src/hardware/BatteryMonitor.h"
 #include "src/hardware/CalibrationManager.h"
 #include "src/hardware/PowerManager.h"
+#include "src/hardware/EnergyBudget.h"
+#include "src/hardware/AutoCalibrator.h"
+#include "src/hardware/ThresholdWake.h"
+#include "src/hardware/TemperatureCompensator.h"
+#include "src/hardware/RawCapture.h"
+#include "src/hardware/ClimateSensors.h"
+#include "src/hardware/I2cBus.h"
 
 #include "src/ui/StatusDisplay.h"
 #include "src/ui/DisplayFactory.h"
-#include "src/ui/CompositeStatusDisplay.h"
 
 // Constants with proper documentation
 constexpr uint8_t kCalibUpdatePeriod = 10;  // Update calibration every N sensor readings (not seconds)
 
 // Global variables
-uint32_t lastSensorRead = 0;  // Renamed for clarity
+uint32_t nextSensorRead = 0;  // Next measurement slot - see ReportPhase
 bool sleepEventAlreadySent = false;  // Prevent sleep event flooding
 
 // Global objects - using static allocation for embedded safety
-StatusDisplay* statusDisplay = nullptr;  // Points to either primaryDisplay or compositeDisplay
 SensorManager sensorManager;
 BatteryMonitor batteryMonitor;
 CalibrationManager calibrationManager;
 PowerManager powerManager;
+EnergyBudget energyBudget;
+ConfigStore configStore;
+AutoCalibrator autoCalibrator;
+TemperatureCompensator temperatureCompensator;
 
 // Static storage for soil cluster to avoid heap allocation
 static GreenThreadSoilSensorCluster soilCluster(&sensorManager, &batteryMonitor, &calibrationManager, &powerManager);
 
+// Radio ICD/SED configuration - the simulated stack stands in off-target
+#if ICD_THREAD_BACKEND
+static ThreadIcdBackend icdBackend;
+#else
+static SimulatedIcdStack icdBackend;
+#endif
+
 // Static storage for standard Matter clusters (Home Assistant compatibility)
 static MatterStandardClusters standardClusters;
 
-// Static storage for composite display to avoid heap allocation
-static CompositeStatusDisplay compositeDisplay(nullptr, nullptr);
+// Readings queue here and are reported when the link and backoff allow
+static ReportUplink reportUplink;
+// Measurement slots on this node's phase of the interval
+static ReportPhase reportPhase;
+
+// Wake-on-threshold - the comparators watch probe 0 while the CPU sleeps
+#if THRESHOLD_WAKE_ACMP
+static AcmpComparator comparator;
+#else
+static SimulatedComparator comparator;
+#endif
+static ThresholdWake thresholdWake;
 
-// Commissioning manager - will be initialized after statusDisplay is set
+// Bench ADC capture buffer - statically allocated, filled only on command
+static RawCapture rawCapture;
+
+// Optional I2C air (SHT4x) and soil (TMP117) temperature sensors
+static ClimateSensors climateSensors;
+
+// All displays are statically allocated; detection only enables them
+static DisplayPipeline<RgbLedStatusDisplay, OledStatusDisplay, SerialStatusDisplay> displays;
+
+// Commissioning manager - will be initialized after displays are configured
 static CommissioningManager* commissioningManager = nullptr;
 
 // All global objects must use deferred begin() - constructors must be trivial
 // since Wire.begin() hasn't been called yet during static initialization
 
-// Improved SAFE_CALL macro with better safety - parentheses prevent double evaluation
-#define SAFE_CALL(ptr, method, ...) do { \
-  if ((ptr) != nullptr) { \
-    (ptr)->method(__VA_ARGS__); \
-  } \
-} while(0)
-
 // Static message buffer to reduce stack pressure - safer than stack allocation every loop
 static char messageBuffer[64];
 
+// Report one queued reading through the standard clusters - every probe in one exchange.
+// Attribute reports carry no per-report acknowledgement at this layer, so
+// delivery means a commissioned node with the Thread link up; otherwise the
+// reading stays queued and the uplink backs off. The setters only queue the
+// report for the stack, so the radio time charged is the fixed per-report
+// estimate, not anything timed here.
+static bool publishReading(const QueuedReading& reading, uint32_t& radioOnMs, void* context) {
+  radioOnMs = 0;
+  #if MATTER_LINK_STATE
+  if (!Matter.isDeviceCommissioned() || !Matter.isDeviceThreadConnected()) {
+    return false;
+  }
+  #endif
+  for (uint8_t probe = 0; probe < kMoistureProbeCount; probe++) {
+    if (reading.moistureTenths[probe] != QueuedReading::NO_MOISTURE) {
+      standardClusters.updateMoisture(reading.moistureTenths[probe] / 10.0, probe);
+    }
+  }
+  standardClusters.updateBattery(reading.batteryMv / 1000.0, reading.batteryPercent);
+  radioOnMs = kReportRadioMs;
+  return true;
+}
+
+// Link changes from the connectivity monitor - one call per real transition
+static void onConnectivityEvent(ConnectivityEvent event, void* context) {
+  switch (event) {
+    case ConnectivityEvent::ThreadUp:
+      displays.handleEvent(StatusEvent::ThreadConnected);
+      reportUplink.retryNow();  // Drain the queue instead of waiting out the backoff
+      break;
+    case ConnectivityEvent::ThreadDown:
+      displays.handleEvent(StatusEvent::ThreadDisconnected);
+      displays.handleEvent(StatusEvent::ThreadConnectionFailed);
+      break;
+    case ConnectivityEvent::MatterUp:
+      displays.handleEvent(StatusEvent::MatterOnline);
+      reportUplink.retryNow();
+      break;
+    case ConnectivityEvent::MatterDown:
+      displays.handleEvent(StatusEvent::MatterOffline);
+      if (connectivityMonitor.isThreadUp()) {
+        displays.handleEvent(StatusEvent::MatterConnectionFailed);
+      }
+      break;
+  }
+}
+
 // Debug helper to avoid code duplication
 #ifdef DEBUG_SERIAL
 inline void debugPrint(const __FlashStringHelper* msg) {
@@ -67,6 +154,21 @@ inline void debugPrint(const __FlashStringHelper* msg) {
 }
 #endif
 
+#ifdef DEBUG_I2C_SCAN
+static int i2cScanDevices = 0;
+
+void onI2cScanResult(uint8_t status, void* context) {
+  if (status != 0) return;
+  uint8_t addr = (uint8_t)(uintptr_t)context;
+  #ifdef DEBUG_SERIAL
+  Serial.print(F("I2C device at 0x"));
+  if(addr < 16) Serial.print(F("0"));
+  Serial.println(addr, HEX);
+  #endif
+  i2cScanDevices++;
+}
+#endif
+
 void setup() {
   Serial.begin(kSerialBaudRate);
   delay(kInitDelay);
@@ -76,12 +178,8 @@ void setup() {
   // Matter.begin();  // Temporarily commented out for compilation test
   Serial.println(F("✅ Matter framework initialized"));
 
-  // Initialize I2C exactly once - guard against multiple calls during development
-  static bool i2cStarted = false;
-  if (!i2cStarted) {
-    Wire.begin();
-    i2cStarted = true;
-  }
+  // Initialize the shared I2C bus (idempotent - safe across development restarts)
+  i2cBus.begin(kI2cClockHz);
 
   #ifdef DEBUG_I2C_SCAN
   // I2C Scanner for OLED debugging (only in debug builds)
@@ -89,67 +187,84 @@ void setup() {
   Serial.println(F("=== I2C Scanner ==="));
   #endif
   
-  int devices = 0;
   for(byte addr = 1; addr < 127; addr++) {
-    Wire.beginTransmission(addr);
-    if(Wire.endTransmission() == 0) {
-      #ifdef DEBUG_SERIAL
-      Serial.print(F("I2C device at 0x"));
-      if(addr < 16) Serial.print(F("0"));
-      Serial.println(addr, HEX);
-      #endif
-      devices++;
+    // Probes run through the shared queue; drain whenever it fills
+    while (!i2cBus.probe(addr, onI2cScanResult, (void*)(uintptr_t)addr)) {
+      i2cBus.poll();
     }
   }
+  i2cBus.flush(kDisplayDetectionTimeout);
   #ifdef DEBUG_SERIAL
   Serial.print(F("Total devices: "));
-  Serial.println(devices);
+  Serial.println(i2cScanDevices);
   Serial.println(F("=================="));
   #endif
   #endif
 
-  // Initialize display system using factory pattern
-  StatusDisplay* primaryDisplay = DisplayFactory::createPrimaryDisplay();
-  StatusDisplay* secondaryDisplay = DisplayFactory::createSecondaryDisplay();
-  
-  if (secondaryDisplay) {
-    // Use static composite display to avoid heap allocation
-    compositeDisplay.setPrimary(primaryDisplay);
-    compositeDisplay.setSecondary(secondaryDisplay);
-    statusDisplay = &compositeDisplay;
-  } else {
-    // Single display mode
-    statusDisplay = primaryDisplay;
-  }
+  // Enable the displays that match the detected hardware
+  DisplayFactory::configure(displays);
 
-  if (statusDisplay) {
-    statusDisplay->begin();
-    statusDisplay->handleEvent(StatusEvent::BootStarting);
-    statusDisplay->showMessage("Initializing sensor node");
-  }
+  displays.begin();
+  displays.handleEvent(StatusEvent::BootStarting);
+  displays.showMessage("Initializing sensor node");
 
   // Initialize hardware abstraction layer
-  if (statusDisplay) statusDisplay->handleEvent(StatusEvent::BootSensorInit);
+  displays.handleEvent(StatusEvent::BootSensorInit);
+  configStore.begin();
   calibrationManager.begin();
+  powerManager.setConfigStore(&configStore);
+  powerManager.setEnergyBudget(&energyBudget);
+  powerManager.setIcdBackend(&icdBackend);
   powerManager.begin();
+  energyBudget.begin(millis());
+  sensorManager.setCalibrationManager(&calibrationManager);
+  sensorManager.setTemperatureCompensator(&temperatureCompensator);
   sensorManager.begin();
+  autoCalibrator.begin(&calibrationManager, &configStore);
+  thresholdWake.begin(&comparator, &calibrationManager);
   batteryMonitor.begin();
   batteryMonitor.setCalibrationManager(&calibrationManager);
+  climateSensors.begin();
+  #ifdef DEBUG_SERIAL
+  Serial.print(F("[Climate] SHT4x "));
+  Serial.print(climateSensors.air.isPresent() ? F("found") : F("absent"));
+  Serial.print(F(", TMP117 "));
+  Serial.println(climateSensors.soil.isPresent() ? F("found") : F("absent"));
+  #endif
+  temperatureCompensator.begin(&configStore, climateSensors.soil.isPresent());
 
   // Initialize Green Thread Custom Soil Sensor Cluster
-  if (statusDisplay) statusDisplay->handleEvent(StatusEvent::BootMatterInit);
+  displays.handleEvent(StatusEvent::BootMatterInit);
   #ifdef DEBUG_SERIAL
   Serial.println(F("\n=== Initializing Custom Soil Sensor Cluster ==="));
   #endif
   
   // Initialize the static soil cluster (no heap allocation)
+  soilCluster.setConfigStore(&configStore);
+  soilCluster.setAutoCalibrator(&autoCalibrator);
+  soilCluster.setReportUplink(&reportUplink);
+  soilCluster.setConnectivityMonitor(&connectivityMonitor);
+  soilCluster.setClimateSensors(&climateSensors);
+  // Node identity fixes the report phase so a fleet that boots together
+  // spreads out; without a hardware ID fall back to the random serial
+  uint8_t nodeId[8];
+  uint32_t identityHash;
+  if (readNodeIdentity(nodeId)) {
+    identityHash = nodeIdentityHash(nodeId, sizeof(nodeId));
+  } else {
+    identityHash = (uint32_t)random(1, 0x7FFFFFFF);
+  }
+  reportPhase.begin(identityHash, millis());
+  nextSensorRead = reportPhase.firstWake();
+  reportUplink.begin(publishReading, nullptr, identityHash);
+  connectivityMonitor.begin(millis(), onConnectivityEvent, nullptr);
   if (soilCluster.begin()) {
-    if (statusDisplay) statusDisplay->showMessage("Custom cluster ready");
+    displays.showMessage("Custom cluster ready");
     #ifdef DEBUG_SERIAL
     Serial.println(F("✅ Green Thread Soil Sensor Cluster initialized successfully!"));
     #endif
   } else {
-    if (statusDisplay) statusDisplay->showMessage("Custom cluster failed");
+    displays.showMessage("Custom cluster failed");
     #ifdef DEBUG_SERIAL
     Serial.println(F("❌ Failed to initialize Green Thread Soil Sensor Cluster"));
     #endif
@@ -161,9 +276,9 @@ void setup() {
   #endif
   standardClusters.begin();
   
-  // Set unique device information (generate unique serial based on chip ID or random)
+  // Set unique device information (serial derived from the node identity)
   char uniqueSerial[8];
-  snprintf(uniqueSerial, sizeof(uniqueSerial), "GT%04d", random(1000, 9999));
+  snprintf(uniqueSerial, sizeof(uniqueSerial), "GT%04d", (int)(1000 + identityHash % 9000));
   standardClusters.setDeviceInfo(uniqueSerial, "Garden");
   
   #ifdef DEBUG_SERIAL
@@ -181,26 +296,26 @@ void setup() {
     Serial.println(F("Commission it to your Matter hub with the manual pairing code or QR code"));
     Serial.printf("Manual pairing code: %s\n", Matter.getManualPairingCode().c_str());
     Serial.printf("QR code URL: %s\n", Matter.getOnboardingQRCodeUrl().c_str());
-    if (statusDisplay) statusDisplay->showMessage("Ready to commission");
+    displays.showMessage("Ready to commission");
   } else {
     Serial.println(F("Device is commissioned - waiting for Thread network..."));
-    if (statusDisplay) statusDisplay->showMessage("Connecting to network");
+    displays.showMessage("Connecting to network");
     
     // Wait for Thread network connection
     while (!Matter.isDeviceThreadConnected()) {
       delay(200);
     }
     Serial.println(F("Connected to Thread network"));
-    if (statusDisplay) statusDisplay->showMessage("Connected to network");
+    displays.showMessage("Connected to network");
   }
   */
 
-  // Initialize commissioning manager after statusDisplay is ready
+  // Initialize commissioning manager after displays are ready
   #ifdef DEBUG_SERIAL
   Serial.println(F("\n=== Initializing Commissioning Manager ==="));
   #endif
   
-  static CommissioningManager staticCommissioningManager(statusDisplay);
+  static CommissioningManager staticCommissioningManager(&displays);
   commissioningManager = &staticCommissioningManager;
   commissioningManager->begin();
   
@@ -208,10 +323,8 @@ void setup() {
   Serial.println(F("✅ Commissioning Manager ready - long press button to commission"));
   #endif
 
-  if (statusDisplay) {
-    statusDisplay->handleEvent(StatusEvent::BootComplete);
-    statusDisplay->showMessage("Boot complete");
-  }
+  displays.handleEvent(StatusEvent::BootComplete);
+  displays.showMessage("Boot complete");
 
 }
 
@@ -226,43 +339,92 @@ void loop() {
   if (commissioningManager) commissioningManager->update();
   
   // PRIORITY 3: Light-weight status updates that don't block
-  if (statusDisplay) statusDisplay->update();
+  i2cBus.poll();  // At most one short I2C transaction per pass
+  climateSensors.service(now);  // Reads a conversion that outlasted its wake
+  connectivityMonitor.service(now);  // Link changes latched by stack callbacks
+  displays.update();
+  calibrationManager.service(now, powerManager.getCurrentState());  // Coalesced NVM writes
+  configStore.service(now, powerManager.getCurrentState());
   
   // PRIORITY 3: Check if it's time for heavy sensor operations
-  uint32_t currentSleepInterval = powerManager.getCurrentSleepInterval();
-  if (now - lastSensorRead < currentSleepInterval) {
+  // Signed difference keeps this correct across millis() rollover; a
+  // comparator crossing brings the reading forward
+  bool thresholdCrossed = thresholdWake.takeTrigger();
+  if ((int32_t)(now - nextSensorRead) < 0 && !thresholdCrossed) {
+    // Cycle work is done - close the wake for energy metering
+    energyBudget.endWake(now);
+    
     // Skip heavy operations, just handle power management
     if (powerManager.shouldEnterSleep() && !sleepEventAlreadySent) {
       #ifdef DEBUG_SERIAL
       debugPrint(F("[Main] Entering sleep mode"));
       #endif
       sleepEventAlreadySent = true;
+      // Sleep ends in a reset - commit pending NVM writes unless power is critical
+      calibrationManager.flush(powerManager.getCurrentState());
+      configStore.flush(powerManager.getCurrentState());
+      // The budget resumes from retained RAM on the next boot
+      energyBudget.suspend(now, nextSensorRead - now, reportUplink.getRadioOnMs());
       // Enter sleep FIRST, then handle display event to avoid race condition
       // The RTC/GPIO wake-up will restore the display properly
       powerManager.enterSleepMode();
       // This line never executes due to [[noreturn]] - device resets on wake
-      SAFE_CALL(statusDisplay, handleEvent, StatusEvent::EnteringSleep);
+      displays.handleEvent(StatusEvent::EnteringSleep);
     }
     return; // Exit early to keep loop responsive
   }
   
   // Time for full sensor reading cycle
-  lastSensorRead = now;
   sleepEventAlreadySent = false; // Clear sleep event flag since we're actively taking measurements
 
+  // Radio polls once per measurement wake - keeps the SED poll in phase
+  powerManager.onMeasurementWake(now);
+  thresholdWake.onMeasurementWake();  // Probe pin back to the ADC
+  // Climate sensors convert while the battery work runs
+  climateSensors.start();
+
   // Update power state based on current conditions
   float voltage = batteryMonitor.readVoltage();
   bool usbConnected = DisplayFactory::isUsbConnected();
   BatteryStatus batteryStatus = batteryMonitor.getStatus();
   BatteryState batteryState = batteryMonitor.getBatteryState();
   
-  powerManager.updatePowerState(voltage, usbConnected);
+  uint8_t batteryPercent = batteryMonitor.updateStateOfCharge(voltage);
+  // Power states follow the load-compensated voltage so TX sag can't flip them
+  float stateVoltage = (voltage > 0 && batteryMonitor.hasStateOfCharge()) ? batteryMonitor.getRestingVoltage() : voltage;
+  
+  // Meter the previous cycle (awake time, radio time, SED polls and LED
+  // energy) and re-solve the interval that meets the lifetime target
+  uint32_t displayEnergy = displays.takeEnergyMicrojoules();
+  uint32_t icdPolls = icdPollsPerWake(icdBackend.getParameters(), powerManager.getCurrentSleepInterval());
+  energyBudget.beginWake(now, displayEnergy, reportUplink.getRadioOnMs(), icdPolls, voltage);
+  energyBudget.update(now, batteryPercent, powerManager.getConfiguration().normalSleepInterval,
+                      powerManager.getConfiguration().maxSleepInterval);
+  
+  // Battery states wait for a real charge estimate - Booting holds until then
+  if (usbConnected || batteryMonitor.hasStateOfCharge()) {
+    powerManager.updatePowerState(stateVoltage, usbConnected);
+  }
+  displays.setPowerState(powerManager.getCurrentState());
+
+  #ifdef DEBUG_SERIAL
+  Serial.print(F("[Power] Display energy last cycle: "));
+  Serial.print(displayEnergy);
+  Serial.print(F(" uJ, interval "));
+  Serial.print(powerManager.getCurrentSleepInterval() / 1000);
+  Serial.print(F(" s, projected "));
+  Serial.print(energyBudget.getProjectedDays());
+  Serial.print(F("/"));
+  Serial.print(energyBudget.getTargetDays());
+  Serial.println(F(" days"));
+  #endif
 
   // Battery and power status reporting
   if (batteryState == BatteryState::Healthy) {
     // Battery is connected and functional - show battery details
     if (batteryStatus != BatteryStatus::Normal) {
-      SAFE_CALL(statusDisplay, handleEvent, StatusEvent::BatteryLow);
+      // Latched on the status - shown again only when it changes
+      displays.handleEvent(StatusEvent::BatteryLow, static_cast<uint8_t>(batteryStatus));
       // Use static buffer to reduce stack pressure
       // Use fixed-point arithmetic to avoid floating-point printf
       int voltageInt = (int)(voltage * 100); // Convert to centivolt (e.g., 3.45V -> 345)
@@ -270,11 +432,13 @@ void loop() {
       char statusStr[16];
       strcpy_P(statusStr, batteryMonitor.getBatteryStatusString());
       snprintf(messageBuffer, sizeof(messageBuffer), "Battery: %d.%02dV (%s)", voltageInt/100, voltageInt%100, statusStr);
-      SAFE_CALL(statusDisplay, showMessage, messageBuffer);
+      displays.showMessage(messageBuffer);
+    } else {
+      displays.events().clear(StatusEvent::BatteryLow);
     }
     
     // Show battery status on displays that support it
-    SAFE_CALL(statusDisplay, showBattery, voltage, batteryStatus != BatteryStatus::Normal);
+    displays.showBattery(voltage, batteryStatus != BatteryStatus::Normal);
     
     #ifdef DEBUG_SERIAL
     char statusStr[16]; // Cache the string safely from PROGMEM
@@ -307,7 +471,7 @@ void loop() {
     // Use static buffer and fixed-point arithmetic to avoid floating-point printf
     int voltageInt = (int)(voltage * 100); // Convert to centivolt (e.g., 2.85V -> 285)
     snprintf(messageBuffer, sizeof(messageBuffer), "Dead battery detected: %d.%02dV", voltageInt/100, voltageInt%100);
-    SAFE_CALL(statusDisplay, showMessage, messageBuffer);
+    displays.showMessage(messageBuffer);
     #ifdef DEBUG_SERIAL
     Serial.print(F("[Power] Dead battery detected: "));
     Serial.print(voltageInt/100);
@@ -320,22 +484,77 @@ void loop() {
     #endif
   }
 
-  // Soil moisture read
+  // Only the conversion time the battery work didn't cover is spent here;
+  // the soil temperature has to be in before the moisture scan compensates
+  climateSensors.finish();
+  if (climateSensors.soil.hasReading()) {
+    sensorManager.setSoilTemperature(climateSensors.soil.getTemperatureCentiC());
+  }
+
+  // Soil moisture read - one scan covers every probe
   float moisture = sensorManager.readMoisture();
-  if (statusDisplay) {
-    statusDisplay->handleEvent(StatusEvent::MoisturePublishing);
-    statusDisplay->showMoisture(moisture);
-    statusDisplay->handleEvent(StatusEvent::MoisturePublished);
+  bool sensorFaulted = sensorManager.isFaulted();
+  static SensorFault lastFault[kMaxMoistureProbes] = {};
+  bool anyProbeFaulted = false;
+  for (uint8_t probe = 0; probe < kMoistureProbeCount; probe++) {
+    SensorFault fault = sensorManager.getFault(probe);
+    anyProbeFaulted = anyProbeFaulted || fault != SensorFault::None;
+    if (fault == lastFault[probe]) {
+      continue;
+    }
+    lastFault[probe] = fault;
+    if (fault != SensorFault::None) {
+      snprintf(messageBuffer, sizeof(messageBuffer), "Sensor %u fault 0x%02X", probe, (unsigned)fault);
+      displays.showMessage(messageBuffer);
+      // Same code as the cluster's SystemError - probe index in the top two bits
+      displays.handleEvent(StatusEvent::Error, (uint8_t)((probe << 6) | (uint8_t)fault));
+    }
+    #ifdef DEBUG_SERIAL
+    Serial.print(F("[Sensor] Probe "));
+    Serial.print(probe);
+    Serial.print(F(" fault code: 0x"));
+    Serial.println((uint8_t)fault, HEX);
+    #endif
+  }
+  if (!anyProbeFaulted) {
+    displays.events().clear(StatusEvent::Error);
+  }
+
+  // Readings from a faulted probe are not soil - don't learn or publish them
+  if (!sensorFaulted) {
+    autoCalibrator.addSample(sensorManager.getCompensatedRaw());
+    if (displays.hasSinks()) {
+      displays.handleEvent(StatusEvent::MoisturePublishing);
+      displays.showMoisture(moisture);
+      displays.handleEvent(StatusEvent::MoisturePublished);
+    }
   }
 
   // Matter publishing - update all sensor values
   // Update Green Thread Custom Soil Sensor Cluster
   soilCluster.update();
   
-  // Update standard Matter clusters for Home Assistant compatibility and device identification
-  standardClusters.updateMoisture(moisture);
-  uint8_t batteryPercent = (uint8_t)constrain(((voltage - 2.7) / (3.3 - 2.7)) * 100.0, 0, 100);
-  standardClusters.updateBattery(voltage, batteryPercent);
+  // Next wake on this node's phase slot for the (possibly re-solved)
+  // interval, or the heartbeat while the comparator watches the thresholds
+  uint32_t wakeInterval = thresholdWake.afterMeasurement(soilCluster.getMoistureBands(), sensorManager.getLastRaw(),
+                                                         sensorManager.getCompensatedRaw(), sensorFaulted,
+                                                         powerManager.getCurrentSleepInterval());
+  nextSensorRead = reportPhase.nextWake(now, wakeInterval);
+  
+  // Queue the reading for the standard clusters (Home Assistant compatibility);
+  // the uplink only spends radio time when its backoff allows
+  QueuedReading reading;
+  reading.timestampS = now / 1000;
+  for (uint8_t probe = 0; probe < kMaxMoistureProbes; probe++) {
+    bool reported = probe < kMoistureProbeCount && !sensorManager.isFaulted(probe);
+    reading.moistureTenths[probe] = reported ? (uint16_t)(constrain(sensorManager.getMoisture(probe), 0.0, 100.0) * 10.0 + 0.5)
+                                             : QueuedReading::NO_MOISTURE;
+  }
+  reading.batteryMv = voltage > 0 ? (uint16_t)(voltage * 1000.0) : 0;
+  reading.batteryPercent = batteryPercent;
+  reportUplink.enqueue(reading);
+  reportUplink.service(now);
+  // Without stack callbacks the links stay unreported - availability reads unknown
   
   // Update calibration values periodically (every Nth reading)
   static uint8_t calibUpdateCounter = 0;
@@ -346,42 +565,7 @@ void loop() {
     soilCluster.update(true);
   }
   
-  // Enhanced connection status tracking
-  static bool wasThreadConnected = false;
-  static bool wasMatterOnline = false;
-  
-  // Access Matter status through the custom soil cluster (static object is always valid)
-  bool isMatterOnline = soilCluster.isOnline();
-  
-  // For now, treat Matter online status as both Thread and commission status
-  // since the isOnline() method already checks both conditions
-  bool isThreadConnected = isMatterOnline;  // Simplified for now
-  bool isMatterCommissioned = isMatterOnline;
-  
-  // Thread connection status
-  if (isThreadConnected && !wasThreadConnected) {
-    SAFE_CALL(statusDisplay, handleEvent, StatusEvent::ThreadConnected);
-    wasThreadConnected = true;
-  } else if (!isThreadConnected && wasThreadConnected) {
-    SAFE_CALL(statusDisplay, handleEvent, StatusEvent::ThreadDisconnected);
-    wasThreadConnected = false;
-  }
-  
-  // Matter connection status
-  if (isMatterOnline && !wasMatterOnline) {
-    SAFE_CALL(statusDisplay, handleEvent, StatusEvent::MatterOnline);
-    wasMatterOnline = true;
-  } else if (!isMatterOnline && wasMatterOnline) {
-    SAFE_CALL(statusDisplay, handleEvent, StatusEvent::MatterOffline);
-    wasMatterOnline = false;
-  }
-  
-  // Check for connection failures and handle LED accordingly
-  if (!isThreadConnected) {
-    SAFE_CALL(statusDisplay, handleEvent, StatusEvent::ThreadConnectionFailed);
-  } else if (!isMatterOnline) {
-    SAFE_CALL(statusDisplay, handleEvent, StatusEvent::MatterConnectionFailed);
-  }
+  // Connection status is event-driven - see onConnectivityEvent()
   // Note: Removed the automatic EnteringSleep call here to prevent flooding
   // The LED will turn off automatically after moisture display completes
 }
@@ -444,29 +628,29 @@ void handleSerialCommands() {
     #ifdef DEBUG_SERIAL
     debugPrint(F("Entering sleep mode..."));
     #endif
-    SAFE_CALL(statusDisplay, handleEvent, StatusEvent::EnteringSleep);
+    displays.handleEvent(StatusEvent::EnteringSleep);
     soilCluster.handleEnterSleepMode();
   } else if (strcmp(commandBuffer, "led_off") == 0 || strcmp(commandBuffer, "loff") == 0) {
     #ifdef DEBUG_SERIAL
     debugPrint(F("Force LED OFF..."));
     #endif
-    SAFE_CALL(statusDisplay, handleEvent, StatusEvent::EnteringSleep);
+    displays.handleEvent(StatusEvent::EnteringSleep);
   } else if (strcmp(commandBuffer, "led_green") == 0 || strcmp(commandBuffer, "lgreen") == 0) {
     #ifdef DEBUG_SERIAL
     debugPrint(F("Force LED GREEN..."));
     #endif
-    SAFE_CALL(statusDisplay, handleEvent, StatusEvent::BootStarting);
+    displays.handleEvent(StatusEvent::BootStarting);
   } else if (strcmp(commandBuffer, "led_red") == 0 || strcmp(commandBuffer, "lred") == 0) {
     #ifdef DEBUG_SERIAL
     debugPrint(F("Force LED RED..."));
     #endif
-    SAFE_CALL(statusDisplay, handleEvent, StatusEvent::ThreadConnectionFailed);
+    displays.handleEvent(StatusEvent::ThreadConnectionFailed);
   } else if (strcmp(commandBuffer, "test_red") == 0 || strcmp(commandBuffer, "tr") == 0) {
     #ifdef DEBUG_SERIAL
     Serial.println(F("Test RED LED..."));
     #endif
-    if (statusDisplay) {
-      statusDisplay->testRed();
+    if (displays.hasSinks()) {
+      displays.testRed();
     } else {
       #ifdef DEBUG_SERIAL
       Serial.println(F("Error: No status display available"));
@@ -476,8 +660,8 @@ void handleSerialCommands() {
     #ifdef DEBUG_SERIAL
     Serial.println(F("Test GREEN LED..."));
     #endif
-    if (statusDisplay) {
-      statusDisplay->testGreen();
+    if (displays.hasSinks()) {
+      displays.testGreen();
     } else {
       #ifdef DEBUG_SERIAL
       Serial.println(F("Error: No status display available"));
@@ -487,8 +671,8 @@ void handleSerialCommands() {
     #ifdef DEBUG_SERIAL
     Serial.println(F("Test BLUE LED..."));
     #endif
-    if (statusDisplay) {
-      statusDisplay->testBlue();
+    if (displays.hasSinks()) {
+      displays.testBlue();
     } else {
       #ifdef DEBUG_SERIAL
       Serial.println(F("Error: No status display available"));
@@ -498,8 +682,8 @@ void handleSerialCommands() {
     #ifdef DEBUG_SERIAL
     Serial.println(F("Test LED OFF..."));
     #endif
-    if (statusDisplay) {
-      statusDisplay->testOff();
+    if (displays.hasSinks()) {
+      displays.testOff();
     } else {
       #ifdef DEBUG_SERIAL
       Serial.println(F("Error: No status display available"));
@@ -557,6 +741,19 @@ void handleSerialCommands() {
       Serial.println(F(" seconds"));
       #endif
     }
+  } else if (strncmp(commandBuffer, "lead ", 5) == 0) {
+    // Parse "lead minutes" - DryForecast event lead time
+    char* endPtr;
+    long lead = strtol(commandBuffer + 5, &endPtr, 10);
+    if (endPtr != commandBuffer + 5 && lead >= 1 && lead <= kDryForecastMaxLeadMinutes) {
+      soilCluster.handleSetDryForecastLead((uint16_t)lead);
+    } else {
+      #ifdef DEBUG_SERIAL
+      Serial.print(F("Error: Lead must be between 1-"));
+      Serial.print(kDryForecastMaxLeadMinutes);
+      Serial.println(F(" minutes"));
+      #endif
+    }
   } else if (strcmp(commandBuffer, "cluster") == 0) {
     // Show detailed cluster information
     #ifdef DEBUG_SERIAL
@@ -573,6 +770,215 @@ void handleSerialCommands() {
     Serial.println(soilCluster.isSensorHealthy() ? F("HEALTHY") : F("ERROR"));
     Serial.println(F("======================================"));
     #endif
+  } else if (strncmp(commandBuffer, "autocal", 7) == 0) {
+    // "autocal" shows the proposal, "autocal off|propose|apply|reset" changes it
+    const char* arg = commandBuffer[7] == ' ' ? commandBuffer + 8 : "";
+    if (strcmp(arg, "off") == 0) {
+      autoCalibrator.setMode(AutoCalMode::Off);
+    } else if (strcmp(arg, "propose") == 0) {
+      autoCalibrator.setMode(AutoCalMode::Propose);
+    } else if (strcmp(arg, "apply") == 0) {
+      autoCalibrator.setMode(AutoCalMode::Apply);
+    } else if (strcmp(arg, "reset") == 0) {
+      autoCalibrator.reset();
+    }
+    #ifdef DEBUG_SERIAL
+    int dryValue, wetValue;
+    Serial.print(F("[AutoCal] Mode "));
+    Serial.print((int)autoCalibrator.getMode());
+    Serial.print(F(", samples "));
+    Serial.print(autoCalibrator.getSampleCount());
+    Serial.print(F(", confidence "));
+    Serial.print(autoCalibrator.getConfidence());
+    Serial.print(F("%"));
+    if (autoCalibrator.getProposal(dryValue, wetValue)) {
+      Serial.print(F(", proposed dry="));
+      Serial.print(dryValue);
+      Serial.print(F(" wet="));
+      Serial.print(wetValue);
+    }
+    Serial.println();
+    #endif
+  } else if (strncmp(commandBuffer, "wake", 4) == 0) {
+    // "wake" shows the mode, "wake periodic|threshold" changes it
+    const char* arg = commandBuffer[4] == ' ' ? commandBuffer + 5 : "";
+    if (strcmp(arg, "periodic") == 0) {
+      thresholdWake.setEnabled(false);
+    } else if (strcmp(arg, "threshold") == 0) {
+      thresholdWake.setEnabled(true);
+    }
+    #ifdef DEBUG_SERIAL
+    Serial.print(F("[Wake] "));
+    Serial.print(thresholdWake.isEnabled() ? F("threshold") : F("periodic"));
+    Serial.print(F(", comparator "));
+    Serial.print(thresholdWake.isArmed() ? F("armed") : F("idle"));
+    Serial.print(F(", crossings "));
+    Serial.print(thresholdWake.getTriggerCount());
+    Serial.print(F(" of "));
+    Serial.print(thresholdWake.getArmCount());
+    Serial.println(F(" sleeps"));
+    #endif
+  } else if (strncmp(commandBuffer, "tempcomp", 8) == 0) {
+    // "tempcomp" shows the coefficients, "tempcomp off|fixed|learn|reset"
+    // changes the mode, "tempcomp <probe> <counts/degC>" configures one
+    const char* arg = commandBuffer[8] == ' ' ? commandBuffer + 9 : "";
+    if (strcmp(arg, "off") == 0) {
+      temperatureCompensator.setMode(TempCompMode::Off);
+    } else if (strcmp(arg, "fixed") == 0) {
+      temperatureCompensator.setMode(TempCompMode::Configured);
+    } else if (strcmp(arg, "learn") == 0) {
+      temperatureCompensator.setMode(TempCompMode::Learn);
+    } else if (strcmp(arg, "reset") == 0) {
+      temperatureCompensator.reset();
+    } else if (*arg) {
+      char* cursor;
+      long probe = strtol(arg, &cursor, 10);
+      float countsPerDegree = strtod(cursor, nullptr);
+      if (cursor == arg || probe < 0 || probe >= kMoistureProbeCount) {
+        #ifdef DEBUG_SERIAL
+        debugPrint(F("Error: tempcomp <probe> <counts/degC>"));
+        #endif
+        return;
+      }
+      temperatureCompensator.setConfiguredCoefficient((uint8_t)probe, (int16_t)lroundf(countsPerDegree * 256.0f));
+    }
+    #ifdef DEBUG_SERIAL
+    int16_t temperature;
+    Serial.print(F("[TempComp] Mode "));
+    Serial.print((int)temperatureCompensator.getMode());
+    Serial.print(F(", temperature "));
+    if (sensorManager.getTemperature(temperature)) {
+      Serial.print(temperature / 100.0, 2);
+      Serial.println(F(" C"));
+    } else {
+      Serial.println(F("n/a"));
+    }
+    for (uint8_t probe = 0; probe < kMoistureProbeCount; probe++) {
+      Serial.print(F("  Probe "));
+      Serial.print(probe);
+      Serial.print(F(": "));
+      Serial.print(temperatureCompensator.getCoefficient(probe) / 256.0, 2);
+      Serial.print(F(" counts/C, learned "));
+      Serial.print(temperatureCompensator.getLearnedCoefficient(probe) / 256.0, 2);
+      Serial.print(F(" from "));
+      Serial.print(temperatureCompensator.getLearnedPairs(probe));
+      if (temperatureCompensator.isLearned(probe)) {
+        Serial.println(F(" points"));
+      } else if (temperatureCompensator.hasStoredCoefficient(probe)) {
+        Serial.println(F(" points (using the stored fit)"));
+      } else {
+        Serial.println(F(" points (not yet trusted)"));
+      }
+    }
+    #endif
+  } else if (strncmp(commandBuffer, "capture", 7) == 0) {
+    // "capture [samples] [rate_hz] [probe]" - raw ADC burst for the bench
+    char* cursor = commandBuffer + 7;
+    long samples = strtol(cursor, &cursor, 10);
+    long rateHz = strtol(cursor, &cursor, 10);
+    long probe = strtol(cursor, &cursor, 10);
+    if (samples == 0) samples = kRawCaptureDefaultCount;
+    if (rateHz == 0) rateHz = kRawCaptureDefaultRateHz;
+    if (probe < 0 || probe >= kMoistureProbeCount) {
+      #ifdef DEBUG_SERIAL
+      debugPrint(F("Error: no such probe"));
+      #endif
+      return;
+    }
+    // The comparators hold the probe pin while armed; measure again to re-arm
+    if (thresholdWake.isArmed()) {
+      thresholdWake.onMeasurementWake();
+      nextSensorRead = millis();
+    }
+    if (samples > 0 && rateHz > 0 && rawCapture.capture(kMoisturePins[probe], (uint16_t)min(samples, 65535L), rateHz)) {
+      printRawCapture((uint8_t)probe);
+    } else {
+      #ifdef DEBUG_SERIAL
+      Serial.print(F("Error: capture takes 2-"));
+      Serial.print(kRawCaptureMaxSamples);
+      Serial.print(F(" samples at 1-"));
+      Serial.print(kRawCaptureMaxRateHz);
+      Serial.println(F(" Hz"));
+      #endif
+    }
+  } else if (strcmp(commandBuffer, "events") == 0 || strcmp(commandBuffer, "ev") == 0) {
+    // Status event rates - suppressed events are repeats of a latched link state
+    #ifdef DEBUG_SERIAL
+    Serial.println(F("\n=== Status Events (id: posted/suppressed) ==="));
+    for (uint8_t i = 0; i < kStatusEventCount; i++) {
+      StatusEvent event = static_cast<StatusEvent>(i);
+      uint16_t posted = displays.events().getPostedCount(event);
+      uint16_t suppressed = displays.events().getSuppressedCount(event);
+      if (posted == 0 && suppressed == 0) continue;
+      Serial.print(i);
+      Serial.print(F(": "));
+      Serial.print(posted);
+      Serial.print(F("/"));
+      Serial.println(suppressed);
+    }
+    Serial.print(F("Total suppressed: "));
+    Serial.println(displays.events().getTotalSuppressed());
+    #endif
+  } else if (strcmp(commandBuffer, "link") == 0) {
+    // Link availability since boot
+    #ifdef DEBUG_SERIAL
+    uint32_t nowMs = millis();
+    LinkStats threadStats = connectivityMonitor.getThreadStats(nowMs);
+    LinkStats matterStats = connectivityMonitor.getMatterStats(nowMs);
+    Serial.println(F("\n=== Link Statistics (up s / down s / drops) ==="));
+    Serial.print(F("Thread: "));
+    Serial.print(threadStats.upSeconds);
+    Serial.print(F(" / "));
+    Serial.print(threadStats.downSeconds);
+    Serial.print(F(" / "));
+    Serial.println(threadStats.drops);
+    Serial.print(F("Matter: "));
+    Serial.print(matterStats.upSeconds);
+    Serial.print(F(" / "));
+    Serial.print(matterStats.downSeconds);
+    Serial.print(F(" / "));
+    Serial.println(matterStats.drops);
+    Serial.print(F("Availability: "));
+    if (connectivityMonitor.isMatterKnown()) {
+      Serial.print(connectivityMonitor.getAvailabilityPermille(nowMs) / 10.0, 1);
+      Serial.print(F("%"));
+    } else {
+      Serial.print(F("unknown (no stack link events)"));
+    }
+    Serial.print(F(", queued reports: "));
+    Serial.println(reportUplink.getQueuedCount());
+    Serial.print(F("Report phase: "));
+    Serial.print(reportPhase.getPhase() * 100.0 / 65536.0, 1);
+    Serial.print(F("% of interval, jitter "));
+    Serial.print(reportPhase.getLastJitterMs());
+    Serial.print(F(" ms, next reading in "));
+    Serial.print((int32_t)(nextSensorRead - nowMs));
+    Serial.println(F(" ms"));
+    #endif
+  } else if (strcmp(commandBuffer, "icd") == 0) {
+    // Radio poll plan for the current power state, with a day's poll count
+    #ifdef DEBUG_SERIAL
+    IcdParameters params = deriveIcdParameters(powerManager.getCurrentSleepInterval(),
+                                               powerManager.getCurrentState());
+    uint32_t interval = powerManager.getCurrentSleepInterval();
+    Serial.println(F("\n=== ICD / Sleepy End Device ==="));
+    Serial.print(F("Slow poll: "));
+    Serial.print(params.slowPollMs);
+    Serial.print(F(" ms, fast poll: "));
+    Serial.print(params.fastPollMs);
+    Serial.println(F(" ms"));
+    Serial.print(F("Idle: "));
+    Serial.print(params.idleModeDurationS);
+    Serial.print(F(" s, active: "));
+    Serial.print(params.activeModeDurationMs);
+    Serial.print(F(" ms, check-in: "));
+    Serial.print(params.checkInIntervalS);
+    Serial.println(F(" s"));
+    Serial.print(F("Polls/day coordinated: "));
+    Serial.print(SimulatedIcdStack::pollsPerDay(params, interval, true));
+    Serial.print(F(", free-running: "));
+    Serial.println(SimulatedIcdStack::pollsPerDay(params, interval, false));
+    #endif
   } else if (strcmp(commandBuffer, "commission") == 0 || strcmp(commandBuffer, "comm") == 0) {
     #ifdef DEBUG_SERIAL
     Serial.println(F("Starting commissioning mode..."));
@@ -615,6 +1021,36 @@ void handleSerialCommands() {
   }
 }
 
+// Capture as CSV between '#' header and trailer lines. Not behind
+// DEBUG_SERIAL - the stream is the command's only output.
+void printRawCapture(uint8_t probe) {
+  Serial.print(F("# capture probe "));
+  Serial.print(probe);
+  Serial.print(F(", "));
+  Serial.print(rawCapture.getCount());
+  Serial.print(F(" samples, requested "));
+  Serial.print(rawCapture.getRequestedRateHz());
+  Serial.print(F(" Hz, achieved "));
+  Serial.print(rawCapture.getAchievedRateHz(), 1);
+  Serial.print(F(" Hz, overruns "));
+  Serial.println(rawCapture.getOverruns());
+  Serial.print(F("# min "));
+  Serial.print(rawCapture.getMin());
+  Serial.print(F(", max "));
+  Serial.print(rawCapture.getMax());
+  Serial.print(F(", mean "));
+  Serial.print(rawCapture.getMean(), 2);
+  Serial.print(F(", stddev "));
+  Serial.println(rawCapture.getStdDev(), 2);
+  Serial.println(F("index,raw"));
+  for (uint16_t i = 0; i < rawCapture.getCount(); i++) {
+    Serial.print(i);
+    Serial.print(',');
+    Serial.println(rawCapture.getSample(i));
+  }
+  Serial.println(F("# end"));
+}
+
 void printSerialHelp() {
   // Use single string literals for faster output
   Serial.println(F("\n=== Green Thread Soil Sensor Commands ===\n"
@@ -624,6 +1060,9 @@ void printSerialHelp() {
                    "  info, i          - Show cluster info\n"
                    "  cluster          - Show detailed cluster info\n"
                    "  measure, m       - Force measurement\n"
+                   "  events, ev       - Show status event counters\n"
+                   "  icd              - Show radio poll (ICD) plan\n"
+                   "  link             - Show link availability and report phase\n"
                    "\n"
                    "Commissioning Commands:\n"
                    "  commission, comm - Start commissioning mode\n"
@@ -643,10 +1082,15 @@ void printSerialHelp() {
                    "  calibrate_dry    - Start dry calibration\n"
                    "  calibrate_wet    - Start wet calibration\n"
                    "  reset            - Reset calibration\n"
+                   "  autocal [off|propose|apply|reset] - Self-learning calibration\n"
+                   "  capture [n] [hz] [probe] - Stream n raw ADC samples taken at hz (bench)\n"
+                   "  tempcomp [off|fixed|learn|reset|<probe> <counts/C>] - Moisture temperature compensation\n"
                    "\n"
                    "Configuration Commands:\n"
                    "  threshold <L> <H> - Set moisture thresholds (0-100%)\n"
                    "  interval <sec>    - Set measurement interval (10-3600s)\n"
+                   "  lead <min>        - Dry forecast event lead time (1-10080 min)\n"
+                   "  wake [periodic|threshold] - Sample on the interval, or sleep until a threshold crossing\n"
                    "  sleep            - Enter sleep mode\n"
                    "\n"
                    "Hardware Notes:\n"
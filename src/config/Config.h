@@ -2,9 +2,15 @@
 #include <Arduino.h>
 
 // --- Hardware Pin Configuration ---
-constexpr uint8_t kMoisturePin       = A0;
+constexpr uint8_t kMoisturePin       = A0;     // Probe 0 - drives bands, forecast and auto-calibration
 constexpr uint8_t kBatteryPin        = A1;
 
+// Moisture probes - every fitted probe is scanned in the same wake and report
+constexpr uint8_t kMaxMoistureProbes = 4;      // Calibration record and report slots
+constexpr uint8_t kMoistureProbeCount = 1;     // Probes fitted, 1..kMaxMoistureProbes
+constexpr uint8_t kMoisturePins[kMaxMoistureProbes] = {kMoisturePin, A2, A3, A6};  // Shallow to deep; A4/A5 are I2C
+static_assert(kMoistureProbeCount >= 1 && kMoistureProbeCount <= kMaxMoistureProbes, "kMoistureProbeCount out of range");
+
 // --- Sensor Configuration ---
 constexpr uint32_t kReadIntervalMs   = 30000;  // 30 seconds between readings
 constexpr float    kBatteryLowThresh = 3.30;   // Battery low threshold in volts
@@ -17,10 +23,29 @@ constexpr int kMoistureSensorWet     = 300;    // ADC value for wet soil
 constexpr float kBatteryVoltageDivider = 5.0;  // Voltage divider ratio
 constexpr float kAdcReference         = 1023.0; // ADC reference value
 
+// State of charge - discharge curve and load compensation
+constexpr uint8_t  kBatteryChemistry        = 0;      // 0 = alkaline, 1 = Li-ion, 2 = LiFePO4
+constexpr uint8_t  kBatteryCells            = 2;      // Cells in series (2x AA)
+constexpr uint32_t kBatterySampleLoadUa     = 5000;   // Draw while the battery ADC sample is taken
+constexpr float    kSocVoltageSmoothing     = 0.25;   // EWMA weight of each compensated sample
+
 // --- Display Configuration ---
 constexpr uint8_t kOledI2cAddress    = 0x3C;   // OLED display I2C address
 constexpr uint32_t kDisplayDetectionTimeout = 500; // ms to wait for I2C detection
 constexpr bool kEnableSerialWhenUsbConnected = true; // Enable serial display when USB detected
+// #define OLED_PAGE_BUFFER  // Use a 128 B page buffer instead of the 1 KB frame buffer (RAM-constrained builds)
+
+// --- I2C Bus Configuration ---
+constexpr uint32_t kI2cClockHz       = 400000; // Fast mode; 1000000 if every device supports Fm+
+constexpr uint8_t  kI2cQueueDepth    = 8;      // Queued transactions (OLED needs up to 7 per page)
+constexpr uint8_t  kI2cMaxPayload    = 32;     // Max bytes per transaction (Wire buffer limit)
+
+// --- Climate Sensors (I2C, optional - detected at boot) ---
+constexpr uint8_t  kSht4xI2cAddress    = 0x44;   // Air temperature/humidity (SHT40/41/45)
+constexpr uint8_t  kTmp117I2cAddress   = 0x48;   // Soil temperature probe (TMP117, ADD0 to GND)
+constexpr uint8_t  kSht4xConversionMs  = 5;      // Medium repeatability, 4.5 ms max
+constexpr uint8_t  kTmp117ConversionMs = 16;     // One-shot without averaging, 15.5 ms
+constexpr uint32_t kClimateTimeoutMs   = 50;     // Longest wait for the sensors - boot probe or a wake's conversions
 
 // --- Timing Configuration ---
 constexpr uint32_t kSerialBaudRate   = 115200;
@@ -38,14 +63,79 @@ namespace {
 }
 
 // --- EEPROM Configuration ---
-constexpr uint16_t kEepromCalibrationAddress = 0;    // Start address for calibration data
+constexpr uint16_t kEepromCalibrationAddress = 0;    // Start of the calibration journal region
 constexpr uint16_t kEepromMagicNumber        = 0xCAFE; // Magic number to validate EEPROM data
-constexpr uint8_t  kEepromVersion           = 1;      // Version for future compatibility
+constexpr uint8_t  kEepromVersion           = 3;      // 3 = per-probe CRC-32 journal; 1 = single XOR record, migrated on boot
+constexpr uint16_t kCalibJournalPageSize    = 128;    // Erase unit assumed for wear accounting
+constexpr uint8_t  kCalibJournalPages       = 4;      // Journal spans 512 bytes
+constexpr uint32_t kCalibSaveDelayMs        = 5000;   // Edits within this window share one write
+constexpr uint16_t kConfigStoreAddress      = kEepromCalibrationAddress + kCalibJournalPageSize * kCalibJournalPages;
+constexpr uint16_t kConfigStoreMagic        = 0xC0F6; // Marks an initialised key-value store
+constexpr uint8_t  kConfigSchemaVersion     = 1;      // Bump when a key changes meaning or type
+constexpr uint32_t kConfigSaveDelayMs       = 5000;   // Coalesce remote tuning bursts into one write
+constexpr uint16_t kConfigStoreSize         = 256;    // Reserved for the key-value store - header + 31 keys
+constexpr uint16_t kAutoCalAddress          = kConfigStoreAddress + kConfigStoreSize;
 
 // --- Calibration Defaults ---
 constexpr int kDefaultMoistureDry     = 1023;   // Default ADC value for dry soil
 constexpr int kDefaultMoistureWet     = 300;    // Default ADC value for wet soil
 constexpr float kDefaultBatteryDivider = 5.0;   // Default voltage divider ratio
+constexpr uint8_t kDefaultThresholdLow  = 20;   // Moisture alert thresholds (%)
+constexpr uint8_t kDefaultThresholdHigh = 80;
+constexpr uint16_t kDefaultMeasurementInterval = 60; // Seconds
+constexpr uint8_t kMoistureBandHysteresis = 2;    // % past a band edge before the band changes
+constexpr uint8_t kMoistureBandDwellSamples = 2;  // Readings a new band must hold before it is reported
+
+// --- Time-to-Dry Forecast ---
+constexpr uint32_t kDryForecastSampleMs     = 900000; // One regression point per 15 minutes
+constexpr float    kDryForecastDecay        = 0.97;   // Per-point weight decay (~8 h memory)
+constexpr uint8_t  kDryForecastMinSamples   = 8;      // Points before a forecast is published
+constexpr float    kDryForecastWetJump      = 5.0;    // % rise that marks watering - restarts the fit
+constexpr uint16_t kDryForecastLeadMinutes  = 720;    // Default event lead - once the forecast drops under 12 h
+constexpr uint16_t kDryForecastMaxLeadMinutes = 10080; // Longest settable lead (7 days)
+
+// --- Sensor Fault Detection ---
+constexpr uint8_t  kMoistureBurstSamples    = 4;      // ADC reads per measurement - spread is the noise signature
+constexpr uint16_t kFaultRailMargin         = 3;      // Counts from either ADC rail that read as stuck
+constexpr uint8_t  kFaultConfirmSamples     = 3;      // Consecutive bad readings before a fault is raised
+constexpr uint8_t  kFaultClearSamples       = 3;      // Consecutive good readings before it clears
+constexpr uint16_t kFaultFlatSamples        = 120;    // Identical readings before flat-line (~50 min at 25 s)
+constexpr uint16_t kFaultMaxDryingStep      = 250;    // Soil cannot dry this many counts between readings
+constexpr uint16_t kFaultStepHoldSamples    = 40;     // Accept the new level after this long (~17 min)
+constexpr uint16_t kFaultNoiseSpread        = 40;     // Burst spread of a floating input
+
+// --- Moisture Temperature Compensation (serial "tempcomp") ---
+// Capacitive probes read drier as they warm. The correction is applied to
+// the raw reading before calibration, bands and thresholds; the reference
+// is the temperature the probe was calibrated at.
+constexpr uint8_t  kTempCompDefaultMode     = 2;      // With a soil probe: 0 = off, 1 = configured coefficients, 2 = learn (Off without one)
+constexpr int16_t  kTempCompReferenceCentiC = 2500;   // Compensated readings are what the probe reads at 25 degC
+constexpr int16_t  kTempCompCoeffQ8[kMaxMoistureProbes] = {0, 0, 0, 0};  // Configured counts/degC x256, per probe
+constexpr int16_t  kTempCompMaxCoeffQ8      = 2560;   // +/-10 counts/degC - beyond is a fit gone wrong
+constexpr uint32_t kTempCompLearnIntervalMs = 900000; // One fit point per 15 minutes
+constexpr uint8_t  kTempCompLearnDecayShift = 8;      // Fit weights decay by 1/256 per point (~2.7 days)
+constexpr uint8_t  kTempCompMaxStep         = 24;     // Counts - bigger moves are watering, not temperature
+constexpr uint16_t kTempCompMinPairs        = 16;     // Fit points before a learned coefficient is used
+constexpr uint32_t kTempCompMinFitMs        = 86400000; // ...spanning at least one day-night cycle
+constexpr uint32_t kTempCompMinSwing        = 20000;  // Summed squared temperature steps (centi-degC^2) - needs real swings
+constexpr int16_t  kTempCompSaveStepQ8      = 26;     // Persist a trusted fit once it moves 0.1 counts/degC from the stored one
+
+// --- Raw ADC Capture (bench characterisation, serial "capture") ---
+constexpr uint16_t kRawCaptureMaxSamples    = 4096;   // Static buffer - 8 KB of RAM
+constexpr uint16_t kRawCaptureDefaultCount  = 2048;   // Samples when the command gives none
+constexpr uint32_t kRawCaptureDefaultRateHz = 1000;   // Rate when the command gives none
+constexpr uint32_t kRawCaptureMaxRateHz     = 20000;  // Highest rate the command accepts; the ADC may not keep up
+
+// --- Auto-Calibration ---
+constexpr float    kAutoCalWetQuantile      = 0.05;   // Low tail of raw readings = wettest soil seen
+constexpr float    kAutoCalDryQuantile      = 0.95;   // High tail = driest soil seen
+constexpr uint32_t kAutoCalFullConfidenceSamples = 10000; // ~3 days at 25 s
+constexpr uint16_t kAutoCalMinSpan          = 200;    // Wet-to-dry ADC span needed for full confidence
+constexpr uint32_t kAutoCalWindowSamples    = 24192;  // Halve sample weight after ~1 week at 25 s
+constexpr uint16_t kAutoCalCheckpointSamples = 512;   // NVM checkpoint cadence (~3.5 h at 25 s)
+constexpr uint8_t  kAutoCalApplyConfidence  = 80;     // % confidence before Apply mode writes calibration
+constexpr uint16_t kAutoCalDeadband         = 16;     // ADC counts - smaller moves are not applied
+constexpr uint8_t  kAutoCalDefaultMode      = 1;      // 0 = off, 1 = propose, 2 = apply
 
 // --- Power Management Configuration ---
 constexpr bool kEnablePowerManagement = true;   // Enable state machine power management
@@ -67,3 +157,42 @@ constexpr uint32_t kMaxSleepInterval    = 900000; // 15min - Maximum sleep time
 constexpr uint32_t kMinSleepInterval    = 5000;   // 5s - Minimum sleep time limit
 constexpr bool kAllowRemoteWakeup       = true;   // Allow Matter commands to wake device
 constexpr bool kUsbOverridePowerManagement = true; // Disable deep sleep when USB connected
+constexpr float    kPowerStateHysteresisV   = 0.05;   // Extra volts needed to step back up a state
+constexpr uint8_t  kPowerStateDwellSamples  = 3;      // Consecutive readings before a state change
+
+// Intermittently Connected Device (Thread SED) - derived from the sleep interval
+constexpr uint32_t kIcdFastPollMs           = 200;    // Poll period while in active mode
+constexpr uint32_t kIcdActiveModeMs         = 1000;   // Radio stays responsive this long after a wake
+constexpr uint32_t kIcdActiveThresholdMs    = 5000;   // Extra active time after any exchange
+constexpr uint32_t kIcdMaxSlowPollMs        = 900000; // Parent must still hear from us within this
+constexpr uint32_t kIcdMinCheckInS          = 3600;   // Check-in at least once an hour
+constexpr uint32_t kIcdLegacyPollMs         = 5000;   // Free-running SED poll before coordination
+
+// Wake-on-threshold - analog comparators watch probe 0 between wakes (serial "wake")
+constexpr bool     kThresholdWakeDefault     = false;   // Boot in threshold mode instead of periodic sampling
+constexpr uint32_t kThresholdWakeHeartbeatMs = 3600000; // Armed: still measure hourly (battery, faults, sub-bands)
+constexpr uint8_t  kThresholdWakeLevels      = 64;      // Comparator reference steps across the supply (ACMP VREFDIV)
+
+// Report uplink - queue and exponential backoff while the hub is unreachable
+constexpr uint8_t  kReportQueueDepth        = 16;     // Readings held while offline (thinned when full)
+constexpr uint8_t  kReportBatchMax          = 4;      // Queued readings sent per successful wake
+constexpr uint32_t kReportBackoffBaseMs     = 30000;  // First retry delay after a failure
+constexpr uint32_t kReportBackoffMaxMs      = 900000; // Retry at least every 15 min
+constexpr uint8_t  kReportJitterPercent     = 25;     // +/- spread on each backoff delay
+constexpr uint8_t  kReportOfflineFailures   = 3;      // Consecutive failures before the link is offline
+
+// Report phase - spreads a fleet that boots together across the interval
+constexpr uint32_t kReportBootSpreadMs      = 10000;  // First reading after boot lands within this window
+constexpr uint8_t  kReportPhaseJitterPercent = 5;     // +/- random spread around each phase slot
+
+// Energy Budget - solves the Normal/Extended interval for a target lifetime
+constexpr bool     kEnergyBudgetEnabled     = true;
+constexpr uint16_t kTargetLifetimeDays      = 365;    // Battery should last this long from boot
+constexpr uint16_t kBatteryCapacityMah      = 2400;   // Usable capacity of a full pack
+constexpr uint32_t kActiveCurrentUa         = 9000;   // Average draw while awake with the radio off
+constexpr uint32_t kRadioTxCurrentUa        = 19000;  // Draw while a report is on air (+10 dBm TX, ack RX)
+constexpr uint32_t kReportRadioMs           = 40;     // Radio time charged per delivered report - estimate, the stack does not expose TX time
+constexpr uint32_t kIcdPollChargeUc         = 40;     // One SED data poll - wake, TX, RX window
+constexpr uint32_t kSleepCurrentUa          = 20;     // EM2 draw between polls
+constexpr float    kWakeCostSmoothing       = 0.2;    // EWMA weight of the newest wake measurement
+constexpr uint16_t kMinRemainingDays        = 7;      // Floor once the target date has passed
@@ -0,0 +1,250 @@
+#include "ConfigStore.h"
+#include <string.h>
+
+#ifdef ARDUINO
+#include <EEPROM.h>
+#else
+// Host stand-in for the NVM region - starts erased
+static uint8_t hostNvm[kConfigStoreAddress + kConfigStoreSize];
+static bool hostNvmErased = false;
+#endif
+
+static_assert(4 + 8 * kConfigKeyCount <= kConfigStoreSize, "config store outgrew its NVM region");
+
+struct ConfigDefault {
+  ConfigType type;
+  uint32_t u32;
+  float f32;
+};
+
+// Indexed by ConfigKey
+static const ConfigDefault CONFIG_DEFAULTS[kConfigKeyCount] PROGMEM = {
+  { ConfigType::U32, kNormalSleepInterval, 0 },
+  { ConfigType::U32, kExtendedSleepInterval, 0 },
+  { ConfigType::U32, kLowPowerSleepInterval, 0 },
+  { ConfigType::U32, kUsbSleepInterval, 0 },
+  { ConfigType::U32, kMaxSleepInterval, 0 },
+  { ConfigType::U32, kMinSleepInterval, 0 },
+  { ConfigType::F32, 0, kBatteryNormalThresh },
+  { ConfigType::F32, 0, kBatteryExtendedThresh },
+  { ConfigType::F32, 0, kBatteryCriticalThresh },
+  { ConfigType::F32, 0, kBatteryShutdownThresh },
+  { ConfigType::U32, (kAllowRemoteWakeup ? CONFIG_FLAG_ALLOW_REMOTE_WAKEUP : 0) |
+                     (kUsbOverridePowerManagement ? CONFIG_FLAG_USB_OVERRIDE : 0) |
+                     (kEnablePowerManagement ? CONFIG_FLAG_POWER_MANAGEMENT : 0), 0 },
+  { ConfigType::U32, kDefaultThresholdLow, 0 },
+  { ConfigType::U32, kDefaultThresholdHigh, 0 },
+  { ConfigType::U32, kDefaultMeasurementInterval, 0 },
+  { ConfigType::U32, kAutoCalDefaultMode, 0 },
+  { ConfigType::U32, kDryForecastLeadMinutes, 0 },
+  { ConfigType::U32, CONFIG_TEMPCOMP_MODE_AUTO, 0 },
+  { ConfigType::U32, (uint16_t)kTempCompCoeffQ8[0] | ((uint32_t)(uint16_t)kTempCompCoeffQ8[1] << 16), 0 },
+  { ConfigType::U32, (uint16_t)kTempCompCoeffQ8[2] | ((uint32_t)(uint16_t)kTempCompCoeffQ8[3] << 16), 0 },
+  { ConfigType::U32, 0x80008000, 0 },
+  { ConfigType::U32, 0x80008000, 0 },
+};
+
+static void readNvm(uint16_t address, void* data, size_t length) {
+#ifdef ARDUINO
+  uint8_t* bytes = static_cast<uint8_t*>(data);
+  for (size_t i = 0; i < length; i++) {
+    bytes[i] = EEPROM.read(address + i);
+  }
+#else
+  if (!hostNvmErased) {
+    memset(hostNvm, 0xFF, sizeof(hostNvm));
+    hostNvmErased = true;
+  }
+  memcpy(data, &hostNvm[address], length);
+#endif
+}
+
+static void writeNvm(uint16_t address, const void* data, size_t length) {
+#ifdef ARDUINO
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < length; i++) {
+    EEPROM.update(address + i, bytes[i]);  // Unchanged bytes cost no wear
+  }
+#else
+  memcpy(&hostNvm[address], data, length);
+#endif
+}
+
+void ConfigStore::begin() {
+  Header header;
+  readNvm(kConfigStoreAddress, &header, sizeof(header));
+
+  storedMask = 0;
+  dirtyMask = 0;
+  bool known = header.magicNumber == kConfigStoreMagic;
+  uint8_t storedKeys = known ? min(header.keyCount, kConfigKeyCount) : 0;
+
+  for (uint8_t i = 0; i < kConfigKeyCount; i++) {
+    Record record;
+    if (i < storedKeys) {
+      readNvm(recordAddress(i), &record, sizeof(record));
+    }
+    if (i < storedKeys && record.key == i && record.type == static_cast<uint8_t>(typeOf(i)) &&
+        record.crc == recordCrc(record)) {
+      values[i] = record.value;
+      storedMask |= (1ul << i);
+    } else {
+      values[i] = defaultValue(i);
+      dirtyMask |= (1ul << i);  // Write the default so the next boot finds it
+    }
+  }
+
+  headerDirty = !known || header.schemaVersion != kConfigSchemaVersion ||
+                header.keyCount != kConfigKeyCount;
+  if (known && header.schemaVersion < kConfigSchemaVersion) {
+    migrate(header.schemaVersion);
+  }
+
+  #ifdef DEBUG_SERIAL
+  Serial.print(F("[Config] Loaded "));
+  Serial.print(__builtin_popcount(storedMask));
+  Serial.print(F("/"));
+  Serial.print(kConfigKeyCount);
+  Serial.println(F(" stored keys"));
+  #endif
+
+  // Repairs and first-boot defaults go out straight away
+  if (dirtyMask || headerDirty) {
+    commit();
+  }
+}
+
+// Schema history - add a case when a key changes meaning, unit or type and
+// let it fall through to the next. Keys added since fromVersion need no
+// case: they were defaulted in begin().
+void ConfigStore::migrate(uint8_t fromVersion) {
+  switch (fromVersion) {
+    default:
+      break;
+  }
+}
+
+uint32_t ConfigStore::getU32(ConfigKey key) const {
+  uint8_t index = static_cast<uint8_t>(key);
+  return typeOf(index) == ConfigType::U32 ? values[index] : 0;
+}
+
+float ConfigStore::getFloat(ConfigKey key) const {
+  uint8_t index = static_cast<uint8_t>(key);
+  float value = 0;
+  if (typeOf(index) == ConfigType::F32) {
+    memcpy(&value, &values[index], sizeof(value));
+  }
+  return value;
+}
+
+void ConfigStore::setU32(ConfigKey key, uint32_t value) {
+  set(key, ConfigType::U32, value);
+}
+
+void ConfigStore::setFloat(ConfigKey key, float value) {
+  uint32_t raw;
+  memcpy(&raw, &value, sizeof(raw));
+  set(key, ConfigType::F32, raw);
+}
+
+void ConfigStore::set(ConfigKey key, ConfigType type, uint32_t raw) {
+  uint8_t index = static_cast<uint8_t>(key);
+  if (index >= kConfigKeyCount || typeOf(index) != type) {
+    #ifdef DEBUG_SERIAL
+    Serial.print(F("[Config] Type mismatch for key "));
+    Serial.println(index);
+    #endif
+    return;
+  }
+  if (values[index] == raw) {
+    return;  // No change - no write
+  }
+  values[index] = raw;
+  dirtyMask |= keyBit(key);
+  lastEditMs = millis();
+}
+
+void ConfigStore::resetToDefaults() {
+  for (uint8_t i = 0; i < kConfigKeyCount; i++) {
+    if (values[i] != defaultValue(i)) {
+      values[i] = defaultValue(i);
+      dirtyMask |= (1ul << i);
+    }
+  }
+  lastEditMs = millis();
+}
+
+void ConfigStore::service(uint32_t now, PowerState state) {
+  if (dirtyMask && now - lastEditMs >= kConfigSaveDelayMs) {
+    flush(state);
+  }
+}
+
+bool ConfigStore::flush(PowerState state) {
+  if (!dirtyMask && !headerDirty) {
+    return true;
+  }
+  if (state == PowerState::Critical) {
+    return false;  // Keep NVM writes away from brown-out
+  }
+  commit();
+  return true;
+}
+
+void ConfigStore::commit() {
+  // Records first, header last: an interrupted upgrade re-runs on next boot
+  for (uint8_t i = 0; i < kConfigKeyCount; i++) {
+    if (!(dirtyMask & (1ul << i))) {
+      continue;
+    }
+    Record record;
+    record.key = i;
+    record.type = static_cast<uint8_t>(typeOf(i));
+    record.value = values[i];
+    record.crc = recordCrc(record);
+    writeNvm(recordAddress(i), &record, sizeof(record));
+    storedMask |= (1ul << i);
+  }
+  dirtyMask = 0;
+
+  if (headerDirty) {
+    Header header = { kConfigStoreMagic, kConfigSchemaVersion, kConfigKeyCount };
+    writeNvm(kConfigStoreAddress, &header, sizeof(header));
+    headerDirty = false;
+  }
+}
+
+ConfigType ConfigStore::typeOf(uint8_t index) {
+  return static_cast<ConfigType>(pgm_read_byte(&CONFIG_DEFAULTS[index].type));
+}
+
+uint32_t ConfigStore::defaultValue(uint8_t index) {
+  ConfigDefault entry;
+  memcpy_P(&entry, &CONFIG_DEFAULTS[index], sizeof(entry));
+  if (entry.type == ConfigType::F32) {
+    uint32_t raw;
+    memcpy(&raw, &entry.f32, sizeof(raw));
+    return raw;
+  }
+  return entry.u32;
+}
+
+uint16_t ConfigStore::recordCrc(const Record& record) {
+  // CRC-16/CCITT-FALSE over everything except the crc field
+  uint8_t bytes[6] = { record.key, record.type };
+  memcpy(&bytes[2], &record.value, sizeof(record.value));
+
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 0; i < sizeof(bytes); i++) {
+    crc ^= (uint16_t)bytes[i] << 8;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+uint16_t ConfigStore::recordAddress(uint8_t index) {
+  return kConfigStoreAddress + sizeof(Header) + index * sizeof(Record);
+}
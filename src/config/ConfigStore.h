@@ -0,0 +1,97 @@
+#pragma once
+#include "Config.h"
+#include "../hardware/PowerManager.h"
+
+// Persistent tunables. Keys are append-only: a new key goes at the end
+// (before Count) and older stores load its default. Changing the meaning,
+// unit or type of an existing key needs a kConfigSchemaVersion bump and a
+// case in ConfigStore::migrate().
+enum class ConfigKey : uint8_t {
+  NormalSleepInterval,      // ms
+  ExtendedSleepInterval,    // ms
+  LowPowerSleepInterval,    // ms
+  UsbSleepInterval,         // ms
+  MaxSleepInterval,         // ms
+  MinSleepInterval,         // ms
+  BatteryNormalThresh,      // V
+  BatteryExtendedThresh,    // V
+  BatteryCriticalThresh,    // V
+  BatteryShutdownThresh,    // V
+  PowerFlags,               // CONFIG_FLAG_* bits
+  MoistureThresholdLow,     // %
+  MoistureThresholdHigh,    // %
+  MeasurementInterval,      // s
+  AutoCalibrationMode,      // AutoCalMode
+  DryForecastLeadMinutes,   // min
+  TempCompMode,             // TempCompMode or CONFIG_TEMPCOMP_MODE_AUTO
+  TempCompConfigured01,     // Q8 counts/degC, probe 0 low half, probe 1 high half
+  TempCompConfigured23,     // Q8 counts/degC, probes 2 and 3
+  TempCompLearned01,        // Q8 counts/degC, INT16_MIN = nothing learned
+  TempCompLearned23,        // Q8 counts/degC, probes 2 and 3
+  Count
+};
+
+enum class ConfigType : uint8_t { U32 = 1, F32 = 2 };
+
+// PowerFlags bits
+constexpr uint32_t CONFIG_FLAG_ALLOW_REMOTE_WAKEUP = 0x01;
+constexpr uint32_t CONFIG_FLAG_USB_OVERRIDE        = 0x02;
+constexpr uint32_t CONFIG_FLAG_POWER_MANAGEMENT    = 0x04;
+
+// TempCompMode value until one is set: kTempCompDefaultMode with a soil probe, off without
+constexpr uint32_t CONFIG_TEMPCOMP_MODE_AUTO       = 0xFF;
+
+constexpr uint8_t kConfigKeyCount = static_cast<uint8_t>(ConfigKey::Count);
+
+// Typed key-value store backed by NVM. Every key owns a fixed 8-byte record
+// with its own CRC-16, so a key loads and saves in O(1) and a bad record
+// only costs that key its stored value. Values are mirrored in RAM; writes
+// are coalesced and deferred the same way as calibration writes.
+class ConfigStore {
+public:
+  void begin();  // Load every key, migrating older schemas
+
+  uint32_t getU32(ConfigKey key) const;
+  float getFloat(ConfigKey key) const;
+  void setU32(ConfigKey key, uint32_t value);
+  void setFloat(ConfigKey key, float value);
+  bool isStored(ConfigKey key) const { return storedMask & keyBit(key); }
+
+  void resetToDefaults();  // All keys back to Config.h values (persisted)
+
+  void service(uint32_t now, PowerState state);
+  bool flush(PowerState state);  // Commit now (before sleep); false if deferred
+  bool hasPendingSave() const { return dirtyMask != 0; }
+
+private:
+  struct Header {
+    uint16_t magicNumber;
+    uint8_t schemaVersion;
+    uint8_t keyCount;       // Keys present when the store was written
+  };
+
+  struct Record {
+    uint8_t key;
+    uint8_t type;
+    uint16_t crc;           // CRC-16/CCITT over key, type and value
+    uint32_t value;         // Raw bits - floats are stored bit-for-bit
+  };
+
+  uint32_t values[kConfigKeyCount];
+  uint32_t dirtyMask = 0;   // Keys waiting to be written
+  uint32_t storedMask = 0;  // Keys loaded from NVM rather than defaulted
+  bool headerDirty = false;
+  uint32_t lastEditMs = 0;
+
+  static_assert(kConfigKeyCount <= 32, "dirty/stored masks hold 32 keys");
+
+  static uint32_t keyBit(ConfigKey key) { return 1ul << static_cast<uint8_t>(key); }
+  static ConfigType typeOf(uint8_t index);
+  static uint32_t defaultValue(uint8_t index);
+  static uint16_t recordCrc(const Record& record);
+  static uint16_t recordAddress(uint8_t index);
+
+  void set(ConfigKey key, ConfigType type, uint32_t raw);
+  void migrate(uint8_t fromVersion);
+  void commit();
+};
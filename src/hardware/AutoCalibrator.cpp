@@ -0,0 +1,229 @@
+#include "AutoCalibrator.h"
+#include "CalibrationJournal.h"
+#include "CalibrationManager.h"
+#include "../config/ConfigStore.h"
+#include <stddef.h>
+#include <string.h>
+
+// Retained RAM: the MG24 backup RAM keeps 32 words through EM4
+#if defined(ARDUINO_ARCH_SILABS) && __has_include(<em_device.h>)
+#include <em_device.h>
+#endif
+#if defined(BURAM)
+#define AUTOCAL_RETAINED_HW 1
+#else
+#define AUTOCAL_RETAINED_HW 0
+#endif
+
+#ifdef ARDUINO
+#include <EEPROM.h>
+#endif
+
+namespace {
+  constexpr uint8_t kRetainedFirstWord = 0;  // BURAM words 0..15 belong to auto-calibration, 16..23 to EnergyBudget
+  constexpr uint8_t kRetainedWords = 16;
+  constexpr uint8_t kCheckpointSlots = 2;    // Ping-pong - a torn write keeps the other copy
+}
+
+#if !AUTOCAL_RETAINED_HW
+// Host / other targets: plain RAM stands in for retained memory
+static uint32_t retainedWords[kRetainedWords];
+#endif
+#ifndef ARDUINO
+static uint8_t hostNvm[kAutoCalAddress + kCheckpointSlots * kRetainedWords * 4];
+static bool hostNvmErased = false;
+#endif
+
+void AutoCalibrator::begin(CalibrationManager* calibration, ConfigStore* store) {
+  calibrationManager = calibration;
+  configStore = store;
+  mode = store ? static_cast<AutoCalMode>(store->getU32(ConfigKey::AutoCalibrationMode))
+               : static_cast<AutoCalMode>(kAutoCalDefaultMode);
+
+  // Prefer whichever copy has seen more samples - retained RAM is newer
+  // after sleep, the NVM checkpoint is all that is left after power loss
+  Snapshot retained, stored;
+  bool haveRetained = readRetained(retained);
+  bool haveStored = readCheckpoint(stored);
+  if (haveStored) {
+    checkpointSequence = stored.sequence;
+  }
+  if (haveRetained && (!haveStored || retained.dry.count >= stored.dry.count)) {
+    restoreSnapshot(retained);
+  } else if (haveStored) {
+    restoreSnapshot(stored);
+  }
+
+  #ifdef DEBUG_SERIAL
+  Serial.print(F("[AutoCal] Restored "));
+  Serial.print(getSampleCount());
+  Serial.print(F(" samples, confidence "));
+  Serial.print(getConfidence());
+  Serial.println(F("%"));
+  #endif
+}
+
+void AutoCalibrator::addSample(uint16_t raw) {
+  if (mode == AutoCalMode::Off) {
+    return;
+  }
+
+  wet.add(raw);
+  dry.add(raw);
+  if (dry.getCount() >= kAutoCalWindowSamples) {
+    wet.decay();
+    dry.decay();
+  }
+
+  Snapshot snapshot;
+  takeSnapshot(snapshot);
+  writeRetained(snapshot);
+
+  if (++samplesSinceCheckpoint >= kAutoCalCheckpointSamples) {
+    checkpoint();
+    applyProposal();
+  }
+}
+
+void AutoCalibrator::reset() {
+  wet.reset();
+  dry.reset();
+  samplesSinceCheckpoint = 0;
+  Snapshot snapshot;
+  takeSnapshot(snapshot);
+  writeRetained(snapshot);
+  checkpoint();
+}
+
+void AutoCalibrator::setMode(AutoCalMode newMode) {
+  mode = newMode;
+  if (configStore) {
+    configStore->setU32(ConfigKey::AutoCalibrationMode, static_cast<uint32_t>(newMode));
+  }
+}
+
+uint8_t AutoCalibrator::getConfidence() const {
+  int dryValue, wetValue;
+  if (!getProposal(dryValue, wetValue) || dryValue <= wetValue) {
+    return 0;
+  }
+  float samples = min(1.0f, (float)dry.getCount() / kAutoCalFullConfidenceSamples);
+  float span = min(1.0f, (float)(dryValue - wetValue) / kAutoCalMinSpan);
+  return (uint8_t)(samples * span * 100.0f);
+}
+
+bool AutoCalibrator::getProposal(int& dryValue, int& wetValue) const {
+  if (dry.getCount() < 5) {
+    return false;
+  }
+  dryValue = (int)(dry.value() + 0.5f);
+  wetValue = (int)(wet.value() + 0.5f);
+  return true;
+}
+
+void AutoCalibrator::applyProposal() {
+  if (mode != AutoCalMode::Apply || !calibrationManager ||
+      calibrationManager->isCalibrating() || getConfidence() < kAutoCalApplyConfidence) {
+    return;
+  }
+
+  int dryValue, wetValue, currentDry, currentWet;
+  if (!getProposal(dryValue, wetValue)) {
+    return;
+  }
+  calibrationManager->getMoistureCalibration(currentDry, currentWet);
+  if (abs(dryValue - currentDry) <= kAutoCalDeadband && abs(wetValue - currentWet) <= kAutoCalDeadband) {
+    return;  // Not worth a journal write
+  }
+
+  #ifdef DEBUG_SERIAL
+  Serial.print(F("[AutoCal] Applying dry="));
+  Serial.print(dryValue);
+  Serial.print(F(" wet="));
+  Serial.println(wetValue);
+  #endif
+  calibrationManager->setMoistureCalibration(dryValue, wetValue);
+  calibrationManager->saveCalibration();
+}
+
+void AutoCalibrator::takeSnapshot(Snapshot& snapshot) const {
+  static_assert(sizeof(Snapshot) <= kRetainedWords * sizeof(uint32_t), "snapshot outgrew retained RAM");
+  memset(&snapshot, 0, sizeof(snapshot));  // Deterministic padding for the CRC
+  snapshot.sequence = checkpointSequence;
+  wet.save(snapshot.wet);
+  dry.save(snapshot.dry);
+  snapshot.crc = CalibrationJournal::crc32(reinterpret_cast<const uint8_t*>(&snapshot),
+                                           offsetof(Snapshot, crc));
+}
+
+void AutoCalibrator::restoreSnapshot(const Snapshot& snapshot) {
+  wet.restore(snapshot.wet);
+  dry.restore(snapshot.dry);
+}
+
+void AutoCalibrator::checkpoint() {
+  samplesSinceCheckpoint = 0;
+  checkpointSequence++;
+  Snapshot snapshot;
+  takeSnapshot(snapshot);
+  writeCheckpoint(snapshot);
+}
+
+bool AutoCalibrator::isValid(const Snapshot& snapshot) {
+  return snapshot.crc == CalibrationJournal::crc32(reinterpret_cast<const uint8_t*>(&snapshot),
+                                                   offsetof(Snapshot, crc));
+}
+
+bool AutoCalibrator::readRetained(Snapshot& snapshot) {
+  uint32_t* words = reinterpret_cast<uint32_t*>(&snapshot);
+  for (uint8_t i = 0; i < sizeof(Snapshot) / sizeof(uint32_t); i++) {
+#if AUTOCAL_RETAINED_HW
+    words[i] = BURAM->RET[kRetainedFirstWord + i].REG;
+#else
+    words[i] = retainedWords[kRetainedFirstWord + i];
+#endif
+  }
+  return isValid(snapshot);
+}
+
+void AutoCalibrator::writeRetained(const Snapshot& snapshot) {
+  const uint32_t* words = reinterpret_cast<const uint32_t*>(&snapshot);
+  for (uint8_t i = 0; i < sizeof(Snapshot) / sizeof(uint32_t); i++) {
+#if AUTOCAL_RETAINED_HW
+    BURAM->RET[kRetainedFirstWord + i].REG = words[i];
+#else
+    retainedWords[kRetainedFirstWord + i] = words[i];
+#endif
+  }
+}
+
+bool AutoCalibrator::readCheckpoint(Snapshot& snapshot) {
+  bool found = false;
+  for (uint8_t slot = 0; slot < kCheckpointSlots; slot++) {
+    Snapshot candidate;
+    uint16_t address = kAutoCalAddress + slot * sizeof(Snapshot);
+#ifdef ARDUINO
+    EEPROM.get(address, candidate);
+#else
+    if (!hostNvmErased) {
+      memset(hostNvm, 0xFF, sizeof(hostNvm));
+      hostNvmErased = true;
+    }
+    memcpy(&candidate, &hostNvm[address], sizeof(candidate));
+#endif
+    if (isValid(candidate) && (!found || (int32_t)(candidate.sequence - snapshot.sequence) > 0)) {
+      snapshot = candidate;
+      found = true;
+    }
+  }
+  return found;
+}
+
+void AutoCalibrator::writeCheckpoint(const Snapshot& snapshot) {
+  uint16_t address = kAutoCalAddress + (snapshot.sequence % kCheckpointSlots) * sizeof(Snapshot);
+#ifdef ARDUINO
+  EEPROM.put(address, snapshot);
+#else
+  memcpy(&hostNvm[address], &snapshot, sizeof(snapshot));
+#endif
+}
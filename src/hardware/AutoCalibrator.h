@@ -0,0 +1,65 @@
+#pragma once
+#include "../config/Config.h"
+#include "P2Quantile.h"
+
+class CalibrationManager;
+class ConfigStore;
+
+enum class AutoCalMode : uint8_t {
+  Off = 0,
+  Propose = 1,  // Track and report, never touch calibration
+  Apply = 2     // Write the proposal once confidence allows
+};
+
+// Self-learning dry/wet calibration. Over weeks a probe sees both freshly
+// watered and dried-out soil, so the low and high tails of the raw ADC
+// distribution converge on the wet and dry references. Two P² estimators
+// track those tails in constant memory.
+//
+// Estimator state is copied to retained RAM after every sample (BURAM on
+// the MG24, kept through EM4 sleep) and checkpointed to NVM every
+// kAutoCalCheckpointSamples, so it survives both sleep and power loss.
+class AutoCalibrator {
+public:
+  void begin(CalibrationManager* calibration, ConfigStore* store);
+
+  void addSample(uint16_t raw);
+  void reset();
+
+  AutoCalMode getMode() const { return mode; }
+  void setMode(AutoCalMode newMode);
+
+  // 0-100 - grows with samples seen and with the wet/dry span
+  uint8_t getConfidence() const;
+  // Current estimate; false until at least the warm-up samples are in
+  bool getProposal(int& dryValue, int& wetValue) const;
+  uint32_t getSampleCount() const { return dry.getCount(); }
+
+private:
+  struct Snapshot {
+    uint32_t sequence;        // Checkpoint counter - newest NVM copy wins
+    P2QuantileState wet;
+    P2QuantileState dry;
+    uint32_t crc;             // CRC-32 over everything above
+  };
+
+  P2Quantile wet{kAutoCalWetQuantile};
+  P2Quantile dry{kAutoCalDryQuantile};
+  CalibrationManager* calibrationManager = nullptr;
+  ConfigStore* configStore = nullptr;
+  AutoCalMode mode = AutoCalMode::Off;
+  uint32_t checkpointSequence = 0;
+  uint16_t samplesSinceCheckpoint = 0;
+
+  void takeSnapshot(Snapshot& snapshot) const;
+  void restoreSnapshot(const Snapshot& snapshot);
+  void checkpoint();
+  void applyProposal();
+
+  // Storage backends
+  static bool readRetained(Snapshot& snapshot);
+  static void writeRetained(const Snapshot& snapshot);
+  static bool readCheckpoint(Snapshot& snapshot);
+  static void writeCheckpoint(const Snapshot& snapshot);
+  static bool isValid(const Snapshot& snapshot);
+};
@@ -16,10 +16,12 @@ float BatteryMonitor::readVoltage() {
   float voltage = (raw / kAdcReference) * voltageDivider;
   
   // Enhanced battery detection logic
-  // Check multiple readings for stability
-  static float lastReadings[3] = {0, 0, 0};
-  static int readingIndex = 0;
-  
+  // Check multiple readings for stability; the first reading fills the
+  // window so the average never contains the zeros it starts with
+  if (!windowFilled) {
+    lastReadings[0] = lastReadings[1] = lastReadings[2] = voltage;
+    windowFilled = true;
+  }
   lastReadings[readingIndex] = voltage;
   readingIndex = (readingIndex + 1) % 3;
   
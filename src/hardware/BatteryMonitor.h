@@ -1,6 +1,7 @@
 #pragma once
 #include "../config/Config.h"
 #include "CalibrationManager.h"
+#include "StateOfCharge.h"
 
 enum class BatteryStatus {
   Normal,
@@ -31,6 +32,17 @@ public:
   const char* getBatteryStatusString() const;
   const char* getBatteryStateString() const;
   
+  // State of charge - feed one reading per measurement cycle; everything
+  // else reads the cached estimate
+  uint8_t updateStateOfCharge(float voltage, uint32_t loadUa = kBatterySampleLoadUa) {
+    return stateOfCharge.update(voltage, loadUa);
+  }
+  uint8_t getStateOfCharge() const { return stateOfCharge.getPercent(); }
+  float getRestingVoltage() const { return stateOfCharge.getRestingVoltage(); }
+  bool hasStateOfCharge() const { return stateOfCharge.hasEstimate(); }
+  void setChemistry(BatteryChemistry chemistry, uint8_t cells) { stateOfCharge.setChemistry(chemistry, cells); }
+  BatteryChemistry getChemistry() const { return stateOfCharge.getChemistry(); }
+  
   // Calibration methods
   void setVoltageDivider(float ratio);
   float getVoltageDivider() const;
@@ -43,4 +55,8 @@ private:
   CalibrationManager* calibrationManager = nullptr;
   float lowThreshold = kBatteryLowThresh;
   float lastVoltage = 0.0;
+  float lastReadings[3] = {0, 0, 0};  // Presence detection window
+  uint8_t readingIndex = 0;
+  bool windowFilled = false;          // Set by the first reading
+  StateOfChargeEstimator stateOfCharge;
 };
@@ -0,0 +1,109 @@
+#include "CalibrationJournal.h"
+#include <stddef.h>
+
+#ifdef ARDUINO
+#include <EEPROM.h>
+#else
+#include <string.h>
+
+// Host stand-in for the NVM region - starts erased
+static uint8_t hostNvm[kEepromCalibrationAddress + kCalibJournalPageSize * kCalibJournalPages];
+static bool hostNvmErased = false;
+
+static void eraseHostNvm() {
+  if (!hostNvmErased) {
+    memset(hostNvm, 0xFF, sizeof(hostNvm));
+    hostNvmErased = true;
+  }
+}
+#endif
+
+// CRC-32 (IEEE, reflected), nibble table keeps flash use to 64 bytes
+static const uint32_t CRC32_NIBBLE_TABLE[16] PROGMEM = {
+  0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+  0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+uint32_t CalibrationJournal::crc32(const uint8_t* data, size_t length) {
+  uint32_t crc = 0xFFFFFFFF;
+  while (length-- > 0) {
+    crc ^= *data++;
+    crc = (crc >> 4) ^ pgm_read_dword(&CRC32_NIBBLE_TABLE[crc & 0x0F]);
+    crc = (crc >> 4) ^ pgm_read_dword(&CRC32_NIBBLE_TABLE[crc & 0x0F]);
+  }
+  return ~crc;
+}
+
+bool CalibrationJournal::recover(CalibrationData& record) {
+  bool found = false;
+
+  for (uint16_t slot = 0; slot < SLOT_COUNT; slot++) {
+    consider(kEepromCalibrationAddress + slotOffset(slot), record, found);
+  }
+
+  sequence = found ? record.sequence : 0;
+  return found;
+}
+
+void CalibrationJournal::consider(uint16_t address, CalibrationData& newest, bool& found) const {
+  CalibrationData candidate;
+  readSlot(address, candidate);
+  if (!isValid(candidate)) {
+    return;
+  }
+  // Serial-number comparison so the journal keeps working past 2^32 writes
+  if (!found || (int32_t)(candidate.sequence - newest.sequence) > 0) {
+    newest = candidate;
+    found = true;
+  }
+}
+
+void CalibrationJournal::append(CalibrationData& record) {
+  sequence++;
+  record.magicNumber = kEepromMagicNumber;
+  record.version = kEepromVersion;
+  record.reserved = 0;
+  record.sequence = sequence;
+  record.crc = recordCrc(record);
+  writeSlot(slotAddress(sequence), record);
+}
+
+uint16_t CalibrationJournal::slotAddress(uint32_t sequence) {
+  return kEepromCalibrationAddress + slotOffset((sequence - 1) % SLOT_COUNT);
+}
+
+uint16_t CalibrationJournal::slotOffset(uint16_t slot) {
+  return (slot / SLOTS_PER_PAGE) * kCalibJournalPageSize + (slot % SLOTS_PER_PAGE) * sizeof(CalibrationData);
+}
+
+bool CalibrationJournal::isValid(const CalibrationData& record) {
+  return record.magicNumber == kEepromMagicNumber &&
+         record.version == kEepromVersion &&
+         record.sequence != 0 &&
+         record.crc == recordCrc(record);
+}
+
+uint32_t CalibrationJournal::recordCrc(const CalibrationData& record) {
+  return crc32(reinterpret_cast<const uint8_t*>(&record), offsetof(CalibrationData, crc));
+}
+
+#ifdef ARDUINO
+void CalibrationJournal::readSlot(uint16_t address, CalibrationData& record) {
+  EEPROM.get(address, record);
+}
+
+void CalibrationJournal::writeSlot(uint16_t address, const CalibrationData& record) {
+  EEPROM.put(address, record);
+  // Silicon Labs EEPROM writes immediately, no commit() needed
+}
+#else
+void CalibrationJournal::readSlot(uint16_t address, CalibrationData& record) {
+  eraseHostNvm();
+  memcpy(&record, &hostNvm[address], sizeof(record));
+}
+
+void CalibrationJournal::writeSlot(uint16_t address, const CalibrationData& record) {
+  eraseHostNvm();
+  memcpy(&hostNvm[address], &record, sizeof(record));
+}
+#endif
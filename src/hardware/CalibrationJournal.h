@@ -0,0 +1,62 @@
+#pragma once
+#include "../config/Config.h"
+
+// One journal record. Fixed-width fields so the layout is the same on the
+// target and on host builds.
+struct CalibrationData {
+  uint16_t magicNumber;     // Validation magic number
+  uint8_t version;          // Data structure version
+  uint8_t reserved;
+  uint32_t sequence;        // Write counter - newest record wins, also selects the slot
+  int moistureDry;          // ADC value for dry soil (probe 0)
+  int moistureWet;          // ADC value for wet soil (probe 0)
+  float batteryDivider;     // Battery voltage divider ratio
+  int16_t probeDry[kMaxMoistureProbes - 1];  // Probes 1.. - same meaning as moistureDry/Wet
+  int16_t probeWet[kMaxMoistureProbes - 1];
+  uint32_t crc;             // CRC-32 over all fields above
+};
+
+static_assert(sizeof(int) == 4, "CalibrationData layout assumes 32-bit int");
+
+// Append-only calibration journal. Records rotate through a ring of slots
+// in the NVM region, so each save touches a different location and a torn
+// write only loses the record being written. At boot the newest record with
+// a valid CRC is recovered.
+//
+// Slots are packed from the start of each page and never straddle a page
+// boundary; the tail of a page that cannot hold a whole record is unused.
+// Erase cycles are modelled as one page erase each time the write position
+// enters a new page, which is what a raw-flash backend would do. Because the
+// slot is derived from the sequence number, the count survives resets.
+class CalibrationJournal {
+public:
+  // Scan every slot for the newest valid record. Returns false if none.
+  bool recover(CalibrationData& record);
+
+  // Stamp sequence/CRC and write the record to the next slot
+  void append(CalibrationData& record);
+
+  uint32_t getWriteCount() const { return sequence; }
+  uint32_t getEraseCount() const { return (sequence + SLOTS_PER_PAGE - 1) / SLOTS_PER_PAGE; }
+  uint32_t getEraseCountPerPage() const { return (getEraseCount() + kCalibJournalPages - 1) / kCalibJournalPages; }
+
+  static uint32_t crc32(const uint8_t* data, size_t length);
+
+private:
+  static constexpr uint8_t SLOTS_PER_PAGE = kCalibJournalPageSize / sizeof(CalibrationData);
+  static constexpr uint16_t SLOT_COUNT = SLOTS_PER_PAGE * kCalibJournalPages;
+  static_assert(SLOTS_PER_PAGE > 0, "journal page smaller than one record");
+
+  uint32_t sequence = 0;  // Sequence of the newest record on NVM (0 = empty)
+
+  void consider(uint16_t address, CalibrationData& newest, bool& found) const;
+
+  static uint16_t slotAddress(uint32_t sequence);
+  static uint16_t slotOffset(uint16_t slot);
+  static bool isValid(const CalibrationData& record);
+  static uint32_t recordCrc(const CalibrationData& record);
+
+  // NVM backend - EEPROM emulation on target, RAM on host builds
+  static void readSlot(uint16_t address, CalibrationData& record);
+  static void writeSlot(uint16_t address, const CalibrationData& record);
+};
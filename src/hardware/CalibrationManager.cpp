@@ -1,6 +1,9 @@
 #include "CalibrationManager.h"
 #include <Arduino.h>
+#include <stddef.h>
+#ifdef ARDUINO
 #include <EEPROM.h>
+#endif
 
 void CalibrationManager::begin() {
   // Silicon Labs EEPROM doesn't need begin() with size parameter
@@ -8,26 +11,46 @@ void CalibrationManager::begin() {
 }
 
 void CalibrationManager::loadCalibration() {
-  if (readFromEEPROM() && isCalibrationValid()) {
+  if (journal.recover(data) && isCalibrationValid()) {
     dataLoaded = true;
-  } else {
-    // Invalid or missing data, use defaults
-    resetToDefaults();
-    saveCalibration(); // Save defaults to EEPROM
+    return;
   }
+  // Invalid or missing data, use defaults - a version 1 record only carries probe 0
+  resetToDefaults();
+  readLegacyRecord();
+  commit(); // Carry the version 1 record over into the journal, or save the defaults
 }
 
 void CalibrationManager::saveCalibration() {
-  data.checksum = calculateChecksum(data);
-  writeToEEPROM();
+  savePending = true;
+  lastEditMs = millis();
+}
+
+void CalibrationManager::service(uint32_t now, PowerState state) {
+  if (savePending && now - lastEditMs >= kCalibSaveDelayMs) {
+    flush(state);
+  }
+}
+
+bool CalibrationManager::flush(PowerState state) {
+  if (!savePending) {
+    return true;
+  }
+  if (state == PowerState::Critical) {
+    return false;  // A brown-out mid-write would cost the record - wait for power
+  }
+  commit();
+  return true;
 }
 
 void CalibrationManager::resetToDefaults() {
-  data.magicNumber = kEepromMagicNumber;
-  data.version = kEepromVersion;
   data.moistureDry = kDefaultMoistureDry;
   data.moistureWet = kDefaultMoistureWet;
   data.batteryDivider = kDefaultBatteryDivider;
+  for (uint8_t i = 0; i < kMaxMoistureProbes - 1; i++) {
+    data.probeDry[i] = kDefaultMoistureDry;
+    data.probeWet[i] = kDefaultMoistureWet;
+  }
   dataLoaded = true;
 }
 
@@ -41,6 +64,24 @@ void CalibrationManager::getMoistureCalibration(int& dryValue, int& wetValue) co
   wetValue = data.moistureWet;
 }
 
+void CalibrationManager::setMoistureCalibration(uint8_t probe, int dryValue, int wetValue) {
+  if (probe == 0) {
+    setMoistureCalibration(dryValue, wetValue);
+  } else if (probe < kMaxMoistureProbes) {
+    data.probeDry[probe - 1] = dryValue;
+    data.probeWet[probe - 1] = wetValue;
+  }
+}
+
+void CalibrationManager::getMoistureCalibration(uint8_t probe, int& dryValue, int& wetValue) const {
+  if (probe == 0 || probe >= kMaxMoistureProbes) {
+    getMoistureCalibration(dryValue, wetValue);
+  } else {
+    dryValue = data.probeDry[probe - 1];
+    wetValue = data.probeWet[probe - 1];
+  }
+}
+
 void CalibrationManager::setBatteryDivider(float divider) {
   data.batteryDivider = divider;
 }
@@ -57,15 +98,23 @@ void CalibrationManager::startCalibration() {
 
 void CalibrationManager::calibrateDry() {
   if (calibrationMode) {
-    // Read current ADC value as dry reference
-    data.moistureDry = analogRead(kMoisturePin);
+    // Read current ADC value of each probe as its dry reference
+    for (uint8_t probe = 0; probe < kMoistureProbeCount; probe++) {
+      int dryValue, wetValue;
+      getMoistureCalibration(probe, dryValue, wetValue);
+      setMoistureCalibration(probe, analogRead(kMoisturePins[probe]), wetValue);
+    }
   }
 }
 
 void CalibrationManager::calibrateWet() {
   if (calibrationMode) {
-    // Read current ADC value as wet reference
-    data.moistureWet = analogRead(kMoisturePin);
+    // Read current ADC value of each probe as its wet reference
+    for (uint8_t probe = 0; probe < kMoistureProbeCount; probe++) {
+      int dryValue, wetValue;
+      getMoistureCalibration(probe, dryValue, wetValue);
+      setMoistureCalibration(probe, dryValue, analogRead(kMoisturePins[probe]));
+    }
   }
 }
 
@@ -77,30 +126,53 @@ void CalibrationManager::finishCalibration() {
 }
 
 bool CalibrationManager::isCalibrationValid() const {
-  return (data.magicNumber == kEepromMagicNumber) &&
-         (data.version == kEepromVersion) &&
-         (data.moistureDry != data.moistureWet) &&
-         (data.batteryDivider > 0.0) &&
-         (calculateChecksum(data) == data.checksum);
+  for (uint8_t probe = 0; probe < kMoistureProbeCount; probe++) {
+    int dryValue, wetValue;
+    getMoistureCalibration(probe, dryValue, wetValue);
+    if (dryValue == wetValue) {
+      return false;
+    }
+  }
+  return data.batteryDivider > 0.0;
+}
+
+void CalibrationManager::commit() {
+  journal.append(data);
+  savePending = false;
 }
 
-uint8_t CalibrationManager::calculateChecksum(const CalibrationData& data) const {
+// Version 1 layout: one record at the start of the region, XOR checksum
+struct LegacyCalibrationData {
+  uint16_t magicNumber;
+  uint8_t version;
+  int moistureDry;
+  int moistureWet;
+  float batteryDivider;
+  uint8_t checksum;
+};
+
+bool CalibrationManager::readLegacyRecord() {
+#ifdef ARDUINO
+  LegacyCalibrationData legacy;
+  EEPROM.get(kEepromCalibrationAddress, legacy);
+
   uint8_t checksum = 0;
-  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&data);
-  size_t size = sizeof(CalibrationData) - sizeof(data.checksum); // Exclude checksum itself
-  
-  for (size_t i = 0; i < size; i++) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&legacy);
+  for (size_t i = 0; i < offsetof(LegacyCalibrationData, checksum); i++) {
     checksum ^= bytes[i];
   }
-  return checksum;
-}
 
-void CalibrationManager::writeToEEPROM() {
-  EEPROM.put(kEepromCalibrationAddress, data);
-  // Silicon Labs EEPROM writes immediately, no commit() needed
-}
+  if (legacy.magicNumber != kEepromMagicNumber || legacy.version != 1 ||
+      legacy.checksum != checksum || legacy.moistureDry == legacy.moistureWet ||
+      !(legacy.batteryDivider > 0.0)) {
+    return false;
+  }
 
-bool CalibrationManager::readFromEEPROM() {
-  EEPROM.get(kEepromCalibrationAddress, data);
-  return true; // EEPROM.get always succeeds
+  data.moistureDry = legacy.moistureDry;
+  data.moistureWet = legacy.moistureWet;
+  data.batteryDivider = legacy.batteryDivider;
+  return true;
+#else
+  return false;
+#endif
 }
@@ -1,14 +1,7 @@
 #pragma once
 #include "../config/Config.h"
-
-struct CalibrationData {
-  uint16_t magicNumber;     // Validation magic number
-  uint8_t version;          // Data structure version
-  int moistureDry;          // ADC value for dry soil
-  int moistureWet;          // ADC value for wet soil
-  float batteryDivider;     // Battery voltage divider ratio
-  uint8_t checksum;         // Simple checksum for data integrity
-};
+#include "CalibrationJournal.h"
+#include "PowerManager.h"
 
 class CalibrationManager {
 public:
@@ -16,18 +9,30 @@ public:
   
   // Calibration data access
   void loadCalibration();
-  void saveCalibration();
+  void saveCalibration();     // Queues a journal write - edits are coalesced
   void resetToDefaults();
   
-  // Moisture sensor calibration
+  // Deferred writes - commit once edits settle, never in Critical power state
+  void service(uint32_t now, PowerState state);
+  bool flush(PowerState state);  // Commit now (before sleep); false if deferred
+  bool hasPendingSave() const { return savePending; }
+  
+  // Journal wear statistics
+  uint32_t getWriteCount() const { return journal.getWriteCount(); }
+  uint32_t getEraseCount() const { return journal.getEraseCount(); }
+  uint32_t getEraseCountPerPage() const { return journal.getEraseCountPerPage(); }
+  
+  // Moisture sensor calibration - the two-argument forms are probe 0
   void setMoistureCalibration(int dryValue, int wetValue);
   void getMoistureCalibration(int& dryValue, int& wetValue) const;
+  void setMoistureCalibration(uint8_t probe, int dryValue, int wetValue);
+  void getMoistureCalibration(uint8_t probe, int& dryValue, int& wetValue) const;
   
   // Battery calibration
   void setBatteryDivider(float divider);
   float getBatteryDivider() const;
   
-  // Calibration process helpers
+  // Calibration process helpers - dry/wet capture every fitted probe at once
   void startCalibration();
   bool isCalibrating() const { return calibrationMode; }
   void calibrateDry();
@@ -39,10 +44,12 @@ public:
   
 private:
   CalibrationData data;
+  CalibrationJournal journal;
   bool calibrationMode = false;
   bool dataLoaded = false;
+  bool savePending = false;
+  uint32_t lastEditMs = 0;
   
-  uint8_t calculateChecksum(const CalibrationData& data) const;
-  void writeToEEPROM();
-  bool readFromEEPROM();
+  void commit();
+  bool readLegacyRecord();
 };
@@ -0,0 +1,139 @@
+#include "ClimateSensors.h"
+#include "I2cBus.h"
+#include <Arduino.h>
+
+void I2cSensor::detect() {
+  i2cBus.probe(address, onProbe, this);
+}
+
+bool I2cSensor::start() {
+  if (state != State::Idle) {
+    return false;
+  }
+  uint8_t command[4];
+  uint8_t length = triggerCommand(command);
+  if (!i2cBus.write(address, command, length, onTrigger, this)) {
+    return false;
+  }
+  fresh = false;
+  state = State::Triggering;
+  return true;
+}
+
+void I2cSensor::service(uint32_t nowMs) {
+  // Strictly past the conversion time - millis() may have ticked just after the trigger
+  if (state != State::Converting || (uint32_t)(nowMs - triggeredMs) <= conversionMs) {
+    return;
+  }
+  uint8_t command[2];
+  uint8_t length = readCommand(command);
+  if (i2cBus.writeRead(address, command, length, buffer, readLength, onRead, this)) {
+    state = State::Reading;
+  }
+}
+
+void I2cSensor::onProbe(uint8_t status, void* context) {
+  static_cast<I2cSensor*>(context)->state = status == 0 ? State::Idle : State::Absent;
+}
+
+void I2cSensor::onTrigger(uint8_t status, void* context) {
+  I2cSensor* sensor = static_cast<I2cSensor*>(context);
+  if (status != 0) {
+    sensor->errorCount++;
+    sensor->state = State::Idle;
+    return;
+  }
+  sensor->triggeredMs = millis();
+  sensor->state = State::Converting;
+}
+
+void I2cSensor::onRead(uint8_t status, void* context) {
+  I2cSensor* sensor = static_cast<I2cSensor*>(context);
+  sensor->state = State::Idle;
+  if (status == 0 && sensor->parse(sensor->buffer)) {
+    sensor->fresh = true;
+  } else {
+    sensor->errorCount++;
+  }
+}
+
+// CRC-8, polynomial 0x31, initial value 0xFF (SHT4x datasheet 4.4)
+uint8_t Sht4xSensor::crc8(const uint8_t* data, uint8_t length) {
+  uint8_t crc = 0xFF;
+  for (uint8_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+uint8_t Sht4xSensor::triggerCommand(uint8_t* command) const {
+  command[0] = 0xF6;  // Measure T and RH, medium repeatability
+  return 1;
+}
+
+bool Sht4xSensor::parse(const uint8_t* data) {
+  if (crc8(data, 2) != data[2] || crc8(data + 3, 2) != data[5]) {
+    return false;
+  }
+  uint32_t rawTemperature = ((uint32_t)data[0] << 8) | data[1];
+  uint32_t rawHumidity = ((uint32_t)data[3] << 8) | data[4];
+  // T = -45 + 175 * raw / 65535 degC, RH = -6 + 125 * raw / 65535 %
+  temperatureCentiC = (int16_t)(-4500 + (int32_t)((17500 * rawTemperature + 32767) / 65535));
+  int32_t humidity = -600 + (int32_t)((12500 * rawHumidity + 32767) / 65535);
+  humidityCentiPercent = (uint16_t)constrain(humidity, 0L, 10000L);  // Out of range by spec near the rails
+  return true;
+}
+
+uint8_t Tmp117Sensor::triggerCommand(uint8_t* command) const {
+  command[0] = 0x01;  // Configuration register
+  command[1] = 0x0C;  // MOD = one-shot, CONV = 0, AVG = none
+  command[2] = 0x00;
+  return 3;
+}
+
+uint8_t Tmp117Sensor::readCommand(uint8_t* command) const {
+  command[0] = 0x00;  // Temperature result register
+  return 1;
+}
+
+bool Tmp117Sensor::parse(const uint8_t* data) {
+  int16_t raw = (int16_t)(((uint16_t)data[0] << 8) | data[1]);
+  if (raw == (int16_t)0x8000) {
+    return false;  // Reset value - no conversion has completed
+  }
+  temperatureCentiC = (int16_t)((int32_t)raw * 25 / 32);  // 7.8125 mdegC per LSB
+  return true;
+}
+
+void ClimateSensors::begin() {
+  air.detect();
+  soil.detect();
+  i2cBus.flush(kClimateTimeoutMs);
+}
+
+void ClimateSensors::start() {
+  air.start();
+  soil.start();
+  for (uint8_t i = 0; i < kI2cQueueDepth; i++) {
+    if (air.getState() != I2cSensor::State::Triggering && soil.getState() != I2cSensor::State::Triggering) {
+      break;
+    }
+    i2cBus.poll();
+  }
+}
+
+bool ClimateSensors::finish(uint32_t timeoutMs) {
+  uint32_t start = millis();
+  while (isBusy() && (uint32_t)(millis() - start) < timeoutMs) {
+    service(millis());
+    if (!i2cBus.isIdle()) {
+      i2cBus.poll();
+    } else if (isBusy()) {
+      delay(1);  // Converting - the core idles the CPU meanwhile
+    }
+  }
+  return !isBusy();
+}
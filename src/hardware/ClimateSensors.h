@@ -0,0 +1,109 @@
+#pragma once
+#include "../config/Config.h"
+
+// One triggered-conversion sensor on the shared I2cBus, run as a state
+// machine. start() queues the trigger, service() queues the read once the
+// conversion time has passed since the trigger went out, and the read
+// callback parses the result. Nothing here waits on the bus, so the
+// conversion runs alongside whatever the wake does meanwhile.
+class I2cSensor {
+public:
+  enum class State : uint8_t { Absent, Idle, Triggering, Converting, Reading };
+
+  void detect();                 // Boot: queues an address probe - drain the bus after
+  bool start();                  // Queues a conversion; false if absent, busy or the queue is full
+  void service(uint32_t nowMs);  // Call every loop
+
+  State getState() const { return state; }
+  bool isPresent() const { return state != State::Absent; }
+  bool isBusy() const { return state > State::Idle; }
+  bool hasReading() const { return fresh; }  // The last conversion succeeded
+  uint32_t getErrorCount() const { return errorCount; }
+
+protected:
+  static const uint8_t MAX_READ = 6;
+
+  I2cSensor(uint8_t address, uint8_t conversionMs, uint8_t readLength)
+      : address(address), conversionMs(conversionMs), readLength(readLength) {}
+  virtual ~I2cSensor() = default;
+
+  virtual uint8_t triggerCommand(uint8_t* command) const = 0;       // Returns the length
+  virtual uint8_t readCommand(uint8_t* command) const { return 0; }  // Register pointer, if any
+  virtual bool parse(const uint8_t* data) = 0;                        // False rejects the reading
+
+private:
+  uint8_t address;
+  uint8_t conversionMs;
+  uint8_t readLength;
+  State state = State::Absent;
+  bool fresh = false;
+  uint32_t triggeredMs = 0;
+  uint32_t errorCount = 0;
+  uint8_t buffer[MAX_READ];
+
+  static void onProbe(uint8_t status, void* context);
+  static void onTrigger(uint8_t status, void* context);
+  static void onRead(uint8_t status, void* context);
+};
+
+// Sensirion SHT4x air temperature and humidity, medium repeatability.
+// Both words carry a CRC-8; a mismatch drops the reading.
+class Sht4xSensor : public I2cSensor {
+public:
+  Sht4xSensor() : I2cSensor(kSht4xI2cAddress, kSht4xConversionMs, 6) {}
+
+  int16_t getTemperatureCentiC() const { return temperatureCentiC; }
+  uint16_t getHumidityCentiPercent() const { return humidityCentiPercent; }
+
+  static uint8_t crc8(const uint8_t* data, uint8_t length);
+
+protected:
+  uint8_t triggerCommand(uint8_t* command) const override;
+  bool parse(const uint8_t* data) override;
+
+private:
+  int16_t temperatureCentiC = 0;
+  uint16_t humidityCentiPercent = 0;
+};
+
+// TI TMP117 soil temperature probe, one conversion per trigger without
+// averaging; the part returns to shutdown afterwards.
+class Tmp117Sensor : public I2cSensor {
+public:
+  Tmp117Sensor() : I2cSensor(kTmp117I2cAddress, kTmp117ConversionMs, 2) {}
+
+  int16_t getTemperatureCentiC() const { return temperatureCentiC; }
+
+protected:
+  uint8_t triggerCommand(uint8_t* command) const override;
+  uint8_t readCommand(uint8_t* command) const override;
+  bool parse(const uint8_t* data) override;
+
+private:
+  int16_t temperatureCentiC = 0;
+};
+
+// Air and soil sensors, triggered together at the top of a measurement
+// wake. The conversions overlap the battery ADC work, and
+// finish() only waits for the part that work didn't cover. A sensor that
+// didn't answer at boot is skipped.
+class ClimateSensors {
+public:
+  Sht4xSensor air;
+  Tmp117Sensor soil;
+
+  void begin();  // Probes both addresses and drains the bus (boot only)
+
+  // Triggers go out before this returns, after at most a queue's worth of
+  // earlier traffic
+  void start();
+  void service(uint32_t nowMs) {
+    air.service(nowMs);
+    soil.service(nowMs);
+  }
+  bool isBusy() const { return air.isBusy() || soil.isBusy(); }
+
+  // Runs the bus until both are done, sleeping 1 ms at a time while they
+  // convert. False on timeout - the late reading lands on a later loop.
+  bool finish(uint32_t timeoutMs = kClimateTimeoutMs);
+};
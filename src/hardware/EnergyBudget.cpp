@@ -0,0 +1,173 @@
+#include "EnergyBudget.h"
+#include "CalibrationJournal.h"
+#include <Arduino.h>
+#include <stddef.h>
+#include <string.h>
+
+// Retained RAM: the MG24 backup RAM keeps 32 words through EM4
+#if defined(ARDUINO_ARCH_SILABS) && __has_include(<em_device.h>)
+#include <em_device.h>
+#endif
+#if defined(BURAM)
+#define ENERGY_RETAINED_HW 1
+#else
+#define ENERGY_RETAINED_HW 0
+#endif
+
+namespace {
+  constexpr uint8_t kRetainedFirstWord = 16;  // BURAM words 16..23 belong to the energy budget
+  constexpr uint8_t kRetainedWords = 8;
+}
+
+#if !ENERGY_RETAINED_HW
+// Host / other targets: plain RAM stands in for retained memory
+static uint32_t retainedWords[kRetainedWords];
+#endif
+
+void EnergyBudget::begin(uint32_t nowMs) {
+  lastUpdateMs = nowMs;
+  elapsedSeconds = 0;
+  elapsedRemainderMs = 0;
+  wakeChargeUc = 0;
+  awakeMs = 0;
+  lastRadioOnMs = 0;
+  pendingRadioMs = 0;
+  waking = false;
+
+  // Resume after the reset that ended a sleep; the snapshot is taken once,
+  // so any other reset starts over
+  Snapshot snapshot;
+  if (readRetained(snapshot)) {
+    elapsedSeconds = snapshot.elapsedSeconds;
+    elapsedRemainderMs = snapshot.elapsedRemainderMs;
+    awakeMs = snapshot.awakeMs;
+    pendingRadioMs = snapshot.radioMs;
+    wakeChargeUc = snapshot.wakeChargeUc;
+    intervalMs = snapshot.intervalMs;
+    projectedDays = snapshot.projectedDays;
+  }
+  memset(&snapshot, 0, sizeof(snapshot));
+  writeRetained(snapshot);
+}
+
+float EnergyBudget::cycleChargeUc(uint32_t awakeMs, uint32_t radioOnMs, uint32_t icdPolls) {
+  // uA * ms / 1000 = uC; the radio's time is part of the awake time
+  uint32_t radioMs = min(radioOnMs, awakeMs);
+  return ((float)(awakeMs - radioMs) * kActiveCurrentUa + (float)radioMs * kRadioTxCurrentUa) / 1000.0f +
+         (float)icdPolls * kIcdPollChargeUc;
+}
+
+void EnergyBudget::beginWake(uint32_t nowMs, uint32_t displayMicrojoules, uint32_t radioOnMs, uint32_t icdPolls,
+                             float batteryVoltage) {
+  endWake(nowMs);  // Cycle never reached its idle point - count all of it
+  uint32_t cycleRadioMs = pendingRadioMs + (radioOnMs - lastRadioOnMs);
+  lastRadioOnMs = radioOnMs;
+  pendingRadioMs = 0;
+
+  if (awakeMs > 0) {
+    // Display energy converts at the battery voltage
+    float chargeUc = cycleChargeUc(awakeMs, cycleRadioMs, icdPolls);
+    if (batteryVoltage > 0.5f) {
+      chargeUc += displayMicrojoules / batteryVoltage;
+    }
+    if (wakeChargeUc == 0) {
+      wakeChargeUc = chargeUc;
+    } else {
+      wakeChargeUc += kWakeCostSmoothing * (chargeUc - wakeChargeUc);
+    }
+  }
+
+  wakeStartMs = nowMs;
+  awakeMs = 0;
+  waking = true;
+}
+
+void EnergyBudget::endWake(uint32_t nowMs) {
+  if (waking) {
+    awakeMs = nowMs - wakeStartMs;
+    waking = false;
+  }
+}
+
+void EnergyBudget::suspend(uint32_t nowMs, uint32_t sleepMs, uint32_t radioOnMs) {
+  endWake(nowMs);
+  advanceClock(nowMs - lastUpdateMs);
+  lastUpdateMs = nowMs;
+  advanceClock(sleepMs);
+
+  Snapshot snapshot;
+  memset(&snapshot, 0, sizeof(snapshot));
+  snapshot.elapsedSeconds = elapsedSeconds;
+  snapshot.elapsedRemainderMs = elapsedRemainderMs;
+  snapshot.awakeMs = awakeMs;
+  snapshot.radioMs = pendingRadioMs + (radioOnMs - lastRadioOnMs);
+  snapshot.wakeChargeUc = wakeChargeUc;
+  snapshot.intervalMs = intervalMs;
+  snapshot.projectedDays = projectedDays;
+  snapshot.crc = CalibrationJournal::crc32(reinterpret_cast<const uint8_t*>(&snapshot),
+                                           offsetof(Snapshot, crc));
+  writeRetained(snapshot);
+}
+
+// Accumulate in seconds so the clock survives millis() rollover
+void EnergyBudget::advanceClock(uint32_t elapsedMs) {
+  elapsedRemainderMs += elapsedMs;
+  elapsedSeconds += elapsedRemainderMs / 1000;
+  elapsedRemainderMs %= 1000;
+}
+
+bool EnergyBudget::readRetained(Snapshot& snapshot) {
+  static_assert(sizeof(Snapshot) == kRetainedWords * sizeof(uint32_t), "snapshot must fill its retained words");
+  uint32_t* words = reinterpret_cast<uint32_t*>(&snapshot);
+  for (uint8_t i = 0; i < kRetainedWords; i++) {
+#if ENERGY_RETAINED_HW
+    words[i] = BURAM->RET[kRetainedFirstWord + i].REG;
+#else
+    words[i] = retainedWords[i];
+#endif
+  }
+  return snapshot.crc == CalibrationJournal::crc32(reinterpret_cast<const uint8_t*>(&snapshot),
+                                                   offsetof(Snapshot, crc));
+}
+
+void EnergyBudget::writeRetained(const Snapshot& snapshot) {
+  const uint32_t* words = reinterpret_cast<const uint32_t*>(&snapshot);
+  for (uint8_t i = 0; i < kRetainedWords; i++) {
+#if ENERGY_RETAINED_HW
+    BURAM->RET[kRetainedFirstWord + i].REG = words[i];
+#else
+    retainedWords[i] = words[i];
+#endif
+  }
+}
+
+void EnergyBudget::update(uint32_t nowMs, uint8_t stateOfCharge, uint32_t minInterval, uint32_t maxInterval) {
+  advanceClock(nowMs - lastUpdateMs);
+  lastUpdateMs = nowMs;
+
+  if (!hasEstimate()) {
+    return;
+  }
+
+  // Remaining charge in uC (1 mAh = 3.6e6 uC)
+  float remainingUc = (float)kBatteryCapacityMah * 3.6e6f * min(stateOfCharge, (uint8_t)100) / 100.0f;
+
+  float targetSeconds = (float)targetDays * 86400.0f;
+  float leftSeconds = targetSeconds - elapsedSeconds;
+  if (leftSeconds < kMinRemainingDays * 86400.0f) {
+    leftSeconds = kMinRemainingDays * 86400.0f;
+  }
+
+  // Current left over for wakes once sleep current is paid for
+  float budgetUa = remainingUc / leftSeconds;
+  float wakeBudgetUa = budgetUa - kSleepCurrentUa;
+  float solvedMs = wakeBudgetUa > 0 ? wakeChargeUc / wakeBudgetUa * 1000.0f : (float)maxInterval;
+  if (solvedMs < minInterval) solvedMs = minInterval;
+  if (solvedMs > maxInterval) solvedMs = maxInterval;
+  intervalMs = (uint32_t)solvedMs;
+
+  // Days left at the interval actually in use
+  float averageUa = wakeChargeUc * 1000.0f / intervalMs + kSleepCurrentUa;
+  float days = remainingUc / averageUa / 86400.0f;
+  projectedDays = days < 65535.0f ? (uint16_t)days : 65535;
+}
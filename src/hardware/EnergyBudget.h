@@ -0,0 +1,84 @@
+#pragma once
+#include "../config/Config.h"
+
+// Lifetime-targeting interval controller. Each wake is metered (awake time
+// at kActiveCurrentUa, radio time at kRadioTxCurrentUa, the SED polls the
+// cycle costs and display energy) into a smoothed charge per wake.
+// From the remaining charge and the time left until the target lifetime it
+// solves the interval whose average current spends the battery exactly on
+// schedule:
+//
+//   interval = chargePerWake / (remaining / timeLeft - sleepCurrent)
+//
+// Every sleep ends in a reset, so suspend() keeps the controller's state -
+// elapsed time, the smoothed charge per wake and the wake being closed -
+// in retained RAM (BURAM words 16..23 on the MG24) and begin() picks it
+// up again. The sleep counts as elapsed at its programmed length; a wake
+// brought forward by a threshold crossing is counted as a full one. Any
+// other reset, or a CRC mismatch, starts over from the full target -
+// conservative, never short. The solved interval only ever lengthens the
+// configured one (minInterval): a fresh pack with budget to spare keeps
+// the normal cadence.
+class EnergyBudget {
+public:
+  void begin(uint32_t nowMs);  // Resumes a suspended budget when retained RAM holds one
+
+  // Wake metering. beginWake() closes out the previous cycle - its awake
+  // time plus the display energy spent since - and starts timing this one;
+  // endWake() marks the point the cycle's work is done (idempotent).
+  // radioOnMs is the uplink's running total (ReportUplink::getRadioOnMs());
+  // icdPolls the data polls one cycle costs (icdPollsPerWake()).
+  void beginWake(uint32_t nowMs, uint32_t displayMicrojoules, uint32_t radioOnMs, uint32_t icdPolls,
+                 float batteryVoltage);
+  void endWake(uint32_t nowMs);
+  // Before a sleep that ends in a reset: closes the wake and retains the
+  // state, with sleepMs counted as elapsed
+  void suspend(uint32_t nowMs, uint32_t sleepMs, uint32_t radioOnMs);
+
+  // Charge of one cycle without the display, uC
+  static float cycleChargeUc(uint32_t awakeMs, uint32_t radioOnMs, uint32_t icdPolls);
+
+  // Re-solve the interval; stateOfCharge in percent. minInterval is the
+  // configured interval - the budget never samples faster than it
+  void update(uint32_t nowMs, uint8_t stateOfCharge, uint32_t minInterval, uint32_t maxInterval);
+
+  bool hasEstimate() const { return wakeChargeUc > 0; }
+  uint32_t getInterval() const { return intervalMs; }
+  uint16_t getProjectedDays() const { return projectedDays; }
+  uint16_t getTargetDays() const { return targetDays; }
+  void setTargetDays(uint16_t days) { targetDays = days ? days : 1; }
+  uint32_t getElapsedSeconds() const { return elapsedSeconds; }
+  float getWakeChargeUc() const { return wakeChargeUc; }  // Smoothed charge per wake (uC)
+
+private:
+  // Retained across the reset that ends a sleep
+  struct Snapshot {
+    uint32_t elapsedSeconds;
+    uint32_t elapsedRemainderMs;
+    uint32_t awakeMs;          // The wake suspend() closed, folded in by the next beginWake()
+    uint32_t radioMs;          // Its radio time - the uplink total restarts with the reset
+    float wakeChargeUc;
+    uint32_t intervalMs;
+    uint32_t projectedDays;
+    uint32_t crc;              // CRC-32 over everything above
+  };
+
+  uint16_t targetDays = kTargetLifetimeDays;
+  uint32_t elapsedSeconds = 0;
+  uint32_t elapsedRemainderMs = 0;
+  uint32_t lastUpdateMs = 0;
+
+  uint32_t wakeStartMs = 0;
+  uint32_t awakeMs = 0;      // Length of the last completed wake
+  uint32_t lastRadioOnMs = 0;  // Uplink radio total at the previous beginWake()
+  uint32_t pendingRadioMs = 0; // Radio time of a wake closed before the reset
+  bool waking = false;
+  float wakeChargeUc = 0;
+
+  uint32_t intervalMs = kNormalSleepInterval;
+  uint16_t projectedDays = 0;
+
+  void advanceClock(uint32_t elapsedMs);
+  static bool readRetained(Snapshot& snapshot);
+  static void writeRetained(const Snapshot& snapshot);
+};
@@ -0,0 +1,104 @@
+#include "I2cBus.h"
+#include <Arduino.h>
+#include <Wire.h>
+
+I2cBus i2cBus;
+
+void I2cBus::begin(uint32_t clock) {
+  if (!started) {
+    Wire.begin();
+    started = true;
+  }
+  if (clock != clockHz) {
+    Wire.setClock(clock);
+    clockHz = clock;
+  }
+}
+
+bool I2cBus::write(uint8_t address, const uint8_t* data, uint8_t length,
+                   I2cCallback callback, void* context) {
+  return writeRead(address, data, length, nullptr, 0, callback, context);
+}
+
+bool I2cBus::writeRead(uint8_t address, const uint8_t* data, uint8_t length,
+                       uint8_t* readBuffer, uint8_t readLength,
+                       I2cCallback callback, void* context) {
+  if (count >= kI2cQueueDepth || length > kI2cMaxPayload || readLength > kI2cMaxPayload) {
+    return false;
+  }
+
+  I2cTransaction& transaction = queue[(head + count) % kI2cQueueDepth];
+  transaction.address = address;
+  transaction.writeLength = length;
+  transaction.readLength = readBuffer ? readLength : 0;
+  if (length > 0) {
+    memcpy(transaction.writeData, data, length);
+  }
+  transaction.readBuffer = readBuffer;
+  transaction.callback = callback;
+  transaction.context = context;
+  count++;
+  return true;
+}
+
+void I2cBus::poll() {
+  if (count == 0) {
+    return;
+  }
+
+  // Pop before executing so the callback may queue follow-up transactions
+  I2cTransaction transaction = queue[head];
+  head = (head + 1) % kI2cQueueDepth;
+  count--;
+
+  execute(transaction);
+}
+
+bool I2cBus::flush(uint32_t timeoutMs) {
+  uint32_t start = millis();
+  while (count > 0) {
+    if (millis() - start > timeoutMs) {
+      return false;
+    }
+    poll();
+  }
+  return true;
+}
+
+void I2cBus::execute(I2cTransaction& transaction) {
+  uint32_t startMicros = micros();
+  uint8_t status = 0;
+
+  if (transaction.writeLength > 0 || transaction.readLength == 0) {
+    // Zero-length write doubles as an address probe
+    Wire.beginTransmission(transaction.address);
+    if (transaction.writeLength > 0) {
+      Wire.write(transaction.writeData, transaction.writeLength);
+    }
+    // Repeated start when a read follows
+    status = Wire.endTransmission(transaction.readLength == 0);
+  }
+
+  if (status == 0 && transaction.readLength > 0) {
+    uint8_t received = Wire.requestFrom(transaction.address, transaction.readLength);
+    for (uint8_t i = 0; i < received; i++) {
+      transaction.readBuffer[i] = Wire.read();
+    }
+    if (received != transaction.readLength) {
+      status = 4;
+    }
+  }
+
+  uint32_t elapsed = micros() - startMicros;
+  if (elapsed > maxTransactionMicros) {
+    maxTransactionMicros = elapsed;
+  }
+  transactionCount++;
+  if (status != 0) {
+    errorCount++;
+  }
+
+  if (transaction.callback) {
+    transaction.callback(status, transaction.context);
+  }
+}
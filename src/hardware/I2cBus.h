@@ -0,0 +1,70 @@
+#pragma once
+#include "../config/Config.h"
+
+// Completion status uses the Wire.endTransmission() codes:
+// 0 = success, 1 = too long, 2 = address NACK, 3 = data NACK, 4 = other
+typedef void (*I2cCallback)(uint8_t status, void* context);
+
+struct I2cTransaction {
+  uint8_t address;
+  uint8_t writeLength;
+  uint8_t readLength;
+  uint8_t writeData[kI2cMaxPayload];  // Copied at enqueue - caller buffer may be reused
+  uint8_t* readBuffer;                // Must stay valid until the callback runs
+  I2cCallback callback;
+  void* context;
+};
+
+// Shared I2C transaction queue for the display and sensor drivers.
+// Transactions are copied into a fixed ring and executed one per poll(),
+// so no single loop iteration spends more than one short transfer on the
+// bus (about 0.7 ms for 32 bytes at 400 kHz). The Arduino core owns the I2C
+// interrupt through Wire, so transfers run from poll() rather than an ISR.
+class I2cBus {
+public:
+  void begin(uint32_t clockHz = kI2cClockHz);  // Safe to call more than once
+  
+  // Queue operations - return false when the queue is full
+  bool write(uint8_t address, const uint8_t* data, uint8_t length,
+             I2cCallback callback = nullptr, void* context = nullptr);
+  bool writeRead(uint8_t address, const uint8_t* data, uint8_t length,
+                 uint8_t* readBuffer, uint8_t readLength,
+                 I2cCallback callback = nullptr, void* context = nullptr);
+  bool read(uint8_t address, uint8_t* readBuffer, uint8_t readLength,
+            I2cCallback callback = nullptr, void* context = nullptr) {
+    return writeRead(address, nullptr, 0, readBuffer, readLength, callback, context);
+  }
+  bool probe(uint8_t address, I2cCallback callback, void* context = nullptr) {
+    return write(address, nullptr, 0, callback, context);
+  }
+  
+  // Execute at most one queued transaction - call every loop()
+  void poll();
+  
+  // Drain the queue before returning (boot-time detection only)
+  bool flush(uint32_t timeoutMs);
+  
+  uint8_t freeSlots() const { return kI2cQueueDepth - count; }
+  bool isIdle() const { return count == 0; }
+  
+  // Statistics and diagnostics
+  uint32_t getTransactionCount() const { return transactionCount; }
+  uint32_t getErrorCount() const { return errorCount; }
+  uint32_t getMaxTransactionMicros() const { return maxTransactionMicros; }
+  uint32_t getClockHz() const { return clockHz; }
+
+private:
+  I2cTransaction queue[kI2cQueueDepth];
+  uint8_t head = 0;   // Next transaction to run
+  uint8_t count = 0;
+  bool started = false;
+  uint32_t clockHz = 0;
+  
+  uint32_t transactionCount = 0;
+  uint32_t errorCount = 0;
+  uint32_t maxTransactionMicros = 0;
+  
+  void execute(I2cTransaction& transaction);
+};
+
+extern I2cBus i2cBus;
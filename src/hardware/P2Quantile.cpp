@@ -0,0 +1,134 @@
+#include "P2Quantile.h"
+
+void P2Quantile::add(float x) {
+  // Warm-up: keep the first five samples sorted
+  if (count < 5) {
+    uint8_t i = count;
+    while (i > 0 && heights[i - 1] > x) {
+      heights[i] = heights[i - 1];
+      i--;
+    }
+    heights[i] = x;
+    count++;
+    if (count == 5) {
+      for (uint8_t m = 0; m < 5; m++) {
+        positions[m] = m;
+      }
+    }
+    return;
+  }
+
+  // Find the cell holding x, stretching the extremes if needed
+  uint8_t k;
+  if (x < heights[0]) {
+    heights[0] = x;
+    k = 0;
+  } else if (x >= heights[4]) {
+    heights[4] = x;
+    k = 3;
+  } else {
+    k = 0;
+    while (k < 3 && x >= heights[k + 1]) {
+      k++;
+    }
+  }
+
+  for (uint8_t i = k + 1; i < 5; i++) {
+    positions[i] += 1;
+  }
+  count++;
+
+  // Move middle markers that drifted a full position from where they belong
+  for (uint8_t i = 1; i < 4; i++) {
+    float d = desired(i) - positions[i];
+    if ((d >= 1 && positions[i + 1] - positions[i] > 1) ||
+        (d <= -1 && positions[i - 1] - positions[i] < -1)) {
+      int8_t step = d > 0 ? 1 : -1;
+      float candidate = parabolic(i, step);
+      if (heights[i - 1] < candidate && candidate < heights[i + 1]) {
+        heights[i] = candidate;
+      } else {
+        heights[i] = linear(i, step);
+      }
+      positions[i] += step;
+    }
+  }
+}
+
+float P2Quantile::value() const {
+  if (count == 0) {
+    return 0;
+  }
+  if (count < 5) {
+    return heights[(uint8_t)(p * (count - 1) + 0.5f)];
+  }
+  return heights[2];
+}
+
+void P2Quantile::decay() {
+  if (count < 10) {
+    return;
+  }
+  count = count / 2;
+  // Scale positions to the new count, keeping markers strictly ordered
+  positions[4] = count - 1;
+  for (uint8_t i = 1; i < 4; i++) {
+    positions[i] = (uint32_t)(positions[i] / 2);
+    if (positions[i] <= positions[i - 1]) {
+      positions[i] = positions[i - 1] + 1;
+    }
+  }
+  for (uint8_t i = 3; i >= 1; i--) {
+    if (positions[i] >= positions[i + 1]) {
+      positions[i] = positions[i + 1] - 1;
+    }
+  }
+}
+
+void P2Quantile::save(P2QuantileState& state) const {
+  state.count = count;
+  for (uint8_t i = 0; i < 3; i++) {
+    state.positions[i] = count >= 5 ? (uint32_t)positions[i + 1] : 0;
+  }
+  for (uint8_t i = 0; i < 5; i++) {
+    float h = i < count ? heights[i] : 0;
+    state.heights[i] = (uint16_t)constrain(h * 16.0f + 0.5f, 0.0f, 65535.0f);
+  }
+}
+
+void P2Quantile::restore(const P2QuantileState& state) {
+  count = state.count;
+  for (uint8_t i = 0; i < 5; i++) {
+    heights[i] = state.heights[i] / 16.0f;
+  }
+  if (count >= 5) {
+    positions[0] = 0;
+    positions[4] = count - 1;
+    for (uint8_t i = 0; i < 3; i++) {
+      positions[i + 1] = state.positions[i];
+    }
+  }
+}
+
+// Where marker i should sit after count samples (0-based)
+float P2Quantile::desired(uint8_t i) const {
+  float n = count - 1;
+  switch (i) {
+    case 1:  return n * p / 2;
+    case 2:  return n * p;
+    case 3:  return n * (1 + p) / 2;
+    case 4:  return n;
+    default: return 0;
+  }
+}
+
+float P2Quantile::parabolic(uint8_t i, float d) const {
+  float nPrev = positions[i - 1], n = positions[i], nNext = positions[i + 1];
+  return heights[i] + d / (nNext - nPrev) *
+         ((n - nPrev + d) * (heights[i + 1] - heights[i]) / (nNext - n) +
+          (nNext - n - d) * (heights[i] - heights[i - 1]) / (n - nPrev));
+}
+
+float P2Quantile::linear(uint8_t i, int8_t d) const {
+  return heights[i] + d * (heights[i + d] - heights[i]) / (positions[i + d] - positions[i]);
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <Arduino.h>
+
+// Packed estimator state for NVM/retained RAM - 26 bytes
+struct P2QuantileState {
+  uint32_t count;
+  uint32_t positions[3];  // Middle marker positions (outer ones follow from count)
+  uint16_t heights[5];    // Marker heights in 1/16 ADC counts
+};
+
+// Streaming quantile estimate in constant memory (Jain & Chlamtac P²).
+// Five markers track the minimum, p/2, p, (1+p)/2 and maximum; the middle
+// marker is the estimate. Desired marker positions are a function of the
+// sample count, so only heights and three positions need persisting.
+class P2Quantile {
+public:
+  explicit P2Quantile(float p) : p(p) {}
+
+  void reset() { count = 0; }
+  void add(float x);
+  float value() const;
+  uint32_t getCount() const { return count; }
+
+  // Halve the sample weight so newer samples move the markers faster.
+  // Keeps a slow-drifting estimate (seasonal soil changes) responsive.
+  void decay();
+
+  void save(P2QuantileState& state) const;
+  void restore(const P2QuantileState& state);
+
+private:
+  const float p;
+  uint32_t count = 0;
+  float heights[5];
+  float positions[5];
+
+  float desired(uint8_t i) const;
+  float parabolic(uint8_t i, float d) const;
+  float linear(uint8_t i, int8_t d) const;
+};
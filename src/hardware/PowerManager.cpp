@@ -1,37 +1,95 @@
 #include "PowerManager.h"
+#include "../config/ConfigStore.h"
+#include "EnergyBudget.h"
+#include "../matter/IcdPolicy.h"
 #include <Arduino.h>
 
 void PowerManager::begin() {
   loadDefaultConfiguration();
+  loadStoredConfiguration();
   currentState = PowerState::Booting;
   lastState = PowerState::Booting;
+  pendingState = PowerState::Booting;
+  pendingCount = 0;
   stateChangeTime = millis();
   totalSleepTime = 0;
   sleepCycles = 0;
   sleepEventSent = false;  // Initialize sleep event tracking
 }
 
+// Battery states in order of increasing charge
+static uint8_t batteryRank(PowerState state) {
+  switch (state) {
+    case PowerState::Critical: return 0;
+    case PowerState::LowPower: return 1;
+    case PowerState::Extended: return 2;
+    case PowerState::Normal:   return 3;
+    default:                   return 0xFF;
+  }
+}
+
+PowerState PowerManager::classifyBattery(float batteryVoltage, float margin) const {
+  if (batteryVoltage < config.batteryShutdownThresh + margin) {
+    return PowerState::Critical;
+  } else if (batteryVoltage < config.batteryCriticalThresh + margin) {
+    return PowerState::LowPower;
+  } else if (batteryVoltage < config.batteryExtendedThresh + margin) {
+    return PowerState::Extended;
+  } else if (batteryVoltage >= config.batteryNormalThresh + margin) {
+    return PowerState::Normal;
+  }
+  return currentState;  // Between Extended and Normal - hold
+}
+
 void PowerManager::updatePowerState(float batteryVoltage, bool usbConnected) {
-  PowerState newState = currentState;
+  PowerState newState;
+  bool immediate = false;
   
   if (usbConnected && config.usbOverridePowerManagement) {
     newState = PowerState::UsbPowered;
-  } else if (batteryVoltage < config.batteryShutdownThresh) {
-    newState = PowerState::Critical;
-  } else if (batteryVoltage < config.batteryCriticalThresh) {
-    newState = PowerState::LowPower;
-  } else if (batteryVoltage < config.batteryExtendedThresh) {
-    newState = PowerState::Extended;
-  } else if (batteryVoltage >= config.batteryNormalThresh) {
-    newState = PowerState::Normal;
+    immediate = true;
+  } else {
+    newState = classifyBattery(batteryVoltage, 0);
+    // Stepping back up needs the voltage clear of the threshold by a margin
+    uint8_t currentRank = batteryRank(currentState);
+    if (currentRank != 0xFF && batteryRank(newState) > currentRank) {
+      newState = classifyBattery(batteryVoltage, kPowerStateHysteresisV);
+      if (batteryRank(newState) < currentRank) {
+        newState = currentState;
+      }
+    }
+    // Leaving Booting or USB takes the first battery reading as-is
+    immediate = (currentState == PowerState::Booting || currentState == PowerState::UsbPowered);
   }
   
-  if (newState != currentState) {
+  if (newState == currentState) {
+    pendingCount = 0;
+  } else if (immediate || (newState == pendingState && ++pendingCount >= kPowerStateDwellSamples)) {
+    pendingCount = 0;
     lastState = currentState;
     currentState = newState;
     stateChangeTime = millis();
     // Clear sleep event flag when power state changes
     sleepEventSent = false;
+  } else if (newState != pendingState) {
+    // A new state must hold for the dwell count before it is taken
+    pendingState = newState;
+    pendingCount = 1;
+  }
+  
+  // The budgeted interval can move without a state change
+  applyIcdPolicy();
+}
+
+void PowerManager::applyIcdPolicy() {
+  if (icdBackend) {
+    icdBackend->configure(deriveIcdParameters(getCurrentSleepInterval(), currentState));
+  }
+}
+
+void PowerManager::onMeasurementWake(uint32_t now) {
+  if (icdBackend) {
+    icdBackend->onMeasurementWake(now);
   }
 }
 
@@ -40,15 +98,22 @@ uint32_t PowerManager::getCurrentSleepInterval() const {
     return 0; // No sleep when power management disabled
   }
   
+  // Lifetime budget stretches the voltage-stepped intervals on battery -
+  // it never samples faster than the interval configured for the state
+  bool budgeted = kEnergyBudgetEnabled && energyBudget && energyBudget->hasEstimate();
+  
   switch (currentState) {
     case PowerState::UsbPowered:
       return config.usbSleepInterval;
     case PowerState::Normal:
-      return config.normalSleepInterval;
+      return budgeted ? max(energyBudget->getInterval(), config.normalSleepInterval)
+                      : config.normalSleepInterval;
     case PowerState::Extended:
-      return config.extendedSleepInterval;
+      return budgeted ? max(energyBudget->getInterval(), config.extendedSleepInterval)
+                      : config.extendedSleepInterval;
     case PowerState::LowPower:
-      return config.lowPowerSleepInterval;
+      return budgeted ? max(energyBudget->getInterval(), config.lowPowerSleepInterval)
+                      : config.lowPowerSleepInterval;
     case PowerState::Critical:
       return config.maxSleepInterval; // Maximum conservation
     case PowerState::Booting:
@@ -60,38 +125,47 @@ uint32_t PowerManager::getCurrentSleepInterval() const {
 void PowerManager::setConfiguration(const PowerConfiguration& newConfig) {
   config = newConfig;
   validateConfiguration();
+  persistConfiguration();
 }
 
 void PowerManager::setNormalSleepInterval(uint32_t interval) {
   config.normalSleepInterval = constrainSleepInterval(interval);
+  persistConfiguration();
 }
 
 void PowerManager::setExtendedSleepInterval(uint32_t interval) {
   config.extendedSleepInterval = constrainSleepInterval(interval);
+  persistConfiguration();
 }
 
 void PowerManager::setLowPowerSleepInterval(uint32_t interval) {
   config.lowPowerSleepInterval = constrainSleepInterval(interval);
+  persistConfiguration();
 }
 
 void PowerManager::setUsbSleepInterval(uint32_t interval) {
   config.usbSleepInterval = constrainSleepInterval(interval);
+  persistConfiguration();
 }
 
 void PowerManager::setBatteryNormalThresh(float thresh) {
   config.batteryNormalThresh = constrain(thresh, 2.5, 4.5);
+  persistConfiguration();
 }
 
 void PowerManager::setBatteryExtendedThresh(float thresh) {
   config.batteryExtendedThresh = constrain(thresh, 2.5, 4.5);
+  persistConfiguration();
 }
 
 void PowerManager::setBatteryCriticalThresh(float thresh) {
   config.batteryCriticalThresh = constrain(thresh, 2.5, 4.5);
+  persistConfiguration();
 }
 
 void PowerManager::setBatteryShutdownThresh(float thresh) {
   config.batteryShutdownThresh = constrain(thresh, 2.0, 4.0);
+  persistConfiguration();
 }
 
 bool PowerManager::shouldEnterSleep() const {
@@ -145,6 +219,54 @@ void PowerManager::loadDefaultConfiguration() {
   config.enablePowerManagement = kEnablePowerManagement;
 }
 
+void PowerManager::loadStoredConfiguration() {
+  if (!configStore) {
+    return;
+  }
+  config.normalSleepInterval = configStore->getU32(ConfigKey::NormalSleepInterval);
+  config.extendedSleepInterval = configStore->getU32(ConfigKey::ExtendedSleepInterval);
+  config.lowPowerSleepInterval = configStore->getU32(ConfigKey::LowPowerSleepInterval);
+  config.usbSleepInterval = configStore->getU32(ConfigKey::UsbSleepInterval);
+  config.maxSleepInterval = configStore->getU32(ConfigKey::MaxSleepInterval);
+  config.minSleepInterval = configStore->getU32(ConfigKey::MinSleepInterval);
+  
+  config.batteryNormalThresh = configStore->getFloat(ConfigKey::BatteryNormalThresh);
+  config.batteryExtendedThresh = configStore->getFloat(ConfigKey::BatteryExtendedThresh);
+  config.batteryCriticalThresh = configStore->getFloat(ConfigKey::BatteryCriticalThresh);
+  config.batteryShutdownThresh = configStore->getFloat(ConfigKey::BatteryShutdownThresh);
+  
+  uint32_t flags = configStore->getU32(ConfigKey::PowerFlags);
+  config.allowRemoteWakeup = flags & CONFIG_FLAG_ALLOW_REMOTE_WAKEUP;
+  config.usbOverridePowerManagement = flags & CONFIG_FLAG_USB_OVERRIDE;
+  config.enablePowerManagement = flags & CONFIG_FLAG_POWER_MANAGEMENT;
+  
+  // Clamp in case the limits changed since the values were stored
+  validateConfiguration();
+}
+
+void PowerManager::persistConfiguration() {
+  if (!configStore) {
+    return;
+  }
+  // The store ignores unchanged keys, so only edited settings cost a write
+  configStore->setU32(ConfigKey::NormalSleepInterval, config.normalSleepInterval);
+  configStore->setU32(ConfigKey::ExtendedSleepInterval, config.extendedSleepInterval);
+  configStore->setU32(ConfigKey::LowPowerSleepInterval, config.lowPowerSleepInterval);
+  configStore->setU32(ConfigKey::UsbSleepInterval, config.usbSleepInterval);
+  configStore->setU32(ConfigKey::MaxSleepInterval, config.maxSleepInterval);
+  configStore->setU32(ConfigKey::MinSleepInterval, config.minSleepInterval);
+  
+  configStore->setFloat(ConfigKey::BatteryNormalThresh, config.batteryNormalThresh);
+  configStore->setFloat(ConfigKey::BatteryExtendedThresh, config.batteryExtendedThresh);
+  configStore->setFloat(ConfigKey::BatteryCriticalThresh, config.batteryCriticalThresh);
+  configStore->setFloat(ConfigKey::BatteryShutdownThresh, config.batteryShutdownThresh);
+  
+  configStore->setU32(ConfigKey::PowerFlags,
+                      (config.allowRemoteWakeup ? CONFIG_FLAG_ALLOW_REMOTE_WAKEUP : 0) |
+                      (config.usbOverridePowerManagement ? CONFIG_FLAG_USB_OVERRIDE : 0) |
+                      (config.enablePowerManagement ? CONFIG_FLAG_POWER_MANAGEMENT : 0));
+}
+
 void PowerManager::validateConfiguration() {
   // Ensure thresholds are in logical order
   if (config.batteryShutdownThresh >= config.batteryCriticalThresh) {
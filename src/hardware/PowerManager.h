@@ -31,8 +31,21 @@ struct PowerConfiguration {
   bool enablePowerManagement;
 };
 
+class ConfigStore;
+class EnergyBudget;
+class IcdBackend;
+
 class PowerManager {
 public:
+  // Tuned configuration is loaded from and written back to the store
+  void setConfigStore(ConfigStore* store) { configStore = store; }
+  // Normal/Extended intervals come from the budget once it has an estimate
+  void setEnergyBudget(EnergyBudget* budget) { energyBudget = budget; }
+  EnergyBudget* getEnergyBudget() const { return energyBudget; }
+  // Radio poll/ICD parameters follow the current interval
+  void setIcdBackend(IcdBackend* backend) { icdBackend = backend; }
+  IcdBackend* getIcdBackend() const { return icdBackend; }
+  void onMeasurementWake(uint32_t now);
   void begin();
   
   // State management
@@ -83,16 +96,25 @@ public:
   
 private:
   PowerConfiguration config;
+  ConfigStore* configStore = nullptr;
+  EnergyBudget* energyBudget = nullptr;
+  IcdBackend* icdBackend = nullptr;
   PowerState currentState;
   PowerState lastState;
   uint32_t stateChangeTime;
+  PowerState pendingState;   // Candidate state waiting out its dwell
+  uint8_t pendingCount;
   uint32_t totalSleepTime;
   uint32_t sleepCycles;
   
   // Sleep event tracking to prevent flooding
   mutable bool sleepEventSent;
   
+  PowerState classifyBattery(float batteryVoltage, float margin) const;
+  void applyIcdPolicy();
   void loadDefaultConfiguration();
+  void loadStoredConfiguration();
+  void persistConfiguration();
   void validateConfiguration();
   uint32_t constrainSleepInterval(uint32_t interval) const;
 };
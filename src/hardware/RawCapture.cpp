@@ -0,0 +1,66 @@
+#include "RawCapture.h"
+#include <Arduino.h>
+#include <math.h>
+
+bool RawCapture::capture(uint8_t pin, uint16_t count, uint32_t rateHz) {
+  if (count < 2 || count > kRawCaptureMaxSamples || rateHz == 0 || rateHz > kRawCaptureMaxRateHz) {
+    return false;
+  }
+  this->count = 0;
+  requestedRateHz = rateHz;
+  overruns = 0;
+  minRaw = UINT16_MAX;
+  maxRaw = 0;
+  sum = 0;
+  sumSquares = 0;
+
+  const uint32_t periodUs = 1000000UL / rateHz;
+  uint32_t start = micros();
+  uint32_t firstUs = start;
+  uint32_t lastUs = start;
+  for (uint16_t i = 0; i < count; i++) {
+    // Slots are fixed from the start, so one late conversion doesn't shift the rest
+    uint32_t due = start + (uint32_t)i * periodUs;
+    while ((int32_t)(micros() - due) < 0) {
+    }
+    uint32_t at = micros();
+    if (at - due >= periodUs) {
+      overruns++;
+    }
+    uint16_t raw = analogRead(pin);
+    if (i == 0) {
+      firstUs = at;
+    }
+    lastUs = at;
+
+    samples[i] = raw;
+    sum += raw;
+    sumSquares += (uint32_t)raw * raw;
+    minRaw = min(minRaw, raw);
+    maxRaw = max(maxRaw, raw);
+  }
+  this->count = count;
+  elapsedUs = lastUs - firstUs;
+  return true;
+}
+
+float RawCapture::getAchievedRateHz() const {
+  if (count < 2 || elapsedUs == 0) {
+    return 0;
+  }
+  return (count - 1) * 1000000.0f / elapsedUs;
+}
+
+float RawCapture::getMean() const {
+  return count ? (float)sum / count : 0;
+}
+
+float RawCapture::getStdDev() const {
+  if (count < 2) {
+    return 0;
+  }
+  // Integer sums keep the variance exact until this one division
+  double mean = (double)sum / count;
+  double variance = (double)sumSquares / count - mean * mean;
+  return variance > 0 ? (float)sqrt(variance) : 0;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "../config/Config.h"
+
+// Bench capture of one probe's raw ADC output at a fixed rate, for noise
+// and settle-time characterisation (serial "capture"). Samples go into a
+// fixed buffer and are streamed out afterwards, so USB never paces the
+// ADC. Conversions are paced on micros() with interrupts left on; one that
+// starts a whole period late counts as an overrun, and the achieved rate
+// is measured between the first and last conversion.
+class RawCapture {
+public:
+  // Blocks for count / rateHz seconds; false if the arguments are out of range
+  bool capture(uint8_t pin, uint16_t count, uint32_t rateHz);
+
+  uint16_t getCount() const { return count; }
+  uint16_t getSample(uint16_t index) const { return samples[index]; }
+  uint32_t getRequestedRateHz() const { return requestedRateHz; }
+  float getAchievedRateHz() const;
+  uint16_t getOverruns() const { return overruns; }
+
+  // Statistics over the whole capture
+  uint16_t getMin() const { return minRaw; }
+  uint16_t getMax() const { return maxRaw; }
+  float getMean() const;
+  float getStdDev() const;
+
+private:
+  uint16_t samples[kRawCaptureMaxSamples];
+  uint16_t count = 0;
+  uint32_t requestedRateHz = 0;
+  uint32_t elapsedUs = 0;  // First to last conversion
+  uint16_t overruns = 0;
+  uint16_t minRaw = 0;
+  uint16_t maxRaw = 0;
+  uint32_t sum = 0;
+  uint64_t sumSquares = 0;
+};
@@ -0,0 +1,55 @@
+#include "SensorFaultDetector.h"
+
+SensorFault SensorFaultDetector::update(uint16_t raw, uint16_t spread) {
+  const uint16_t adcMax = (uint16_t)kAdcReference;
+
+  // Run counters - each resets as soon as its signature disappears
+  if (raw <= kFaultRailMargin) bump(railLowRun); else railLowRun = 0;
+  if (raw >= adcMax - kFaultRailMargin) bump(railHighRun); else railHighRun = 0;
+  if (spread >= kFaultNoiseSpread) bump(noisyRun); else noisyRun = 0;
+  if (haveLast && raw == lastRaw) {
+    if (flatRun != UINT16_MAX) flatRun++;
+  } else {
+    flatRun = 0;
+  }
+  bool stepped = haveLast && raw > lastRaw + kFaultMaxDryingStep;
+
+  SensorFault detected = SensorFault::None;
+  if (railLowRun >= kFaultConfirmSamples) {
+    detected = SensorFault::RailLow;
+  } else if (railHighRun >= kFaultConfirmSamples) {
+    detected = SensorFault::RailHigh;
+  } else if (noisyRun >= kFaultConfirmSamples) {
+    detected = SensorFault::FloatingInput;
+  } else if (flatRun >= kFaultFlatSamples) {
+    detected = SensorFault::FlatLine;
+  }
+
+  if (detected != SensorFault::None) {
+    fault = detected;
+    goodRun = 0;
+  } else if (fault == SensorFault::ImpossibleStep) {
+    // Clear when the probe is back near its old level, or give up and
+    // accept the new level as real after kFaultStepHoldSamples
+    if (raw <= stepReference + kFaultMaxDryingStep / 2 || ++stepHold >= kFaultStepHoldSamples) {
+      fault = SensorFault::None;
+    }
+  } else if (fault != SensorFault::None) {
+    bump(goodRun);
+    if (goodRun >= kFaultClearSamples) {
+      fault = SensorFault::None;
+    }
+  } else if (stepped) {
+    fault = SensorFault::ImpossibleStep;
+    stepReference = lastRaw;
+    stepHold = 0;
+  }
+
+  lastRaw = raw;
+  haveLast = true;
+  return fault;
+}
+
+void SensorFaultDetector::reset() {
+  *this = SensorFaultDetector();
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "../config/Config.h"
+
+// Fault codes double as the cluster's errorCode values, with the probe
+// index in the top two bits (GreenThreadSoilSensorCluster::probeErrorCode)
+enum class SensorFault : uint8_t {
+  None = 0,
+  RailLow = 0x10,         // Output stuck at ground - probe unplugged or shorted
+  RailHigh = 0x11,        // Output stuck at the supply rail
+  FlatLine = 0x12,        // No variation at all over kFaultFlatSamples readings
+  ImpossibleStep = 0x13,  // Dried faster than soil can - probe pulled out
+  FloatingInput = 0x14    // Burst-to-burst noise of an unconnected ADC pin
+};
+
+// Constant-memory checks on the raw moisture stream. Each reading updates a
+// handful of run counters; a fault is raised after kFaultConfirmSamples
+// consecutive bad readings and cleared after kFaultClearSamples good ones.
+// Soil wets quickly when watered but dries slowly, so only a large jump
+// towards dry counts as an impossible step.
+class SensorFaultDetector {
+public:
+  // raw = averaged reading, spread = max - min within the burst
+  SensorFault update(uint16_t raw, uint16_t spread);
+  void reset();
+
+  SensorFault getFault() const { return fault; }
+  bool isFaulted() const { return fault != SensorFault::None; }
+  bool isDisconnected() const {
+    return fault == SensorFault::RailLow || fault == SensorFault::FloatingInput;
+  }
+
+private:
+  SensorFault fault = SensorFault::None;
+  uint16_t lastRaw = 0;
+  bool haveLast = false;
+
+  uint8_t railLowRun = 0;
+  uint8_t railHighRun = 0;
+  uint8_t noisyRun = 0;
+  uint8_t goodRun = 0;
+  uint16_t flatRun = 0;
+  uint16_t stepReference = 0;  // Reading before the step
+  uint16_t stepHold = 0;
+
+  static void bump(uint8_t& run) { if (run != UINT8_MAX) run++; }
+};
@@ -1,54 +1,117 @@
 #include "SensorManager.h"
 #include <Arduino.h>
 
+// MCU die temperature - the EMU samples it in hardware every 250 ms
+#if defined(ARDUINO_ARCH_SILABS) && __has_include(<em_emu.h>)
+#include <em_emu.h>
+#define SENSOR_DIE_TEMPERATURE 1
+#else
+#define SENSOR_DIE_TEMPERATURE 0
+#endif
+
 void SensorManager::begin() {
-  pinMode(kMoisturePin, INPUT);
-  calibrationManager.begin();
+  for (uint8_t probe = 0; probe < kMoistureProbeCount; probe++) {
+    pinMode(kMoisturePins[probe], INPUT);
+  }
 }
 
-float SensorManager::readMoisture() {
-  int raw = analogRead(kMoisturePin);
-  int dryValue, wetValue;
-  calibrationManager.getMoistureCalibration(dryValue, wetValue);
+void SensorManager::scan() {
+  // Short burst per probe: the average is the reading, the spread exposes a
+  // floating pin. Probes are read round-robin so each burst spans the scan.
+  uint16_t minRaw[kMaxMoistureProbes], maxRaw[kMaxMoistureProbes];
+  uint32_t sum[kMaxMoistureProbes] = {};
+  for (uint8_t probe = 0; probe < kMoistureProbeCount; probe++) {
+    minRaw[probe] = UINT16_MAX;
+    maxRaw[probe] = 0;
+  }
+  for (uint8_t i = 0; i < kMoistureBurstSamples; i++) {
+    for (uint8_t probe = 0; probe < kMoistureProbeCount; probe++) {
+      uint16_t sample = analogRead(kMoisturePins[probe]);
+      sum[probe] += sample;
+      minRaw[probe] = min(minRaw[probe], sample);
+      maxRaw[probe] = max(maxRaw[probe], sample);
+    }
+  }
+  
+  // Taken with the bursts so the correction matches the readings
+  hasScanTemperature = temperatureCompensator && temperatureCompensator->getMode() != TempCompMode::Off &&
+                       readTemperature(scanTemperatureCentiC);
   
-  float percent = constrain(map(raw, dryValue, wetValue, 0, 100), 0, 100);
+  for (uint8_t probe = 0; probe < kMoistureProbeCount; probe++) {
+    Probe& p = probes[probe];
+    int raw = (sum[probe] + kMoistureBurstSamples / 2) / kMoistureBurstSamples;
+    p.lastRaw = raw;
+    p.faultDetector.update(raw, maxRaw[probe] - minRaw[probe]);
+    p.compensatedRaw = raw;
+    if (hasScanTemperature) {
+      if (!p.faultDetector.isFaulted()) {
+        temperatureCompensator->learn(probe, raw, scanTemperatureCentiC, millis());
+      }
+      p.compensatedRaw = temperatureCompensator->compensate(probe, raw, scanTemperatureCentiC);
+    }
+    int dryValue, wetValue;
+    getCalibration(probe, dryValue, wetValue);
+    p.moisture = constrain(map(p.compensatedRaw, dryValue, wetValue, 0, 100), 0, 100);
+  }
   
-  updateStatistics(percent);
-  return percent;
+  updateStatistics(probes[0].moisture);
+  scanCount++;
+}
+
+float SensorManager::readMoisture() {
+  scan();
+  return probes[0].moisture;
 }
 
 void SensorManager::setCalibration(int dryValue, int wetValue) {
-  calibrationManager.setMoistureCalibration(dryValue, wetValue);
-  calibrationManager.saveCalibration();
+  setCalibration(0, dryValue, wetValue);
 }
 
 void SensorManager::getCalibration(int& dryValue, int& wetValue) const {
-  calibrationManager.getMoistureCalibration(dryValue, wetValue);
+  getCalibration(0, dryValue, wetValue);
+}
+
+void SensorManager::setCalibration(uint8_t probe, int dryValue, int wetValue) {
+  if (calibrationManager) {
+    calibrationManager->setMoistureCalibration(probe, dryValue, wetValue);
+    calibrationManager->saveCalibration();
+  }
+}
+
+void SensorManager::getCalibration(uint8_t probe, int& dryValue, int& wetValue) const {
+  if (calibrationManager) {
+    calibrationManager->getMoistureCalibration(probe, dryValue, wetValue);
+  } else {
+    dryValue = kDefaultMoistureDry;
+    wetValue = kDefaultMoistureWet;
+  }
 }
 
 void SensorManager::startCalibration() {
-  calibrationManager.startCalibration();
+  if (calibrationManager) calibrationManager->startCalibration();
 }
 
 bool SensorManager::isCalibrating() const {
-  return calibrationManager.isCalibrating();
+  return calibrationManager && calibrationManager->isCalibrating();
 }
 
 void SensorManager::calibrateDry() {
-  calibrationManager.calibrateDry();
+  if (calibrationManager) calibrationManager->calibrateDry();
 }
 
 void SensorManager::calibrateWet() {
-  calibrationManager.calibrateWet();
+  if (calibrationManager) calibrationManager->calibrateWet();
 }
 
 void SensorManager::finishCalibration() {
-  calibrationManager.finishCalibration();
+  if (calibrationManager) calibrationManager->finishCalibration();
 }
 
 void SensorManager::resetCalibration() {
-  calibrationManager.resetToDefaults();
-  calibrationManager.saveCalibration();
+  if (calibrationManager) {
+    calibrationManager->resetToDefaults();
+    calibrationManager->saveCalibration();
+  }
 }
 
 void SensorManager::resetStatistics() {
@@ -56,6 +119,20 @@ void SensorManager::resetStatistics() {
   maxMoisture = 0.0;
 }
 
+bool SensorManager::readTemperature(int16_t& centiC) const {
+  // The soil probe sits at the capacitor; the die only follows the enclosure
+  if (hasSoilTemperature) {
+    centiC = soilTemperatureCentiC;
+    return true;
+  }
+#if SENSOR_DIE_TEMPERATURE
+  centiC = (int16_t)lroundf(EMU_TemperatureGet() * 100.0f);
+  return true;
+#else
+  return false;
+#endif
+}
+
 void SensorManager::updateStatistics(float moisture) {
   minMoisture = min(minMoisture, moisture);
   maxMoisture = max(maxMoisture, moisture);
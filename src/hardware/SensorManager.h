@@ -1,15 +1,53 @@
 #pragma once
 #include "../config/Config.h"
 #include "CalibrationManager.h"
+#include "SensorFaultDetector.h"
+#include "TemperatureCompensator.h"
 
+// Reads the kMoistureProbeCount probes on kMoisturePins. One scan samples
+// every probe, interleaving the bursts so the whole set shares one wake;
+// each probe keeps its own calibration and fault detector. Single-probe
+// accessors default to probe 0.
+//
+// With a TemperatureCompensator set, each reading is corrected to the
+// reference temperature before calibration maps it to percent. The soil
+// probe's temperature is used once the sketch has fed one, the MCU die
+// sensor otherwise.
 class SensorManager {
 public:
   void begin();
-  float readMoisture();
+  void scan();                                   // Sample every fitted probe
+  float readMoisture();                          // scan(), then probe 0
+  uint32_t getScanCount() const { return scanCount; }  // Scans since boot; readers refresh when it moves
+  uint8_t getProbeCount() const { return kMoistureProbeCount; }
+  float getMoisture(uint8_t probe) const { return probes[probe].moisture; }
+  uint16_t getLastRaw(uint8_t probe = 0) const { return probes[probe].lastRaw; }  // ADC value behind the last reading
+  uint16_t getCompensatedRaw(uint8_t probe = 0) const { return probes[probe].compensatedRaw; }  // Same, at the reference temperature
+  
+  // Probe health - readings taken while faulted must not be reported
+  SensorFault getFault(uint8_t probe = 0) const { return probes[probe].faultDetector.getFault(); }
+  bool isFaulted(uint8_t probe = 0) const { return probes[probe].faultDetector.isFaulted(); }
+  bool isDisconnected(uint8_t probe = 0) const { return probes[probe].faultDetector.isDisconnected(); }
+  
+  // Shares the sketch's calibration store - one journal writer per region
+  void setCalibrationManager(CalibrationManager* manager) { calibrationManager = manager; }
+  void setTemperatureCompensator(TemperatureCompensator* compensator) { temperatureCompensator = compensator; }
+  // Latest soil probe temperature; the last one fed is held through a missed reading
+  void setSoilTemperature(int16_t centiC) {
+    soilTemperatureCentiC = centiC;
+    hasSoilTemperature = true;
+  }
+  // Temperature behind the last scan; false when none was available
+  bool getTemperature(int16_t& centiC) const {
+    centiC = scanTemperatureCentiC;
+    return hasScanTemperature;
+  }
   
   // Calibration methods
   void setCalibration(int dryValue, int wetValue);
   void getCalibration(int& dryValue, int& wetValue) const;
+  void setCalibration(uint8_t probe, int dryValue, int wetValue);
+  void getCalibration(uint8_t probe, int& dryValue, int& wetValue) const;
   
   // Calibration process
   void startCalibration();
@@ -19,15 +57,30 @@ public:
   void finishCalibration();
   void resetCalibration();
   
-  // Statistics (optional for future use)
+  // Statistics for probe 0 (optional for future use)
   float getMinMoisture() const { return minMoisture; }
   float getMaxMoisture() const { return maxMoisture; }
   void resetStatistics();
 
 private:
-  CalibrationManager calibrationManager;
+  struct Probe {
+    uint16_t lastRaw = 0;
+    uint16_t compensatedRaw = 0;
+    float moisture = 0;
+    SensorFaultDetector faultDetector;
+  };
+  
+  CalibrationManager* calibrationManager = nullptr;
+  TemperatureCompensator* temperatureCompensator = nullptr;
+  bool hasSoilTemperature = false;
+  int16_t soilTemperatureCentiC = 0;
+  bool hasScanTemperature = false;
+  int16_t scanTemperatureCentiC = 0;
+  Probe probes[kMaxMoistureProbes];
+  uint32_t scanCount = 0;
   float minMoisture = 100.0;
   float maxMoisture = 0.0;
   
   void updateStatistics(float moisture);
+  bool readTemperature(int16_t& centiC) const;
 };
@@ -0,0 +1,91 @@
+#include "StateOfCharge.h"
+
+// One point of a per-cell open-circuit discharge curve, in descending volts
+struct SocPoint {
+  uint16_t millivolts;
+  uint8_t percent;
+};
+
+static const SocPoint ALKALINE_CURVE[] PROGMEM = {
+  { 1600, 100 }, { 1500, 90 }, { 1400, 70 }, { 1300, 45 }, { 1250, 30 },
+  { 1200, 20 }, { 1150, 12 }, { 1100, 7 }, { 1000, 2 }, { 900, 0 }
+};
+
+static const SocPoint LIION_CURVE[] PROGMEM = {
+  { 4200, 100 }, { 4100, 90 }, { 4000, 80 }, { 3900, 68 }, { 3800, 55 },
+  { 3700, 40 }, { 3600, 22 }, { 3500, 10 }, { 3400, 5 }, { 3300, 2 }, { 3000, 0 }
+};
+
+static const SocPoint LIFEPO4_CURVE[] PROGMEM = {
+  { 3600, 100 }, { 3400, 99 }, { 3350, 90 }, { 3320, 70 }, { 3300, 50 },
+  { 3270, 30 }, { 3200, 17 }, { 3100, 9 }, { 3000, 5 }, { 2800, 2 }, { 2500, 0 }
+};
+
+struct ChemistryProfile {
+  const SocPoint* curve;
+  uint8_t points;
+  uint16_t cellResistanceMilliohm;  // Typical internal resistance
+};
+
+static const ChemistryProfile PROFILES[] = {
+  { ALKALINE_CURVE, sizeof(ALKALINE_CURVE) / sizeof(SocPoint), 150 },
+  { LIION_CURVE, sizeof(LIION_CURVE) / sizeof(SocPoint), 80 },
+  { LIFEPO4_CURVE, sizeof(LIFEPO4_CURVE) / sizeof(SocPoint), 40 }
+};
+
+void StateOfChargeEstimator::setChemistry(BatteryChemistry newChemistry, uint8_t newCells) {
+  chemistry = newChemistry;
+  cells = newCells ? newCells : 1;
+  reset();
+}
+
+uint8_t StateOfChargeEstimator::update(float voltage, uint32_t loadUa) {
+  if (voltage <= 0) {
+    return percent;  // No battery - keep the last estimate
+  }
+
+  // V_rest = V_load + I * R_pack (uA * mOhm = nV)
+  const ChemistryProfile& profile = PROFILES[(uint8_t)chemistry];
+  float compensated = voltage + (float)loadUa * profile.cellResistanceMilliohm * cells * 1e-9f;
+
+  if (restingVoltage <= 0) {
+    restingVoltage = compensated;  // Seeded from a real sample, never smoothed up from zero
+  } else {
+    restingVoltage += kSocVoltageSmoothing * (compensated - restingVoltage);
+  }
+
+  percent = percentFromCurve((uint16_t)(restingVoltage * 1000.0f / cells));
+  return percent;
+}
+
+uint8_t StateOfChargeEstimator::percentFromCurve(uint16_t cellMillivolts) const {
+  const ChemistryProfile& profile = PROFILES[(uint8_t)chemistry];
+
+  SocPoint upper;
+  memcpy_P(&upper, &profile.curve[0], sizeof(SocPoint));
+  if (cellMillivolts >= upper.millivolts) {
+    return upper.percent;
+  }
+
+  // Linear interpolation between the two points around the voltage
+  for (uint8_t i = 1; i < profile.points; i++) {
+    SocPoint lower;
+    memcpy_P(&lower, &profile.curve[i], sizeof(SocPoint));
+    if (cellMillivolts >= lower.millivolts) {
+      uint32_t span = upper.millivolts - lower.millivolts;
+      uint32_t offset = cellMillivolts - lower.millivolts;
+      return lower.percent + (uint8_t)((offset * (upper.percent - lower.percent) + span / 2) / span);
+    }
+    upper = lower;
+  }
+  return 0;
+}
+
+const char* StateOfChargeEstimator::chemistryName(BatteryChemistry chemistry) {
+  switch (chemistry) {
+    case BatteryChemistry::Alkaline: return PSTR("Alkaline");
+    case BatteryChemistry::LiIon:    return PSTR("Li-ion");
+    case BatteryChemistry::LiFePO4:  return PSTR("LiFePO4");
+    default:                         return PSTR("Unknown");
+  }
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "../config/Config.h"
+
+enum class BatteryChemistry : uint8_t {
+  Alkaline = 0,
+  LiIon = 1,
+  LiFePO4 = 2
+};
+
+// Voltage-to-charge estimator. Each sample is corrected for the I*R sag
+// of the load present while it was taken, smoothed, and mapped through the
+// chemistry's per-cell discharge curve. A flat LiFePO4 plateau or an
+// alkaline pack recovering after TX no longer reads as a jump in charge.
+class StateOfChargeEstimator {
+public:
+  void setChemistry(BatteryChemistry chemistry, uint8_t cells);
+  BatteryChemistry getChemistry() const { return chemistry; }
+
+  // Feed one pack voltage taken under loadUa; returns percent
+  uint8_t update(float voltage, uint32_t loadUa);
+  void reset() { restingVoltage = 0; percent = 0; }
+
+  uint8_t getPercent() const { return percent; }
+  float getRestingVoltage() const { return restingVoltage; }  // Load-compensated, smoothed
+  bool hasEstimate() const { return restingVoltage > 0; }
+
+  static const char* chemistryName(BatteryChemistry chemistry);  // PROGMEM string
+
+private:
+  BatteryChemistry chemistry = (BatteryChemistry)kBatteryChemistry;
+  uint8_t cells = kBatteryCells;
+  float restingVoltage = 0;
+  uint8_t percent = 0;
+
+  uint8_t percentFromCurve(uint16_t cellMillivolts) const;
+};
@@ -0,0 +1,149 @@
+#include "TemperatureCompensator.h"
+#include "../config/ConfigStore.h"
+
+namespace {
+  constexpr int32_t kCentiQ8 = 100 * 256;  // Q8 counts/degC to counts/centi-degC
+
+  // Rounded division, half away from zero; denominator positive
+  int64_t divideRounded(int64_t numerator, int64_t denominator) {
+    return numerator >= 0 ? (numerator + denominator / 2) / denominator
+                          : -((-numerator + denominator / 2) / denominator);
+  }
+
+  // Coefficients are stored two probes to a key, probe 0 and 2 in the low half
+  ConfigKey coefficientKey(bool learned, uint8_t probe) {
+    if (learned) {
+      return probe < 2 ? ConfigKey::TempCompLearned01 : ConfigKey::TempCompLearned23;
+    }
+    return probe < 2 ? ConfigKey::TempCompConfigured01 : ConfigKey::TempCompConfigured23;
+  }
+
+  uint8_t halfShift(uint8_t probe) { return (probe & 1) * 16; }
+}
+
+void TemperatureCompensator::begin(ConfigStore* store, bool soilProbePresent) {
+  configStore = store;
+  uint32_t storedMode = store ? store->getU32(ConfigKey::TempCompMode) : CONFIG_TEMPCOMP_MODE_AUTO;
+  if (storedMode != CONFIG_TEMPCOMP_MODE_AUTO) {
+    mode = static_cast<TempCompMode>(storedMode);
+  } else {
+    mode = soilProbePresent ? static_cast<TempCompMode>(kTempCompDefaultMode) : TempCompMode::Off;
+  }
+  for (uint8_t probe = 0; probe < kMaxMoistureProbes; probe++) {
+    Probe& p = probes[probe];
+    p = Probe();
+    p.configuredQ8 = kTempCompCoeffQ8[probe];
+    if (store) {
+      p.configuredQ8 = (int16_t)(store->getU32(coefficientKey(false, probe)) >> halfShift(probe));
+      p.storedQ8 = (int16_t)(store->getU32(coefficientKey(true, probe)) >> halfShift(probe));
+    }
+  }
+}
+
+void TemperatureCompensator::setMode(TempCompMode newMode) {
+  mode = newMode;
+  if (configStore) {
+    configStore->setU32(ConfigKey::TempCompMode, static_cast<uint32_t>(newMode));
+  }
+}
+
+void TemperatureCompensator::store(bool learned, uint8_t probe, int16_t coefficientQ8) {
+  if (!configStore) {
+    return;
+  }
+  ConfigKey key = coefficientKey(learned, probe);
+  uint8_t shift = halfShift(probe);
+  uint32_t word = configStore->getU32(key) & ~(0xFFFFul << shift);
+  configStore->setU32(key, word | ((uint32_t)(uint16_t)coefficientQ8 << shift));
+}
+
+uint16_t TemperatureCompensator::compensate(uint8_t probe, uint16_t raw, int16_t temperatureCentiC) const {
+  int32_t coefficient = getCoefficient(probe);
+  if (coefficient == 0) {
+    return raw;
+  }
+  int32_t delta = (int32_t)temperatureCentiC - kTempCompReferenceCentiC;
+  int32_t corrected = (int32_t)raw - (int32_t)divideRounded((int64_t)coefficient * delta, kCentiQ8);
+  return (uint16_t)constrain(corrected, 0L, (long)kAdcReference);
+}
+
+void TemperatureCompensator::learn(uint8_t probe, uint16_t raw, int16_t temperatureCentiC, uint32_t nowMs) {
+  if (mode == TempCompMode::Off) {
+    return;
+  }
+  Probe& p = probes[probe];
+  if (p.hasPoint && (uint32_t)(nowMs - p.lastMs) < kTempCompLearnIntervalMs) {
+    return;
+  }
+
+  if (p.hasPoint) {
+    int32_t rawStep = (int32_t)raw - p.lastRaw;
+    int32_t temperatureStep = (int32_t)temperatureCentiC - p.lastTemperature;
+    if (abs(rawStep) <= kTempCompMaxStep) {
+      p.sumXY -= p.sumXY >> kTempCompLearnDecayShift;
+      p.sumXX -= p.sumXX >> kTempCompLearnDecayShift;
+      p.sumXY += (int64_t)temperatureStep * rawStep;
+      p.sumXX += (int64_t)temperatureStep * temperatureStep;
+      if (p.pairs == 0) {
+        p.firstMs = nowMs;
+      }
+      if (p.pairs < UINT16_MAX) {
+        p.pairs++;
+      }
+      p.spanMs = nowMs - p.firstMs;
+      if (p.sumXX > 0) {
+        int64_t fit = divideRounded(p.sumXY * kCentiQ8, p.sumXX);
+        p.learnedQ8 = (int16_t)constrain(fit, (int64_t)-kTempCompMaxCoeffQ8, (int64_t)kTempCompMaxCoeffQ8);
+      }
+      // Persist a trusted fit, but not every wobble of it - the store is flash
+      if (isLearned(probe) && (p.storedQ8 == NO_COEFFICIENT || abs(p.learnedQ8 - p.storedQ8) >= kTempCompSaveStepQ8)) {
+        p.storedQ8 = p.learnedQ8;
+        store(true, probe, p.storedQ8);
+      }
+    }
+  }
+  p.hasPoint = true;
+  p.lastRaw = raw;
+  p.lastTemperature = temperatureCentiC;
+  p.lastMs = nowMs;
+}
+
+int16_t TemperatureCompensator::getCoefficient(uint8_t probe) const {
+  switch (mode) {
+    case TempCompMode::Configured:
+      return probes[probe].configuredQ8;
+    case TempCompMode::Learn:
+      if (isLearned(probe)) {
+        return probes[probe].learnedQ8;
+      }
+      return hasStoredCoefficient(probe) ? probes[probe].storedQ8 : probes[probe].configuredQ8;
+    default:
+      return 0;
+  }
+}
+
+void TemperatureCompensator::setConfiguredCoefficient(uint8_t probe, int16_t coefficientQ8) {
+  probes[probe].configuredQ8 = constrain(coefficientQ8, (int16_t)-kTempCompMaxCoeffQ8, kTempCompMaxCoeffQ8);
+  store(false, probe, probes[probe].configuredQ8);
+}
+
+bool TemperatureCompensator::isLearned(uint8_t probe) const {
+  const Probe& p = probes[probe];
+  return p.pairs >= kTempCompMinPairs && p.spanMs >= kTempCompMinFitMs && p.sumXX >= (int64_t)kTempCompMinSwing;
+}
+
+void TemperatureCompensator::reset() {
+  for (uint8_t probe = 0; probe < kMaxMoistureProbes; probe++) {
+    Probe& p = probes[probe];
+    p.learnedQ8 = 0;
+    if (p.storedQ8 != NO_COEFFICIENT) {
+      p.storedQ8 = NO_COEFFICIENT;
+      store(true, probe, NO_COEFFICIENT);
+    }
+    p.hasPoint = false;
+    p.pairs = 0;
+    p.spanMs = 0;
+    p.sumXY = 0;
+    p.sumXX = 0;
+  }
+}
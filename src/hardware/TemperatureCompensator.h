@@ -0,0 +1,72 @@
+#pragma once
+#include "../config/Config.h"
+
+class ConfigStore;
+
+enum class TempCompMode : uint8_t {
+  Off = 0,
+  Configured = 1,  // kTempCompCoeffQ8 or a coefficient set over serial
+  Learn = 2        // Learned coefficient once trusted, configured until then
+};
+
+// Per-probe temperature compensation of raw moisture readings, integer
+// only. A coefficient in counts/degC x256 (Q8) moves each reading to what
+// the probe would read at kTempCompReferenceCentiC.
+//
+// The learner fits the coefficient from first differences: between two fit
+// points kTempCompLearnIntervalMs apart the soil barely dries, so the raw
+// step against the temperature step is the probe's drift. Steps past
+// kTempCompMaxStep (watering) are skipped and the sums decay, so a fit
+// follows the probe through the season. The mode, configured coefficients
+// and the last trusted fit are kept in the config store; after a power loss
+// the stored fit stands in until a new one is trusted.
+class TemperatureCompensator {
+public:
+  // Without a soil probe the only temperature is the die's, which follows
+  // the board rather than the soil - an unset mode then defaults to Off
+  void begin(ConfigStore* store, bool soilProbePresent);
+
+  TempCompMode getMode() const { return mode; }
+  void setMode(TempCompMode newMode);
+
+  // Raw reading corrected to the reference temperature, 0..1023
+  uint16_t compensate(uint8_t probe, uint16_t raw, int16_t temperatureCentiC) const;
+  // Offer a non-faulted reading to the fit - ignored between fit points
+  void learn(uint8_t probe, uint16_t raw, int16_t temperatureCentiC, uint32_t nowMs);
+
+  // Coefficient in use, counts/degC x256
+  int16_t getCoefficient(uint8_t probe) const;
+  int16_t getConfiguredCoefficient(uint8_t probe) const { return probes[probe].configuredQ8; }
+  void setConfiguredCoefficient(uint8_t probe, int16_t coefficientQ8);
+  // True once the fit has enough points and temperature swing behind it
+  bool isLearned(uint8_t probe) const;
+  int16_t getLearnedCoefficient(uint8_t probe) const { return probes[probe].learnedQ8; }
+  // Fit from an earlier boot, used until this one's is trusted
+  bool hasStoredCoefficient(uint8_t probe) const { return probes[probe].storedQ8 != NO_COEFFICIENT; }
+  uint16_t getLearnedPairs(uint8_t probe) const { return probes[probe].pairs; }
+  void reset();  // Forget every fit, stored ones included
+
+  static constexpr int16_t NO_COEFFICIENT = INT16_MIN;
+
+private:
+  struct Probe {
+    int16_t configuredQ8 = 0;
+    int16_t learnedQ8 = 0;
+    int16_t storedQ8 = NO_COEFFICIENT;  // Last trusted fit in the config store
+    bool hasPoint = false;       // lastRaw/lastTemperature hold the previous fit point
+    uint16_t lastRaw = 0;
+    int16_t lastTemperature = 0;
+    uint32_t lastMs = 0;
+    uint16_t pairs = 0;          // Fit points accepted, saturating
+    uint32_t firstMs = 0;        // Time of the first accepted fit point
+    uint32_t spanMs = 0;         // Time from there to the latest
+    int64_t sumXY = 0;           // Decayed sum of temperature step x raw step
+    int64_t sumXX = 0;           // Decayed sum of squared temperature steps
+  };
+
+  TempCompMode mode = TempCompMode::Off;
+  Probe probes[kMaxMoistureProbes];
+  ConfigStore* configStore = nullptr;
+
+  void store(bool learned, uint8_t probe, int16_t coefficientQ8);
+};
@@ -0,0 +1,201 @@
+#include "ThresholdWake.h"
+#include "CalibrationManager.h"
+
+#if THRESHOLD_WAKE_ACMP
+#include <em_acmp.h>
+#include <em_cmu.h>
+#include <em_gpio.h>
+
+// Probe 0 (kMoisturePin = A0) is PB00 on the Nano Matter - an even pin on analog bus B
+static const ACMP_Channel_TypeDef kProbeAcmpInput = acmpInputPB0;
+static volatile bool acmpFired = false;
+
+extern "C" void ACMP0_IRQHandler(void) {
+  ACMP_IntClear(ACMP0, ACMP_IF_RISE);
+  ACMP_IntDisable(ACMP0, ACMP_IEN_RISE);
+  acmpFired = true;
+}
+
+extern "C" void ACMP1_IRQHandler(void) {
+  ACMP_IntClear(ACMP1, ACMP_IF_FALL);
+  ACMP_IntDisable(ACMP1, ACMP_IEN_FALL);
+  acmpFired = true;
+}
+
+// Output is high while the probe is above the divided reference
+static bool startComparator(ACMP_TypeDef* acmp, IRQn_Type irq, uint8_t level, uint32_t edge) {
+  ACMP_Init_TypeDef init = ACMP_INIT_DEFAULT;
+  init.accuracy = acmpAccuracyLow;             // Lowest supply current - it runs through EM2
+  init.hysteresisLevel = acmpHysteresis10Sym;  // Probe noise must not chatter on the level
+  init.vrefDiv = level;
+  init.enable = false;
+  ACMP_Init(acmp, &init);
+  ACMP_ChannelSet(acmp, acmpInputVREFDIVAVDD, kProbeAcmpInput);
+  ACMP_Enable(acmp);
+  while (!(acmp->STATUS & ACMP_STATUS_ACMPRDY)) {
+  }
+  ACMP_IntClear(acmp, _ACMP_IF_MASK);
+  ACMP_IntEnable(acmp, edge);
+  NVIC_ClearPendingIRQ(irq);
+  NVIC_EnableIRQ(irq);
+  return (acmp->STATUS & ACMP_STATUS_ACMPOUT) != 0;
+}
+
+bool AcmpComparator::arm(const ComparatorWindow& window) {
+  disarm();
+  acmpFired = false;
+  savedBusAlloc = GPIO->BBUSALLOC;
+  GPIO->BBUSALLOC = (savedBusAlloc & ~(_GPIO_BBUSALLOC_BEVEN0_MASK | _GPIO_BBUSALLOC_BEVEN1_MASK)) |
+                    GPIO_BBUSALLOC_BEVEN0_ACMP0 | GPIO_BBUSALLOC_BEVEN1_ACMP1;
+  armed = true;
+
+  // An open side stays powered down
+  if (window.upperRaw < ADC_MAX) {
+    CMU_ClockEnable(cmuClock_ACMP0, true);
+    if (startComparator(ACMP0, ACMP0_IRQn, rawToLevel(window.upperRaw), ACMP_IEN_RISE)) {
+      acmpFired = true;  // Already above - no edge will come
+    }
+  }
+  if (window.lowerRaw > 0) {
+    CMU_ClockEnable(cmuClock_ACMP1, true);
+    if (!startComparator(ACMP1, ACMP1_IRQn, rawToLevel(window.lowerRaw), ACMP_IEN_FALL)) {
+      acmpFired = true;
+    }
+  }
+  return true;
+}
+
+void AcmpComparator::disarm() {
+  if (!armed) {
+    return;
+  }
+  NVIC_DisableIRQ(ACMP0_IRQn);
+  NVIC_DisableIRQ(ACMP1_IRQn);
+  ACMP_Disable(ACMP0);
+  ACMP_Disable(ACMP1);
+  CMU_ClockEnable(cmuClock_ACMP0, false);
+  CMU_ClockEnable(cmuClock_ACMP1, false);
+  GPIO->BBUSALLOC = savedBusAlloc;
+  armed = false;
+}
+
+bool AcmpComparator::takeTrigger() {
+  noInterrupts();
+  bool fired = acmpFired;
+  acmpFired = false;
+  interrupts();
+  return fired;
+}
+#endif
+
+bool SimulatedComparator::arm(const ComparatorWindow& window) {
+  levels = window;
+  armed = true;
+  triggered = false;
+  return true;
+}
+
+void SimulatedComparator::sample(uint16_t raw) {
+  if (armed && !triggered && !levels.contains(raw)) {
+    triggered = true;
+    triggerCount++;
+  }
+}
+
+bool SimulatedComparator::takeTrigger() {
+  bool fired = triggered;
+  triggered = false;
+  return fired;
+}
+
+void ThresholdWake::begin(ComparatorBackend* backend, CalibrationManager* calibration) {
+  this->backend = backend;
+  this->calibration = calibration;
+  enabled = kThresholdWakeDefault;
+}
+
+void ThresholdWake::setEnabled(bool on) {
+  enabled = on;
+  if (!on) {
+    disarm();
+  }
+}
+
+uint32_t ThresholdWake::afterMeasurement(const MoistureBandEngine& bands, uint16_t raw, uint16_t compensatedRaw,
+                                         bool faulted, uint32_t periodicMs) {
+  disarm();
+  if (!enabled || !backend || !calibration) {
+    return periodicMs;
+  }
+  // A faulted probe needs steady readings for the detector to clear it, a
+  // pending band change needs its dwell readings, and without a
+  // calibration there are no edges to watch
+  if (faulted || !bands.hasBand() || bands.isSettling() || !calibration->isCalibrationValid()) {
+    return periodicMs;
+  }
+
+  // Past a comparator level but short of the edge it would trip straight away
+  ComparatorWindow window = ComparatorBackend::quantize(windowFor(bands, (int)raw - compensatedRaw));
+  if (!window.contains(raw) || !backend->arm(window)) {
+    return periodicMs;
+  }
+  armed = true;
+  armCount++;
+  return kThresholdWakeHeartbeatMs;
+}
+
+bool ThresholdWake::takeTrigger() {
+  if (!armed || !backend->takeTrigger()) {
+    return false;
+  }
+  triggerCount++;
+  return true;
+}
+
+void ThresholdWake::disarm() {
+  if (armed) {
+    backend->disarm();
+    armed = false;
+  }
+}
+
+// Raw counts where the band engine would leave the alert region: past an
+// edge by the hysteresis, plus the temperature correction the last reading
+// carried. Probes read higher when drier unless the calibration says
+// otherwise.
+ComparatorWindow ThresholdWake::windowFor(const MoistureBandEngine& bands, int correction) const {
+  int dryValue, wetValue;
+  calibration->getMoistureCalibration(dryValue, wetValue);
+  ComparatorWindow window = {0, ComparatorBackend::ADC_MAX};
+  bool rawRisesWhenDrier = dryValue > wetValue;
+
+  auto toRaw = [&](int percent) -> uint16_t {
+    long raw = dryValue + (long)(wetValue - dryValue) * percent / 100 + correction;
+    return (uint16_t)constrain(raw, 0L, (long)ComparatorBackend::ADC_MAX);
+  };
+  // Drier than percent: raw moves towards dryValue
+  auto wakeWhenDrierThan = [&](int percent) {
+    if (percent <= 0) return;
+    if (rawRisesWhenDrier) window.upperRaw = toRaw(percent);
+    else window.lowerRaw = toRaw(percent);
+  };
+  auto wakeWhenWetterThan = [&](int percent) {
+    if (percent > 100) return;
+    if (rawRisesWhenDrier) window.lowerRaw = toRaw(percent);
+    else window.upperRaw = toRaw(percent);
+  };
+
+  const int low = bands.getEdge(2);   // Dry | Adequate
+  const int high = bands.getEdge(5);  // Excellent | Saturated
+  const int h = bands.getHysteresis();
+  MoistureBand band = bands.getBand();
+  if (band <= MoistureBand::Dry) {
+    wakeWhenWetterThan(low + h);
+  } else if (band == MoistureBand::Saturated) {
+    wakeWhenDrierThan(high - h);
+  } else {
+    wakeWhenDrierThan(low - h);
+    wakeWhenWetterThan(high + h);
+  }
+  return window;
+}
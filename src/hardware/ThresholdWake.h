@@ -0,0 +1,125 @@
+#pragma once
+#include "../config/Config.h"
+#include "../matter/MoistureBandEngine.h"
+
+class CalibrationManager;
+
+// Comparator window in ADC counts - fires when probe 0 leaves [lowerRaw, upperRaw]
+struct ComparatorWindow {
+  uint16_t lowerRaw;
+  uint16_t upperRaw;
+
+  bool contains(uint16_t raw) const { return raw >= lowerRaw && raw <= upperRaw; }
+};
+
+// Where the window is armed - the EFR32 analog comparators on hardware, a
+// model of them on host builds. Levels are kThresholdWakeLevels steps of
+// the supply, the same reference the ADC reads against.
+class ComparatorBackend {
+public:
+  static constexpr uint16_t ADC_MAX = (uint16_t)kAdcReference;
+
+  // Window already quantised; returns false if it cannot be armed - the
+  // caller samples instead
+  virtual bool arm(const ComparatorWindow& window) = 0;
+  virtual void disarm() = 0;
+  virtual bool takeTrigger() = 0;  // Fired since armed; clears the latch
+  virtual ~ComparatorBackend() = default;
+
+  // Moves each edge inward to the nearest comparator level, so a crossing
+  // fires at or just before the edge; open sides stay open
+  static ComparatorWindow quantize(const ComparatorWindow& window) {
+    uint8_t lower = ((uint32_t)window.lowerRaw * (kThresholdWakeLevels - 1) + ADC_MAX - 1) / ADC_MAX;
+    uint8_t upper = (uint32_t)window.upperRaw * (kThresholdWakeLevels - 1) / ADC_MAX;
+    return {levelToRaw(lower), levelToRaw(upper)};
+  }
+  static uint16_t levelToRaw(uint8_t level) { return (uint32_t)level * ADC_MAX / (kThresholdWakeLevels - 1); }
+  static uint8_t rawToLevel(uint16_t raw) {
+    return ((uint32_t)raw * (kThresholdWakeLevels - 1) + ADC_MAX / 2) / ADC_MAX;
+  }
+};
+
+#if defined(ARDUINO_ARCH_SILABS) && __has_include(<em_acmp.h>)
+#define THRESHOLD_WAKE_ACMP 1
+// ACMP0 watches the upper level (rising edge), ACMP1 the lower (falling
+// edge). Both run in EM2 and raise an interrupt that ends the sleep. The
+// probe pin's analog bus is handed to the comparators while armed and back
+// to the ADC on disarm.
+class AcmpComparator : public ComparatorBackend {
+public:
+  bool arm(const ComparatorWindow& window) override;
+  void disarm() override;
+  bool takeTrigger() override;
+
+private:
+  uint32_t savedBusAlloc = 0;
+  bool armed = false;
+};
+#else
+#define THRESHOLD_WAKE_ACMP 0
+#endif
+
+// Host model of the comparator pair, evaluated whenever the simulator feeds
+// it the probe voltage.
+class SimulatedComparator : public ComparatorBackend {
+public:
+  bool arm(const ComparatorWindow& window) override;
+  void disarm() override { armed = false; }
+  bool takeTrigger() override;
+
+  // Probe output as an ADC count; latches a trigger outside the armed levels
+  void sample(uint16_t raw);
+  bool isArmed() const { return armed; }
+  const ComparatorWindow& getArmedWindow() const { return levels; }
+  uint32_t getTriggerCount() const { return triggerCount; }
+
+private:
+  ComparatorWindow levels = {0, ADC_MAX};
+  bool armed = false;
+  bool triggered = false;
+  uint32_t triggerCount = 0;
+};
+
+// Wake-on-threshold for probe 0. After each measurement the comparator is
+// armed around the alert region of the reported moisture band - below the
+// low threshold, between, or above the high one - at the readings where
+// the band engine would leave it. The CPU then sleeps until the probe
+// crosses one or the heartbeat is due. The normal interval is kept while a
+// band change waits out its dwell, while the probe is faulted, and while
+// the reading sits between a comparator level and the edge it stands in
+// for. Sub-band levels between the thresholds refresh at the heartbeat,
+// which also re-applies a temperature correction that drifted meanwhile.
+class ThresholdWake {
+public:
+  void begin(ComparatorBackend* backend, CalibrationManager* calibration);
+
+  void setEnabled(bool on);
+  bool isEnabled() const { return enabled; }
+
+  // After each measurement: arms the comparator if it can and returns the
+  // interval to the next scheduled wake (periodicMs or the heartbeat).
+  // compensatedRaw is the reading the bands saw; the comparator watches the
+  // probe itself, so the window moves by the temperature correction.
+  uint32_t afterMeasurement(const MoistureBandEngine& bands, uint16_t raw, uint16_t compensatedRaw, bool faulted,
+                            uint32_t periodicMs);
+
+  // Comparator fired during the sleep - measure now
+  bool takeTrigger();
+  // Start of every measurement wake - hands the probe back to the ADC
+  void onMeasurementWake() { disarm(); }
+
+  bool isArmed() const { return armed; }
+  uint32_t getTriggerCount() const { return triggerCount; }
+  uint32_t getArmCount() const { return armCount; }
+
+private:
+  ComparatorBackend* backend = nullptr;
+  CalibrationManager* calibration = nullptr;
+  bool enabled = false;
+  bool armed = false;
+  uint32_t triggerCount = 0;
+  uint32_t armCount = 0;
+
+  ComparatorWindow windowFor(const MoistureBandEngine& bands, int correction) const;
+  void disarm();
+};
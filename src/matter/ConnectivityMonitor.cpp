@@ -0,0 +1,125 @@
+#include "ConnectivityMonitor.h"
+
+#if CONNECTIVITY_STACK_EVENTS
+#include <platform/CHIPDeviceLayer.h>
+
+using namespace chip::DeviceLayer;
+
+// Runs on the Matter task - only latch the new state
+static void onDeviceEvent(const ChipDeviceEvent* event, intptr_t arg) {
+    ConnectivityMonitor* monitor = reinterpret_cast<ConnectivityMonitor*>(arg);
+    switch (event->Type) {
+        case DeviceEventType::kThreadConnectivityChange:
+            monitor->onThreadConnectivityChanged(event->ThreadConnectivityChange.Result == kConnectivity_Established);
+            break;
+        case DeviceEventType::kServiceConnectivityChange:
+            monitor->onMatterSessionChanged(event->ServiceConnectivityChange.Overall.Result == kConnectivity_Established);
+            break;
+        default:
+            break;
+    }
+}
+#endif
+
+ConnectivityMonitor connectivityMonitor;
+
+void ConnectivityMonitor::begin(uint32_t nowMs, Listener newListener, void* ctx) {
+    listener = newListener;
+    context = ctx;
+    thread = LinkTracker();
+    matter = LinkTracker();
+    thread.segmentStartMs = nowMs;
+    matter.segmentStartMs = nowMs;
+    threadReport = LinkReport();
+    matterReport = LinkReport();
+    
+#if CONNECTIVITY_STACK_EVENTS
+    matterKnown = true;  // Down until the stack says otherwise
+    PlatformMgr().AddEventHandler(onDeviceEvent, reinterpret_cast<intptr_t>(this));
+#else
+    matterKnown = false;
+#endif
+}
+
+void ConnectivityMonitor::onThreadConnectivityChanged(bool up) {
+    record(threadReport, up);
+}
+
+void ConnectivityMonitor::onMatterSessionChanged(bool up) {
+    matterKnown = true;
+    record(matterReport, up);
+}
+
+// Stack task side - the only writer of the report's state and drop count
+void ConnectivityMonitor::record(LinkReport& report, bool up) {
+    if (report.up && !up) {
+        report.drops = report.drops + 1;
+    }
+    report.up = up;
+    report.pending = true;
+}
+
+void ConnectivityMonitor::service(uint32_t nowMs) {
+    if (threadReport.pending) {
+        threadReport.pending = false;
+        apply(thread, threadReport, nowMs, ConnectivityEvent::ThreadUp, ConnectivityEvent::ThreadDown);
+    }
+    if (matterReport.pending) {
+        matterReport.pending = false;
+        apply(matter, matterReport, nowMs, ConnectivityEvent::MatterUp, ConnectivityEvent::MatterDown);
+    }
+}
+
+void ConnectivityMonitor::apply(LinkTracker& link, LinkReport& report, uint32_t nowMs,
+                                ConnectivityEvent upEvent, ConnectivityEvent downEvent) {
+    bool up = report.up;
+    uint16_t reportedDrops = report.drops;
+    uint16_t drops = reportedDrops - report.dropsApplied;
+    report.dropsApplied = reportedDrops;
+    if (link.up == up && drops == 0) {
+        return;  // Repeated report of the same state
+    }
+    
+    accumulate(link, nowMs);
+    bool wasUp = link.up;
+    link.drops += drops;
+    link.up = up;
+    if (listener) {
+        // A flap between two services ended where it began - the listener
+        // still sees the state it missed before the one that stands
+        if (wasUp == up) {
+            listener(up ? downEvent : upEvent, context);
+        }
+        listener(up ? upEvent : downEvent, context);
+    }
+}
+
+// Move whole seconds of the current segment into its counter; the
+// remainder stays in the segment so nothing is lost to rounding
+void ConnectivityMonitor::accumulate(LinkTracker& link, uint32_t nowMs) {
+    uint32_t seconds = (nowMs - link.segmentStartMs) / 1000;
+    if (link.up) {
+        link.upSeconds += seconds;
+    } else {
+        link.downSeconds += seconds;
+    }
+    link.segmentStartMs += seconds * 1000;
+}
+
+LinkStats ConnectivityMonitor::snapshot(const LinkTracker& link, uint32_t nowMs) {
+    LinkTracker current = link;
+    accumulate(current, nowMs);
+    return { current.upSeconds, current.downSeconds, current.drops, current.up };
+}
+
+uint16_t ConnectivityMonitor::getAvailabilityPermille(uint32_t nowMs) const {
+    if (!matterKnown) {
+        return AVAILABILITY_UNKNOWN;
+    }
+    LinkStats stats = getMatterStats(nowMs);
+    uint32_t total = stats.upSeconds + stats.downSeconds;
+    if (total == 0) {
+        return stats.up ? 1000 : 0;
+    }
+    return (uint16_t)((uint64_t)stats.upSeconds * 1000 / total);
+}
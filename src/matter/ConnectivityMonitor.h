@@ -0,0 +1,91 @@
+#pragma once
+#include <Arduino.h>
+
+// Stack events are only available when the Matter platform layer is built in
+#if defined(ARDUINO_ARCH_SILABS) && __has_include(<platform/CHIPDeviceLayer.h>)
+#define CONNECTIVITY_STACK_EVENTS 1
+#else
+#define CONNECTIVITY_STACK_EVENTS 0
+#endif
+
+enum class ConnectivityEvent : uint8_t {
+    ThreadUp,
+    ThreadDown,
+    MatterUp,
+    MatterDown
+};
+
+// Accumulated time in each state; seconds so counters survive millis() rollover
+struct LinkStats {
+    uint32_t upSeconds;
+    uint32_t downSeconds;
+    uint16_t drops;          // Up -> down transitions
+    bool up;
+};
+
+/**
+ * Event-driven link tracker. Stack callbacks (Thread connectivity change,
+ * Matter service connectivity change) arrive on the stack task, latch the
+ * new state and count every up-to-down transition as it happens, so a flap
+ * between two service() calls is still a drop. service() applies them on
+ * the main loop, updates the uptime/downtime counters and calls the
+ * listener once per change. Without the stack nothing reports the links,
+ * and availability reads AVAILABILITY_UNKNOWN until a callback arrives.
+ */
+class ConnectivityMonitor {
+public:
+    typedef void (*Listener)(ConnectivityEvent event, void* context);
+    
+    void begin(uint32_t nowMs, Listener listener, void* context);
+    
+    // Stack callbacks - safe from any task
+    void onThreadConnectivityChanged(bool up);
+    void onMatterSessionChanged(bool up);
+    
+    // Apply latched changes; call from loop()
+    void service(uint32_t nowMs);
+    
+    bool isThreadUp() const { return thread.up; }
+    bool isMatterUp() const { return matter.up; }
+    
+    LinkStats getThreadStats(uint32_t nowMs) const { return snapshot(thread, nowMs); }
+    LinkStats getMatterStats(uint32_t nowMs) const { return snapshot(matter, nowMs); }
+    uint16_t getAvailabilityPermille(uint32_t nowMs) const;  // End-to-end (Matter) availability
+    bool isMatterKnown() const { return matterKnown; }      // A stack reports the Matter link
+    
+    static constexpr uint16_t AVAILABILITY_UNKNOWN = 0xFFFF;
+
+private:
+    struct LinkTracker {
+        uint32_t upSeconds = 0;
+        uint32_t downSeconds = 0;
+        uint32_t segmentStartMs = 0;  // Start of the unaccounted part of the current state
+        uint16_t drops = 0;
+        bool up = false;
+    };
+    
+    Listener listener = nullptr;
+    void* context = nullptr;
+    LinkTracker thread;
+    LinkTracker matter;
+    
+    // Written only by the stack task, consumed by service()
+    struct LinkReport {
+        volatile bool up = false;
+        volatile bool pending = false;
+        volatile uint16_t drops = 0;  // Up-to-down transitions reported so far
+        uint16_t dropsApplied = 0;    // Main loop's copy of drops at the last service()
+    };
+    
+    LinkReport threadReport;
+    LinkReport matterReport;
+    volatile bool matterKnown = false;
+    
+    static void record(LinkReport& report, bool up);
+    static void accumulate(LinkTracker& link, uint32_t nowMs);
+    static LinkStats snapshot(const LinkTracker& link, uint32_t nowMs);
+    void apply(LinkTracker& link, LinkReport& report, uint32_t nowMs,
+               ConnectivityEvent upEvent, ConnectivityEvent downEvent);
+};
+
+extern ConnectivityMonitor connectivityMonitor;
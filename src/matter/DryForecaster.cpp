@@ -0,0 +1,68 @@
+#include "DryForecaster.h"
+#include "../config/Config.h"
+
+bool DryForecaster::addSample(uint32_t nowMs, float percent) {
+    watered = false;
+    if (samples > 0) {
+        uint32_t elapsedMs = nowMs - lastSampleMs;
+        if (elapsedMs < kDryForecastSampleMs) {
+            return false;
+        }
+
+        if (percent - lastPercent >= kDryForecastWetJump) {
+            reset();
+            watered = true;
+        } else {
+            // Move the origin to the new point and age the old ones
+            float dt = elapsedMs / 60000.0f;
+            sumTT = (sumTT - 2 * dt * sumT + dt * dt * sumW) * kDryForecastDecay;
+            sumTY = (sumTY - dt * sumY) * kDryForecastDecay;
+            sumT = (sumT - dt * sumW) * kDryForecastDecay;
+            sumY *= kDryForecastDecay;
+            sumW *= kDryForecastDecay;
+        }
+    }
+
+    // New point at t = 0 only adds to the weight and value sums
+    sumW += 1;
+    sumY += percent;
+    lastSampleMs = nowMs;
+    lastPercent = percent;
+    if (samples < UINT8_MAX) samples++;
+    return true;
+}
+
+void DryForecaster::reset() {
+    sumW = sumT = sumY = sumTT = sumTY = 0;
+    samples = 0;
+}
+
+bool DryForecaster::fit(float& slope, float& current) const {
+    if (samples < kDryForecastMinSamples) {
+        return false;
+    }
+    float denominator = sumW * sumTT - sumT * sumT;
+    if (denominator <= 0) {
+        return false;
+    }
+    slope = (sumW * sumTY - sumT * sumY) / denominator;  // % per minute
+    current = (sumY - slope * sumT) / sumW;             // Fitted value now
+    return true;
+}
+
+float DryForecaster::getSlopePerHour() const {
+    float slope, current;
+    return fit(slope, current) ? slope * 60 : 0;
+}
+
+uint16_t DryForecaster::minutesUntil(float targetPercent) const {
+    float slope, current;
+    if (!fit(slope, current) || slope >= 0) {
+        return UNKNOWN;
+    }
+    if (current <= targetPercent) {
+        return 0;
+    }
+    float minutes = (current - targetPercent) / -slope;
+    return minutes < UNKNOWN - 1 ? (uint16_t)minutes : UNKNOWN - 1;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * Time-to-dry forecast from an exponentially weighted linear regression
+ * of moisture against time. Sums are kept relative to the newest point,
+ * so each point shifts them by its age instead of letting time grow, and
+ * the fit stays well conditioned in float. Older points fade with
+ * kDryForecastDecay; a watering jump restarts the fit because the soil
+ * begins a new dry-down.
+ */
+class DryForecaster {
+public:
+    static const uint16_t UNKNOWN = 0xFFFF;
+
+    // Returns true when the point was taken into the fit
+    bool addSample(uint32_t nowMs, float percent);
+    void reset();
+
+    // Minutes until the fitted moisture reaches targetPercent; UNKNOWN while
+    // there are too few points or the soil is not drying
+    uint16_t minutesUntil(float targetPercent) const;
+
+    bool wasWatered() const { return watered; }  // Last point restarted the fit
+    uint8_t getSampleCount() const { return samples; }
+    float getSlopePerHour() const;
+
+private:
+    // Weighted sums; t in minutes relative to the newest point (t <= 0)
+    float sumW = 0;
+    float sumT = 0;
+    float sumY = 0;
+    float sumTT = 0;
+    float sumTY = 0;
+
+    uint32_t lastSampleMs = 0;
+    float lastPercent = 0;
+    uint8_t samples = 0;
+    bool watered = false;
+
+    bool fit(float& slope, float& current) const;
+};
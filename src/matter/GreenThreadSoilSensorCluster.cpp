@@ -3,21 +3,31 @@
 #include "../hardware/BatteryMonitor.h"
 #include "../hardware/CalibrationManager.h"
 #include "../hardware/PowerManager.h"
+#include "../hardware/EnergyBudget.h"
+#include "../hardware/AutoCalibrator.h"
+#include "../hardware/ClimateSensors.h"
 #include "../config/Config.h"
+#include "../config/ConfigStore.h"
+#include "ReportUplink.h"
+#include "ConnectivityMonitor.h"
 
 GreenThreadSoilSensorCluster::GreenThreadSoilSensorCluster(SensorManager* sm, BatteryMonitor* bm, 
                                                           CalibrationManager* cm, PowerManager* pm)
-    : sensorManager(sm), batteryMonitor(bm), calibrationManager(cm), powerManager(pm) {
+    : sensorManager(sm), batteryMonitor(bm), calibrationManager(cm), powerManager(pm),
+      moistureBands(kMoistureBandHysteresis, kMoistureBandDwellSamples) {
     // Initialize attribute values to defaults
     memset(&attributes, 0, sizeof(attributes));
     
     // Set sensible defaults
     attributes.calibrationDryValue = 1023;
     attributes.calibrationWetValue = 0;
-    attributes.moistureThresholdLow = 20;
-    attributes.moistureThresholdHigh = 80;
+    attributes.moistureThresholdLow = kDefaultThresholdLow;
+    attributes.moistureThresholdHigh = kDefaultThresholdHigh;
+    attributes.minutesUntilDry = DryForecaster::UNKNOWN;
+    attributes.probeCount = kMoistureProbeCount;
     attributes.sleepIntervalSeconds = 300;  // 5 minutes
-    attributes.measurementIntervalSeconds = 60;  // 1 minute
+    attributes.measurementIntervalSeconds = kDefaultMeasurementInterval;
+    attributes.dryForecastLeadMinutes = kDryForecastLeadMinutes;
     attributes.batteryVoltageMv = 3300;
     attributes.batteryLevelPercent = 100;
     attributes.powerState = POWER_ACTIVE;
@@ -35,6 +45,15 @@ bool GreenThreadSoilSensorCluster::begin() {
         return false;
     }
     
+    // Restore remotely tuned settings
+    if (configStore) {
+        attributes.moistureThresholdLow = configStore->getU32(ConfigKey::MoistureThresholdLow);
+        attributes.moistureThresholdHigh = configStore->getU32(ConfigKey::MoistureThresholdHigh);
+        attributes.measurementIntervalSeconds = configStore->getU32(ConfigKey::MeasurementInterval);
+        attributes.dryForecastLeadMinutes = configStore->getU32(ConfigKey::DryForecastLeadMinutes);
+    }
+    moistureBands.setThresholds(attributes.moistureThresholdLow, attributes.moistureThresholdHigh);
+    
     // Initialize with current hardware state
     updateSensorReadings();
     updateBatteryStatus();
@@ -57,8 +76,10 @@ bool GreenThreadSoilSensorCluster::begin() {
 }
 
 bool GreenThreadSoilSensorCluster::isOnline() const {
-    // For now, return true during development
-    // TODO: Implement real Matter/Thread connection checking when Silicon Labs APIs are integrated
+    // Online while reports are being acknowledged; the uplink backs off otherwise
+    if (reportUplink) {
+        return reportUplink->isOnline();
+    }
     return true;
 }
 
@@ -72,13 +93,17 @@ void GreenThreadSoilSensorCluster::update(bool forceUpdate) {
     // Update at regular intervals or when forced
     if (forceUpdate || (currentTime - lastAttributeUpdate) >= 5000) {  // Update every 5 seconds
         updateSensorReadings();
+        updateClimateReadings();
         updateBatteryStatus();
         updateCalibrationStatus();
         updatePowerStatus();
         updateSystemStatus();
         
-        // Check for threshold crossings and send events
-        checkThresholdCrossings();
+        // Check for threshold crossings and send events - never on a faulted probe
+        if (!headlineFaulted) {
+            checkThresholdCrossings();
+            checkDryForecast();
+        }
         
         lastAttributeUpdate = currentTime;
         attributes.measurementCount++;
@@ -91,14 +116,55 @@ void GreenThreadSoilSensorCluster::update(bool forceUpdate) {
 void GreenThreadSoilSensorCluster::updateSensorReadings() {
     if (!sensorManager) return;
     
-    // Get raw sensor value
-    float moistureFloat = sensorManager->readMoisture();
-    uint16_t rawMoisture = (uint16_t)(moistureFloat * 1023.0 / 100.0);  // Convert back to raw for compatibility
-    attributes.soilMoistureRaw = rawMoisture;
+    // The sketch scans once per wake; only a new scan feeds the attributes,
+    // the forecaster and the fault events
+    if (sensorManager->getScanCount() == lastScanCount) return;
+    lastScanCount = sensorManager->getScanCount();
+    float moistureFloat = sensorManager->getMoisture(0);
+    
+    // Every probe came from the same scan; a faulted one keeps its last good
+    // value and raises one SystemError event each time its fault changes
+    uint8_t firstFaulted = kMaxMoistureProbes;
+    for (uint8_t probe = 0; probe < attributes.probeCount; probe++) {
+        uint8_t code = probeErrorCode(probe, sensorManager->getFault(probe));
+        if (code != probeErrorCodes[probe]) {
+            probeErrorCodes[probe] = code;
+            if (code != 0) {
+                sendSystemErrorEvent(code);
+            }
+        }
+        if (code == 0) {
+            attributes.probeMoisturePercent[probe] = (uint8_t)sensorManager->getMoisture(probe);
+        } else if (firstFaulted == kMaxMoistureProbes) {
+            firstFaulted = probe;
+        }
+    }
+    
+    // Status and errorCode show the lowest faulted probe
+    if (firstFaulted < kMaxMoistureProbes) {
+        attributes.sensorStatus = sensorManager->isDisconnected(firstFaulted) ? SENSOR_DISCONNECTED : SENSOR_ERROR;
+        attributes.errorCode = probeErrorCodes[firstFaulted];
+    } else {
+        attributes.sensorStatus = SENSOR_OK;
+        attributes.errorCode = 0;
+    }
+    
+    // Keep the last good moisture values - the probe output is not soil
+    headlineFaulted = (firstFaulted == 0);
+    if (headlineFaulted) {
+        return;
+    }
+    
+    // Burst-averaged ADC counts behind the percentage
+    attributes.soilMoistureRaw = sensorManager->getLastRaw();
     
     // Store the processed percentage
     attributes.soilMoisturePercent = (uint8_t)moistureFloat;
     
+    // Feed the drying trend; the fit rate-limits itself
+    dryForecaster.addSample(millis(), moistureFloat);
+    attributes.minutesUntilDry = dryForecaster.minutesUntil(attributes.moistureThresholdLow);
+    
     // Set calibration status based on calibration manager
     if (calibrationManager && calibrationManager->isCalibrationValid()) {
         attributes.calibrationStatus = CALIBRATION_FULLY_CALIBRATED;
@@ -110,16 +176,19 @@ void GreenThreadSoilSensorCluster::updateSensorReadings() {
     } else {
         attributes.calibrationStatus = CALIBRATION_NOT_CALIBRATED;
     }
+}
+
+void GreenThreadSoilSensorCluster::updateClimateReadings() {
+    if (!climateSensors) return;
     
-    // For now, set soil temperature to 0 (no dedicated soil temp sensor)
-    attributes.soilTemperatureCelsius = 0;
-    
-    // For now, set humidity to 0 (no dedicated humidity sensor) 
-    attributes.humidityPercent = 0;
-    
-    // Update sensor status - assume healthy if we can read values
-    attributes.sensorStatus = SENSOR_OK;
-    attributes.errorCode = 0;
+    // Converted during this wake; a missing or failed sensor keeps its last value
+    if (climateSensors->soil.hasReading()) {
+        attributes.soilTemperatureCelsius = climateSensors->soil.getTemperatureCentiC();
+    }
+    if (climateSensors->air.hasReading()) {
+        attributes.airTemperatureCelsius = climateSensors->air.getTemperatureCentiC();
+        attributes.humidityPercent = (uint8_t)((climateSensors->air.getHumidityCentiPercent() + 50) / 100);
+    }
 }
 
 void GreenThreadSoilSensorCluster::updateBatteryStatus() {
@@ -131,14 +200,17 @@ void GreenThreadSoilSensorCluster::updateBatteryStatus() {
     float voltage = batteryMonitor->readVoltage();
     attributes.batteryVoltageMv = (uint16_t)(voltage * 1000.0);
     
-    // Calculate battery percentage (assuming 3.3V nominal, 2.7V low)
-    attributes.batteryLevelPercent = (uint8_t)constrain(
-        ((voltage - 2.7) / (3.3 - 2.7)) * 100.0, 
-        0, 100
-    );
+    // State of charge is estimated once per measurement cycle by the monitor;
+    // before the first estimate the level is unknown, not 0%
+    if (!batteryMonitor->hasStateOfCharge()) {
+        return;
+    }
+    attributes.batteryLevelPercent = batteryMonitor->getStateOfCharge();
     
-    // Send event if battery level changed significantly
-    if (abs((int)attributes.batteryLevelPercent - (int)oldBatteryLevel) >= 5) {
+    // The first estimate is the baseline; after that, event on significant changes
+    if (!batteryEstimated) {
+        batteryEstimated = true;
+    } else if (abs((int)attributes.batteryLevelPercent - (int)oldBatteryLevel) >= 5) {
         sendBatteryLevelChangedEvent(attributes.batteryLevelPercent);
     }
 }
@@ -160,6 +232,11 @@ void GreenThreadSoilSensorCluster::updateCalibrationStatus() {
         attributes.calibrationStatus = CALIBRATION_NOT_CALIBRATED;
         attributes.calibrationPointsCount = 0;
     }
+    
+    if (autoCalibrator) {
+        attributes.calibrationConfidence = autoCalibrator->getConfidence();
+        attributes.autoCalibrationMode = static_cast<uint8_t>(autoCalibrator->getMode());
+    }
 }
 
 void GreenThreadSoilSensorCluster::updatePowerStatus() {
@@ -185,18 +262,38 @@ void GreenThreadSoilSensorCluster::updatePowerStatus() {
             break;
     }
     
-    // Send event if power state changed
-    if (attributes.powerState != oldPowerState) {
-        sendPowerStateChangedEvent(attributes.powerState);
+    // Send event if power state changed; the first state after Booting is
+    // the baseline, taken once the battery has a real estimate
+    if (currentPowerState != PowerState::Booting) {
+        if (!powerStateReported) {
+            powerStateReported = true;
+        } else if (attributes.powerState != oldPowerState) {
+            sendPowerStateChangedEvent(attributes.powerState);
+        }
     }
     
     // Get current sleep interval
     attributes.sleepIntervalSeconds = powerManager->getCurrentSleepInterval() / 1000;  // Convert ms to seconds
+    
+    // Lifetime projection from the energy budget controller
+    EnergyBudget* budget = powerManager->getEnergyBudget();
+    if (budget) {
+        attributes.targetLifetimeDays = budget->getTargetDays();
+        attributes.projectedLifetimeDays = budget->hasEstimate() ? budget->getProjectedDays() : 0;
+    }
 }
 
 void GreenThreadSoilSensorCluster::updateSystemStatus() {
+    // Link statistics from the connectivity monitor
+    if (connectivityMonitor) {
+        uint32_t now = millis();
+        attributes.linkAvailabilityPermille = connectivityMonitor->getAvailabilityPermille(now);
+        attributes.linkDropCount = connectivityMonitor->getMatterStats(now).drops;
+    }
+    
     // Update system status based on overall health
     if (attributes.sensorStatus == SENSOR_ERROR || 
+        attributes.sensorStatus == SENSOR_DISCONNECTED ||
         attributes.powerState == POWER_CRITICAL_BATTERY) {
         // System has issues
         return;
@@ -296,6 +393,11 @@ bool GreenThreadSoilSensorCluster::handleSetThresholds(uint8_t lowThreshold, uin
     
     attributes.moistureThresholdLow = lowThreshold;
     attributes.moistureThresholdHigh = highThreshold;
+    moistureBands.setThresholds(lowThreshold, highThreshold);
+    if (configStore) {
+        configStore->setU32(ConfigKey::MoistureThresholdLow, lowThreshold);
+        configStore->setU32(ConfigKey::MoistureThresholdHigh, highThreshold);
+    }
     
     Serial.println("Thresholds updated successfully");
     return true;
@@ -312,11 +414,34 @@ bool GreenThreadSoilSensorCluster::handleSetMeasurementInterval(uint16_t interva
     }
     
     attributes.measurementIntervalSeconds = intervalSeconds;
+    if (configStore) {
+        configStore->setU32(ConfigKey::MeasurementInterval, intervalSeconds);
+    }
     
     Serial.println("Measurement interval updated successfully");
     return true;
 }
 
+bool GreenThreadSoilSensorCluster::handleSetDryForecastLead(uint16_t leadMinutes) {
+    Serial.print("Command: Set Dry Forecast Lead - ");
+    Serial.print(leadMinutes);
+    Serial.println(" minutes");
+    
+    if (!validateDryForecastLead(leadMinutes)) {
+        Serial.println("ERROR: Invalid dry forecast lead");
+        return false;
+    }
+    
+    // Takes effect at the next forecast; a dry-down already notified stays notified
+    attributes.dryForecastLeadMinutes = leadMinutes;
+    if (configStore) {
+        configStore->setU32(ConfigKey::DryForecastLeadMinutes, leadMinutes);
+    }
+    
+    Serial.println("Dry forecast lead updated successfully");
+    return true;
+}
+
 bool GreenThreadSoilSensorCluster::handleGetStatus() {
     Serial.println("Command: Get Status");
     printAttributeValues();
@@ -331,6 +456,14 @@ bool GreenThreadSoilSensorCluster::handleEnterSleepMode() {
         return false;
     }
     
+    // Sleep ends in a reset - commit pending calibration and settings first
+    if (calibrationManager) {
+        calibrationManager->flush(powerManager->getCurrentState());
+    }
+    if (configStore) {
+        configStore->flush(powerManager->getCurrentState());
+    }
+    
     // PowerManager enterSleepMode() returns void, so just call it
     powerManager->enterSleepMode();
     attributes.powerState = POWER_SLEEP;
@@ -342,34 +475,56 @@ bool GreenThreadSoilSensorCluster::handleEnterSleepMode() {
 // === Event Generation ===
 
 void GreenThreadSoilSensorCluster::checkThresholdCrossings() {
-    uint8_t currentMoisture = attributes.soilMoisturePercent;
-    
-    // Check for threshold crossings
-    if (lastMoistureLevel != 0) {  // Skip first reading
-        if (lastMoistureLevel <= attributes.moistureThresholdLow && 
-            currentMoisture > attributes.moistureThresholdLow) {
-            // Crossed low threshold upward
-            sendMoistureThresholdCrossedEvent(currentMoisture, 0);  // 0 = low threshold
-        } else if (lastMoistureLevel >= attributes.moistureThresholdHigh && 
-                   currentMoisture < attributes.moistureThresholdHigh) {
-            // Crossed high threshold downward
-            sendMoistureThresholdCrossedEvent(currentMoisture, 1);  // 1 = high threshold
-        }
+    // One event per accepted band change - hysteresis and dwell absorb noise
+    if (moistureBands.update(attributes.soilMoisturePercent)) {
+        sendMoistureThresholdCrossedEvent(attributes.soilMoisturePercent, moistureBands.getBand());
     }
-    
-    lastMoistureLevel = currentMoisture;
 }
 
-void GreenThreadSoilSensorCluster::sendMoistureThresholdCrossedEvent(uint8_t newLevel, uint8_t thresholdType) {
-    Serial.print("Event: Moisture threshold crossed - Level: ");
-    Serial.print(newLevel);
-    Serial.print("%, Threshold: ");
-    Serial.println(thresholdType == 0 ? "LOW" : "HIGH");
+void GreenThreadSoilSensorCluster::sendMoistureThresholdCrossedEvent(uint8_t percent, MoistureBand band) {
+    // AlertType: 0 = low, 1 = high, 2 = normal
+    uint8_t alertType = 2;
+    if (band <= MoistureBand::Dry) {
+        alertType = 0;
+    } else if (band == MoistureBand::Saturated) {
+        alertType = 1;
+    }
     
-    uint8_t eventData[2] = { newLevel, thresholdType };
+    Serial.print("Event: Moisture band changed - Level: ");
+    Serial.print(percent);
+    Serial.print("%, Band: ");
+    Serial.print((uint8_t)band);
+    Serial.print(", Alert: ");
+    Serial.println(alertType == 0 ? "LOW" : (alertType == 1 ? "HIGH" : "NORMAL"));
+    
+    uint8_t eventData[3] = { percent, (uint8_t)band, alertType };
     sendEvent(EVENT_MOISTURE_THRESHOLD_CROSSED, eventData, sizeof(eventData));
 }
 
+void GreenThreadSoilSensorCluster::checkDryForecast() {
+    // Re-arm once watering starts a new dry-down
+    if (dryForecaster.wasWatered()) {
+        dryForecastSent = false;
+    }
+    
+    uint16_t minutes = attributes.minutesUntilDry;
+    if (!dryForecastSent && minutes != DryForecaster::UNKNOWN && minutes <= attributes.dryForecastLeadMinutes) {
+        sendDryForecastEvent(minutes);
+        dryForecastSent = true;
+    }
+}
+
+void GreenThreadSoilSensorCluster::sendDryForecastEvent(uint16_t minutes) {
+    Serial.print("Event: Dry forecast - ");
+    Serial.print(minutes);
+    Serial.print(" min to ");
+    Serial.print(attributes.moistureThresholdLow);
+    Serial.println("%");
+    
+    uint8_t eventData[3] = { (uint8_t)(minutes & 0xFF), (uint8_t)(minutes >> 8), attributes.soilMoisturePercent };
+    sendEvent(EVENT_DRY_FORECAST, eventData, sizeof(eventData));
+}
+
 void GreenThreadSoilSensorCluster::sendBatteryLevelChangedEvent(uint8_t newLevel) {
     Serial.print("Event: Battery level changed - ");
     Serial.print(newLevel);
@@ -415,6 +570,10 @@ void GreenThreadSoilSensorCluster::sendEvent(uint8_t eventId, const uint8_t* eve
         if (i < dataLength - 1) Serial.print(" ");
     }
     Serial.println();
+    
+    if (eventListener) {
+        eventListener(eventId, eventData, dataLength, eventListenerContext);
+    }
 }
 
 // === Validation Helpers ===
@@ -427,6 +586,10 @@ bool GreenThreadSoilSensorCluster::validateMeasurementInterval(uint16_t interval
     return (interval >= 10) && (interval <= 3600);  // 10 seconds to 1 hour
 }
 
+bool GreenThreadSoilSensorCluster::validateDryForecastLead(uint16_t leadMinutes) const {
+    return (leadMinutes >= 1) && (leadMinutes <= kDryForecastMaxLeadMinutes);
+}
+
 // === Debug and Diagnostics ===
 
 void GreenThreadSoilSensorCluster::printClusterInfo() const {
@@ -462,6 +625,14 @@ void GreenThreadSoilSensorCluster::printAttributeValues() const {
             attributes.soilTemperatureCelsius / 100.0);
     Serial.println(buffer);
     
+    if (attributes.probeCount > 1) {
+        int length = sprintf(buffer, "Probes:");
+        for (uint8_t probe = 0; probe < attributes.probeCount; probe++) {
+            length += sprintf(buffer + length, " %d%%", attributes.probeMoisturePercent[probe]);
+        }
+        Serial.println(buffer);
+    }
+    
     // Battery status - show power state instead of USB status
     sprintf(buffer, "Battery: %d%% (%dmV), Power: %d", 
             attributes.batteryLevelPercent,
@@ -469,6 +640,12 @@ void GreenThreadSoilSensorCluster::printAttributeValues() const {
             attributes.powerState);
     Serial.println(buffer);
     
+    sprintf(buffer, "Interval: %us, Lifetime: %u/%u days",
+            attributes.sleepIntervalSeconds,
+            attributes.projectedLifetimeDays,
+            attributes.targetLifetimeDays);
+    Serial.println(buffer);
+    
     // System status
     sprintf(buffer, "Status: %d, Count: %d, Last: %ds ago", 
             attributes.sensorStatus,
@@ -476,11 +653,21 @@ void GreenThreadSoilSensorCluster::printAttributeValues() const {
             (millis() / 1000) - attributes.lastMeasurementTime);
     Serial.println(buffer);
     
+    // Forecast
+    if (attributes.minutesUntilDry != DryForecaster::UNKNOWN) {
+        sprintf(buffer, "Dry in: %u min (%.1f%%/h), lead %u min",
+                attributes.minutesUntilDry,
+                dryForecaster.getSlopePerHour(),
+                attributes.dryForecastLeadMinutes);
+        Serial.println(buffer);
+    }
+    
     // Configuration
-    sprintf(buffer, "Thresholds: L=%d%%, H=%d%%, Cal: %d", 
+    sprintf(buffer, "Thresholds: L=%d%%, H=%d%%, Cal: %d (auto %d%%)", 
             attributes.moistureThresholdLow,
             attributes.moistureThresholdHigh,
-            attributes.calibrationStatus);
+            attributes.calibrationStatus,
+            attributes.calibrationConfidence);
     Serial.println(buffer);
     
     Serial.println("==============================");
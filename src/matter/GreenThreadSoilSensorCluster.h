@@ -1,12 +1,21 @@
 #pragma once
 #include <Arduino.h>
 #include <stdint.h>
+#include "../config/Config.h"
+#include "MoistureBandEngine.h"
+#include "DryForecaster.h"
+#include "../hardware/SensorFaultDetector.h"
 
 // Forward declarations
 class SensorManager;
 class BatteryMonitor;
 class CalibrationManager;
 class PowerManager;
+class ConfigStore;
+class AutoCalibrator;
+class ReportUplink;
+class ConnectivityMonitor;
+class ClimateSensors;
 
 /**
  * Green Thread Soil Sensor Custom Matter Cluster
@@ -19,12 +28,16 @@ class PowerManager;
  */
 class GreenThreadSoilSensorCluster {
 public:
+    // Receives every generated event (after logging); payload as sent
+    typedef void (*EventListener)(uint8_t eventId, const uint8_t* data, size_t length, void* context);
+    
     // Cluster and Vendor IDs from generated code
     static const uint32_t CLUSTER_ID = 0xFC30;
     static const uint16_t VENDOR_ID = 0xFFF1;
     static const uint32_t FULL_CLUSTER_ID = 0xFFF1FC30;  // Combined for easy reference
     
-    // Attribute IDs (from generated MTRClusterConstants.h)
+    // Attribute IDs (from generated MTRClusterConstants.h); every one not in
+    // the original cluster uses the same code in green-thread-soil-sensor-cluster.xml
     enum AttributeId : uint16_t {
         // Primary sensor readings
         ATTR_SOIL_MOISTURE_PERCENT = 0x0000,
@@ -32,6 +45,7 @@ public:
         ATTR_SOIL_TEMPERATURE_CELSIUS = 0x0002,
         ATTR_AIR_TEMPERATURE_CELSIUS = 0x0003,
         ATTR_HUMIDITY_PERCENT = 0x0004,
+        ATTR_MINUTES_UNTIL_DRY = 0x000C,
         
         // Calibration attributes
         ATTR_CALIBRATION_STATUS = 0x0010,
@@ -40,6 +54,9 @@ public:
         ATTR_MOISTURE_THRESHOLD_LOW = 0x0013,
         ATTR_MOISTURE_THRESHOLD_HIGH = 0x0014,
         ATTR_CALIBRATION_POINTS_COUNT = 0x0015,
+        ATTR_CALIBRATION_CONFIDENCE = 0x0016,
+        ATTR_AUTO_CALIBRATION_MODE = 0x0017,
+        ATTR_DRY_FORECAST_LEAD_MINUTES = 0x0018,
         
         // Power management
         ATTR_BATTERY_VOLTAGE_MV = 0x0020,
@@ -47,13 +64,21 @@ public:
         ATTR_POWER_STATE = 0x0022,
         ATTR_SLEEP_INTERVAL_SECONDS = 0x0023,
         ATTR_MEASUREMENT_INTERVAL_SECONDS = 0x0024,
+        ATTR_PROJECTED_LIFETIME_DAYS = 0x0025,
+        ATTR_TARGET_LIFETIME_DAYS = 0x0026,
         
         // System status
         ATTR_SENSOR_STATUS = 0x0030,
         ATTR_LAST_MEASUREMENT_TIME = 0x0031,
         ATTR_MEASUREMENT_COUNT = 0x0032,
         ATTR_ERROR_CODE = 0x0033,
-        ATTR_FIRMWARE_VERSION = 0x0034
+        ATTR_FIRMWARE_VERSION = 0x0034,
+        ATTR_LINK_AVAILABILITY_PERMILLE = 0x0035,
+        ATTR_LINK_DROP_COUNT = 0x0036,
+        
+        // Multi-probe readings
+        ATTR_PROBE_COUNT = 0x0040,
+        ATTR_PROBE_MOISTURE_PERCENT = 0x0041  // List, one entry per probe (probe 0 first)
     };
     
     // Command IDs (from generated code)
@@ -68,13 +93,14 @@ public:
         CMD_ENTER_SLEEP_MODE = 0x17
     };
     
-    // Event IDs (from generated code)
+    // Event IDs (from generated code); SystemError and DryForecast match the XML
     enum EventId : uint8_t {
         EVENT_MOISTURE_THRESHOLD_CROSSED = 0x00,
         EVENT_BATTERY_LEVEL_CHANGED = 0x01,
         EVENT_POWER_STATE_CHANGED = 0x02,
         EVENT_CALIBRATION_COMPLETED = 0x03,
-        EVENT_SYSTEM_ERROR = 0x04
+        EVENT_SYSTEM_ERROR = 0x04,
+        EVENT_DRY_FORECAST = 0x05
     };
     
     // Enums for status values
@@ -108,6 +134,13 @@ private:
     BatteryMonitor* batteryMonitor;
     CalibrationManager* calibrationManager;
     PowerManager* powerManager;
+    ConfigStore* configStore = nullptr;
+    AutoCalibrator* autoCalibrator = nullptr;
+    ReportUplink* reportUplink = nullptr;
+    ConnectivityMonitor* connectivityMonitor = nullptr;
+    ClimateSensors* climateSensors = nullptr;
+    EventListener eventListener = nullptr;
+    void* eventListenerContext = nullptr;
     
     // Current attribute values
     struct AttributeValues {
@@ -117,6 +150,9 @@ private:
         int16_t soilTemperatureCelsius = 0;
         int16_t airTemperatureCelsius = 0;
         uint8_t humidityPercent = 0;
+        uint16_t minutesUntilDry = DryForecaster::UNKNOWN;  // Forecast to the low threshold
+        uint8_t probeCount = kMoistureProbeCount;
+        uint8_t probeMoisturePercent[kMaxMoistureProbes] = {};  // Last good reading of each probe
         
         // Calibration
         uint8_t calibrationStatus = CALIBRATION_NOT_CALIBRATED;
@@ -125,6 +161,9 @@ private:
         uint8_t moistureThresholdLow = 20;
         uint8_t moistureThresholdHigh = 80;
         uint8_t calibrationPointsCount = 0;
+        uint8_t calibrationConfidence = 0;   // Auto-calibration confidence (%)
+        uint8_t autoCalibrationMode = 0;
+        uint16_t dryForecastLeadMinutes = 720;  // DryForecast event once minutesUntilDry drops to this
         
         // Power
         uint16_t batteryVoltageMv = 3300;
@@ -132,6 +171,8 @@ private:
         uint8_t powerState = POWER_ACTIVE;
         uint16_t sleepIntervalSeconds = 300;  // 5 minutes default
         uint16_t measurementIntervalSeconds = 60;  // 1 minute default
+        uint16_t projectedLifetimeDays = 0;        // At the current interval; 0 = no estimate yet
+        uint16_t targetLifetimeDays = 0;
         
         // System
         uint8_t sensorStatus = SENSOR_OK;
@@ -139,6 +180,8 @@ private:
         uint32_t measurementCount = 0;
         uint8_t errorCode = 0;
         uint32_t firmwareVersion = 0x010000;  // 1.0.0
+        uint16_t linkAvailabilityPermille = 0;   // Matter link up-time since boot
+        uint16_t linkDropCount = 0;
     } attributes;
     
     // Internal state
@@ -147,9 +190,20 @@ private:
     uint32_t lastEventSent = 0;
     
     // Event tracking for threshold crossing
-    uint8_t lastMoistureLevel = 0;
-    bool thresholdCrossedHigh = false;
-    bool thresholdCrossedLow = false;
+    MoistureBandEngine moistureBands;
+    
+    // Battery and power events start once real state is known
+    bool batteryEstimated = false;
+    bool powerStateReported = false;
+    
+    // Per-probe fault tracking - probe 0 alone drives the headline moisture
+    uint8_t probeErrorCodes[kMaxMoistureProbes] = {};
+    bool headlineFaulted = false;
+    uint32_t lastScanCount = 0;  // SensorManager scan behind the sensor attributes
+    
+    // Time-to-dry forecast - one event per dry-down cycle
+    DryForecaster dryForecaster;
+    bool dryForecastSent = false;
 
 public:
     /**
@@ -158,6 +212,19 @@ public:
     GreenThreadSoilSensorCluster(SensorManager* sm, BatteryMonitor* bm, 
                                 CalibrationManager* cm, PowerManager* pm);
     
+    /**
+     * Persist thresholds and measurement interval - call before begin()
+     */
+    void setConfigStore(ConfigStore* store) { configStore = store; }
+    void setAutoCalibrator(AutoCalibrator* calibrator) { autoCalibrator = calibrator; }
+    void setReportUplink(ReportUplink* uplink) { reportUplink = uplink; }
+    void setConnectivityMonitor(ConnectivityMonitor* monitor) { connectivityMonitor = monitor; }
+    void setClimateSensors(ClimateSensors* sensors) { climateSensors = sensors; }
+    void setEventListener(EventListener listener, void* context) {
+        eventListener = listener;
+        eventListenerContext = context;
+    }
+    
     /**
      * Initialize the cluster - call once in setup()
      */
@@ -177,14 +244,21 @@ public:
     
     // === Attribute Getters ===
     uint8_t getSoilMoisturePercent() const { return attributes.soilMoisturePercent; }
+    uint8_t getMoistureLevel() const { return (uint8_t)moistureBands.getBand(); }
+    const MoistureBandEngine& getMoistureBands() const { return moistureBands; }
     uint16_t getSoilMoistureRaw() const { return attributes.soilMoistureRaw; }
     int16_t getSoilTemperatureCelsius() const { return attributes.soilTemperatureCelsius; }
     int16_t getAirTemperatureCelsius() const { return attributes.airTemperatureCelsius; }
     uint8_t getHumidityPercent() const { return attributes.humidityPercent; }
+    uint16_t getMinutesUntilDry() const { return attributes.minutesUntilDry; }
+    uint8_t getProbeCount() const { return attributes.probeCount; }
+    uint8_t getProbeMoisturePercent(uint8_t probe) const { return attributes.probeMoisturePercent[probe]; }
     uint8_t getCalibrationStatus() const { return attributes.calibrationStatus; }
+    uint8_t getCalibrationConfidence() const { return attributes.calibrationConfidence; }
     uint16_t getBatteryVoltageMv() const { return attributes.batteryVoltageMv; }
     uint8_t getBatteryLevelPercent() const { return attributes.batteryLevelPercent; }
     uint8_t getPowerState() const { return attributes.powerState; }
+    uint16_t getProjectedLifetimeDays() const { return attributes.projectedLifetimeDays; }
     uint8_t getSensorStatus() const { return attributes.sensorStatus; }
     uint32_t getMeasurementCount() const { return attributes.measurementCount; }
     
@@ -195,15 +269,17 @@ public:
     bool handleForceMeasurement();
     bool handleSetThresholds(uint8_t lowThreshold, uint8_t highThreshold);
     bool handleSetMeasurementInterval(uint16_t intervalSeconds);
+    bool handleSetDryForecastLead(uint16_t leadMinutes);  // Write to ATTR_DRY_FORECAST_LEAD_MINUTES
     bool handleGetStatus();
     bool handleEnterSleepMode();
     
     // === Event Generation ===
-    void sendMoistureThresholdCrossedEvent(uint8_t newLevel, uint8_t thresholdType);
+    void sendMoistureThresholdCrossedEvent(uint8_t percent, MoistureBand band);
     void sendBatteryLevelChangedEvent(uint8_t newLevel);
     void sendPowerStateChangedEvent(uint8_t newState);
     void sendCalibrationCompletedEvent(uint8_t status);
     void sendSystemErrorEvent(uint8_t errorCode);
+    void sendDryForecastEvent(uint16_t minutes);
     
     // === Utility Methods ===
     bool isCalibrated() const { 
@@ -222,6 +298,12 @@ public:
         return attributes.sensorStatus == SENSOR_OK;
     }
     
+    // errorCode of a probe fault: the SensorFault in the low bits, the probe
+    // index in bits 7..6, so probe 0 reports the plain fault code
+    static uint8_t probeErrorCode(uint8_t probe, SensorFault fault) {
+        return fault == SensorFault::None ? 0 : (uint8_t)((probe << 6) | (uint8_t)fault);
+    }
+    
     // === Debug and Diagnostics ===
     void printClusterInfo() const;
     void printAttributeValues() const;
@@ -229,6 +311,7 @@ public:
 private:
     // Internal update methods
     void updateSensorReadings();
+    void updateClimateReadings();
     void updateBatteryStatus();
     void updateCalibrationStatus();
     void updatePowerStatus();
@@ -236,9 +319,11 @@ private:
     
     // Event helpers
     void checkThresholdCrossings();
+    void checkDryForecast();
     void sendEvent(uint8_t eventId, const uint8_t* eventData, size_t dataLength);
     
     // Validation helpers
     bool validateThresholds(uint8_t low, uint8_t high) const;
     bool validateMeasurementInterval(uint16_t interval) const;
+    bool validateDryForecastLead(uint16_t leadMinutes) const;
 };
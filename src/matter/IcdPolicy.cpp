@@ -0,0 +1,135 @@
+#include "IcdPolicy.h"
+
+#if ICD_THREAD_BACKEND
+#include <openthread/instance.h>
+#include <openthread/link.h>
+#include <platform/CHIPDeviceLayer.h>
+
+using chip::DeviceLayer::ThreadStackMgr;
+#endif
+
+IcdParameters deriveIcdParameters(uint32_t measurementIntervalMs, PowerState state) {
+    IcdParameters params;
+    params.fastPollMs = kIcdFastPollMs;
+    params.activeModeDurationMs = kIcdActiveModeMs;
+    params.activeModeThresholdMs = kIcdActiveThresholdMs;
+    params.alwaysOn = (state == PowerState::UsbPowered || measurementIntervalMs == 0);
+    
+    if (params.alwaysOn) {
+        // Powered from USB - stay reachable, poll at the active rate
+        params.slowPollMs = kIcdFastPollMs;
+        params.idleModeDurationS = 0;
+        params.checkInIntervalS = kIcdMinCheckInS;
+        return params;
+    }
+    
+    // One slow poll per measurement wake; the parent's child timeout bounds it
+    params.slowPollMs = min(measurementIntervalMs, kIcdMaxSlowPollMs);
+    params.idleModeDurationS = max(measurementIntervalMs / 1000, (uint32_t)1);
+    
+    // Check-in on a whole number of idle periods, never less than the minimum
+    uint32_t periods = (kIcdMinCheckInS + params.idleModeDurationS - 1) / params.idleModeDurationS;
+    params.checkInIntervalS = params.idleModeDurationS * max(periods, (uint32_t)1);
+    return params;
+}
+
+uint32_t icdPollsPerWake(const IcdParameters& params, uint32_t wakeIntervalMs) {
+    if (params.alwaysOn || params.fastPollMs == 0 || params.slowPollMs == 0) {
+        return 0;
+    }
+    // Poll on entry, fast polls through the active window, then a slow poll
+    // only where the idle gap outlasts it
+    uint32_t activePolls = params.activeModeDurationMs / params.fastPollMs;
+    uint32_t idleMs = wakeIntervalMs > params.activeModeDurationMs
+                          ? wakeIntervalMs - params.activeModeDurationMs : 0;
+    uint32_t idlePolls = idleMs > params.slowPollMs ? (idleMs - 1) / params.slowPollMs : 0;
+    return 1 + activePolls + idlePolls;
+}
+
+// Fires of a periodic timer at nextMs, nextMs + periodMs, ... before endMs;
+// nextMs is left on the first fire at or after endMs
+static uint32_t timerFiresBefore(uint32_t& nextMs, uint32_t periodMs, uint32_t endMs) {
+    if (periodMs == 0 || (int32_t)(endMs - nextMs) <= 0) {
+        return 0;
+    }
+    uint32_t fires = (endMs - nextMs - 1) / periodMs + 1;
+    nextMs += fires * periodMs;
+    return fires;
+}
+
+void SimulatedIcdStack::onMeasurementWake(uint32_t nowMs) {
+    advanceTo(nowMs);
+    wakeCount++;
+    
+    const IcdParameters& params = getParameters();
+    if (!freeRunPollMs) {
+        pollCount++;  // Data request on the wake itself
+    }
+    fastNextMs = nowMs + params.fastPollMs;
+    activeUntilMs = nowMs + params.activeModeDurationMs;
+    if (!freeRunPollMs) {
+        slowNextMs = activeUntilMs + params.slowPollMs;  // Slow timer restarts behind the window
+    } else if (!timersRunning) {
+        slowNextMs = nowMs + freeRunPollMs;
+    }
+    timersRunning = true;
+}
+
+void SimulatedIcdStack::advanceTo(uint32_t nowMs) {
+    if (!timersRunning) {
+        return;
+    }
+    const IcdParameters& params = getParameters();
+    if (params.alwaysOn) {
+        pollCount += timerFiresBefore(fastNextMs, params.fastPollMs, nowMs);
+        return;
+    }
+    // Fast polls up to and including the end of the active window
+    uint32_t fastEndMs = (int32_t)(nowMs - activeUntilMs) > 0 ? activeUntilMs + 1 : nowMs;
+    pollCount += timerFiresBefore(fastNextMs, params.fastPollMs, fastEndMs);
+    pollCount += timerFiresBefore(slowNextMs, freeRunPollMs ? freeRunPollMs : params.slowPollMs, nowMs);
+}
+
+uint32_t SimulatedIcdStack::pollsPerDay(const IcdParameters& params, uint32_t wakeIntervalMs,
+                                        bool coordinated, uint32_t freeRunPollMs) {
+    const uint32_t dayMs = 86400000UL;
+    SimulatedIcdStack stack(coordinated ? 0 : freeRunPollMs);
+    stack.configure(params);
+    if (params.alwaysOn || wakeIntervalMs == 0) {
+        stack.onMeasurementWake(0);
+    } else {
+        for (uint32_t t = 0; t < dayMs; t += wakeIntervalMs) {
+            stack.onMeasurementWake(t);
+        }
+    }
+    stack.advanceTo(dayMs);
+    return stack.getPollCount();
+}
+
+#if ICD_THREAD_BACKEND
+void ThreadIcdBackend::apply(const IcdParameters& params) {
+    // Called from loop() - the OpenThread API is only safe under the stack lock
+    ThreadStackMgr().LockThreadStack();
+    otLinkSetPollPeriod(otInstanceInitSingle(), params.alwaysOn ? params.fastPollMs : params.slowPollMs);
+    ThreadStackMgr().UnlockThreadStack();
+    
+    #ifdef DEBUG_SERIAL
+    Serial.print(F("[ICD] Poll "));
+    Serial.print(params.alwaysOn ? params.fastPollMs : params.slowPollMs);
+    Serial.print(F(" ms, idle "));
+    Serial.print(params.idleModeDurationS);
+    Serial.print(F(" s, active "));
+    Serial.print(params.activeModeDurationMs);
+    Serial.print(F(" ms, check-in "));
+    Serial.print(params.checkInIntervalS);
+    Serial.println(F(" s"));
+    #endif
+}
+
+void ThreadIcdBackend::onMeasurementWake(uint32_t) {
+    // Poll now - the next slow poll is then one period after this wake
+    ThreadStackMgr().LockThreadStack();
+    otLinkSendDataRequest(otInstanceInitSingle());
+    ThreadStackMgr().UnlockThreadStack();
+}
+#endif
@@ -0,0 +1,126 @@
+#pragma once
+#include <Arduino.h>
+#include "../hardware/PowerManager.h"
+
+/**
+ * Intermittently Connected Device parameters for the Thread Sleepy End
+ * Device radio. Everything is derived from the measurement interval of the
+ * current PowerState, so the slow poll lands on the same wake as the
+ * measurement instead of waking the radio on its own timer.
+ */
+struct IcdParameters {
+    uint32_t slowPollMs;             // Idle mode poll period
+    uint32_t fastPollMs;             // Active mode poll period
+    uint32_t idleModeDurationS;      // Idle between measurement wakes
+    uint32_t activeModeDurationMs;   // Active window opened by each wake
+    uint32_t activeModeThresholdMs;  // Active extension after an exchange
+    uint32_t checkInIntervalS;       // Check-in to registered clients
+    bool alwaysOn;                   // USB power - radio never sleeps
+    
+    bool operator==(const IcdParameters& other) const {
+        return slowPollMs == other.slowPollMs && fastPollMs == other.fastPollMs &&
+               idleModeDurationS == other.idleModeDurationS &&
+               activeModeDurationMs == other.activeModeDurationMs &&
+               activeModeThresholdMs == other.activeModeThresholdMs &&
+               checkInIntervalS == other.checkInIntervalS && alwaysOn == other.alwaysOn;
+    }
+    bool operator!=(const IcdParameters& other) const { return !(*this == other); }
+};
+
+IcdParameters deriveIcdParameters(uint32_t measurementIntervalMs, PowerState state);
+
+// Data polls one measurement cycle of wakeIntervalMs costs under params: the
+// poll on entry, the active-mode fast polls and any slow poll the idle gap
+// outlasts. 0 when the radio is always on (USB power is not metered).
+uint32_t icdPollsPerWake(const IcdParameters& params, uint32_t wakeIntervalMs);
+
+/**
+ * Where ICD parameters are applied - the Thread stack on hardware, or the
+ * simulated stack when no stack is available
+ */
+class IcdBackend {
+public:
+    // Applies only when the parameters changed - safe to call every cycle
+    void configure(const IcdParameters& params) {
+        if (!configured || params != applied) {
+            applied = params;
+            configured = true;
+            apply(params);
+        }
+    }
+    const IcdParameters& getParameters() const { return applied; }
+    bool isConfigured() const { return configured; }
+    
+    virtual void onMeasurementWake(uint32_t nowMs) = 0;  // Poll now so the timer phase follows the wake
+    virtual ~IcdBackend() = default;
+
+protected:
+    virtual void apply(const IcdParameters& params) = 0;
+
+private:
+    IcdParameters applied = {};
+    bool configured = false;
+};
+
+#if defined(ARDUINO_ARCH_SILABS) && __has_include(<openthread/link.h>) && __has_include(<platform/CHIPDeviceLayer.h>)
+#define ICD_THREAD_BACKEND 1
+/**
+ * OpenThread backend: sets the SED poll period and sends a data poll on
+ * each measurement wake. The Matter task runs the OpenThread instance, so
+ * both calls hold the Thread stack lock. Idle/active durations and check-in
+ * are fixed at build time by the Silicon Labs Matter ICD manager, so they
+ * are logged for comparison with the build configuration; the ICD manager
+ * also sets the poll period on its own mode changes, and the period set
+ * here holds until the next one.
+ */
+class ThreadIcdBackend : public IcdBackend {
+public:
+    void onMeasurementWake(uint32_t) override;
+
+protected:
+    void apply(const IcdParameters& params) override;
+};
+#else
+#define ICD_THREAD_BACKEND 0
+#endif
+
+/**
+ * Local stand-in for the Matter stack. Records the applied parameters and
+ * counts polls in virtual time, so poll budgets can be checked off-target.
+ * Each measurement wake sends a poll and opens the active window; the fast
+ * timer polls through that window and the slow timer from its end until
+ * the next wake. Parameters applied between wakes take effect at the next
+ * wake, as the stack restarts its timers there.
+ */
+class SimulatedIcdStack : public IcdBackend {
+public:
+    // freeRunPollMs non-zero models the stack before coordination: no poll
+    // on the wake, and a slow timer free-running at that period
+    explicit SimulatedIcdStack(uint32_t freeRunPollMs = 0) : freeRunPollMs(freeRunPollMs) {}
+    
+    void onMeasurementWake(uint32_t nowMs) override;
+    void advanceTo(uint32_t nowMs);  // Count the timer polls due before nowMs
+    
+    uint32_t getApplyCount() const { return applyCount; }
+    uint32_t getWakeCount() const { return wakeCount; }
+    uint32_t getPollCount() const { return pollCount; }
+    
+    // Polls in one simulated day with measurement wakes every wakeIntervalMs.
+    // coordinated = slow poll restarts at each wake (this module's policy);
+    // otherwise it free-runs at freeRunPollMs beside the wakes.
+    static uint32_t pollsPerDay(const IcdParameters& params, uint32_t wakeIntervalMs,
+                                bool coordinated, uint32_t freeRunPollMs = kIcdLegacyPollMs);
+
+protected:
+    void apply(const IcdParameters&) override { applyCount++; }
+
+private:
+    uint32_t freeRunPollMs;
+    uint32_t applyCount = 0;
+    uint32_t wakeCount = 0;
+    uint32_t pollCount = 0;
+    bool timersRunning = false;  // Set by the first wake
+    uint32_t activeUntilMs = 0;
+    uint32_t fastNextMs = 0;
+    uint32_t slowNextMs = 0;
+};
@@ -19,10 +19,12 @@ void MatterStandardClusters::begin() {
     // Serial.println(basicInfoAttrs.productId, HEX);  // Temporarily commented out - may cause String issue
     
     // Set default humidity values
-    humidityAttrs.measuredValue = 0;
-    humidityAttrs.minMeasuredValue = 0;
-    humidityAttrs.maxMeasuredValue = 10000;  // 100.00%
-    humidityAttrs.tolerance = 100;  // 1% tolerance
+    for (RelativeHumidityAttributes& humidity : humidityAttrs) {
+        humidity.measuredValue = 0;
+        humidity.minMeasuredValue = 0;
+        humidity.maxMeasuredValue = 10000;  // 100.00%
+        humidity.tolerance = 100;  // 1% tolerance
+    }
     
     // Set default power values
     powerAttrs.status = 1;  // Active
@@ -33,25 +35,32 @@ void MatterStandardClusters::begin() {
     powerAttrs.batChargeLevel = 0;  // OK
     
     // TODO: Register clusters with Matter SDK when available
-    // Initialize the Matter humidity sensor
+    // Initialize one Matter humidity sensor per fitted probe (kMoistureProbeCount)
     // matterHumidity.begin();
     
     Serial.println(F("[Matter] Standard clusters ready"));
 }
 
-void MatterStandardClusters::updateMoisture(float moisturePercent) {
+void MatterStandardClusters::updateMoisture(float moisturePercent, uint8_t probe) {
+    if (probe >= kMaxMoistureProbes) {
+        return;
+    }
+    RelativeHumidityAttributes& humidity = humidityAttrs[probe];
+    
     // Convert 0-100% to Matter's 0-10000 scale (0.01% resolution)
-    humidityAttrs.measuredValue = (uint16_t)(moisturePercent * 100);
+    humidity.measuredValue = (uint16_t)(moisturePercent * 100);
     
     // Clamp to valid range
-    if (humidityAttrs.measuredValue > 10000) {
-        humidityAttrs.measuredValue = 10000;
+    if (humidity.measuredValue > 10000) {
+        humidity.measuredValue = 10000;
     }
     
     // Report updated value to Matter network using the actual API
-    // matterHumidity.set_percent(moisturePercent);
+    // matterHumidity[probe].set_percent(moisturePercent);
     
-    Serial.print("Standard cluster - Humidity updated: ");
+    Serial.print("Standard cluster - Humidity ");
+    Serial.print(probe);
+    Serial.print(" updated: ");
     Serial.print(moisturePercent);
     Serial.println("%");
 }
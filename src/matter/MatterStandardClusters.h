@@ -1,12 +1,15 @@
 #pragma once
 #include <Arduino.h>
+#include "../config/Config.h"
 // #include <MatterHumidity.h>  // Temporarily commented out for compilation test
 
 /**
  * Standard Matter Clusters for Home Assistant Compatibility
  * 
  * This implements standard Matter clusters alongside our custom cluster
- * to ensure Home Assistant recognizes the device properly.
+ * to ensure Home Assistant recognizes the device properly. Each moisture
+ * probe is its own humidity sensor endpoint, so a bed with several probes
+ * shows up as one sensor per depth.
  */
 
 class MatterStandardClusters {
@@ -64,7 +67,7 @@ public:
     };
     
 private:
-    RelativeHumidityAttributes humidityAttrs;
+    RelativeHumidityAttributes humidityAttrs[kMaxMoistureProbes];  // One endpoint per probe
     PowerSourceAttributes powerAttrs;
     BasicInformationAttributes basicInfoAttrs;
     
@@ -73,12 +76,12 @@ private:
     
 public:
     void begin();
-    void updateMoisture(float moisturePercent);
+    void updateMoisture(float moisturePercent, uint8_t probe = 0);
     void updateBattery(float voltage, uint8_t percent);
     void setDeviceInfo(const char* serialNumber = nullptr, const char* location = nullptr);
     
     // Getters for Home Assistant
-    uint16_t getHumidityMeasuredValue() const { return humidityAttrs.measuredValue; }
+    uint16_t getHumidityMeasuredValue(uint8_t probe = 0) const { return humidityAttrs[probe].measuredValue; }
     uint8_t getBatteryPercentRemaining() const { return powerAttrs.batPercentRemaining; }
     uint8_t getBatteryChargeLevel() const { return powerAttrs.batChargeLevel; }
     
@@ -0,0 +1,90 @@
+#include "MoistureBandEngine.h"
+#include "../config/Config.h"
+
+MoistureBandEngine::MoistureBandEngine(uint8_t hysteresis, uint8_t dwellSamples)
+    : hysteresis(hysteresis), dwellSamples(dwellSamples ? dwellSamples : 1) {
+    setThresholds(kDefaultThresholdLow, kDefaultThresholdHigh);
+}
+
+void MoistureBandEngine::setThresholds(uint8_t low, uint8_t high) {
+    uint8_t derived[EDGE_COUNT] = {
+        (uint8_t)(low / 3),
+        (uint8_t)(low * 2 / 3),
+        low,
+        (uint8_t)(low + (high - low) / 3),
+        (uint8_t)(low + (high - low) * 2 / 3),
+        high
+    };
+    setEdges(derived);
+}
+
+void MoistureBandEngine::setEdges(const uint8_t newEdges[EDGE_COUNT]) {
+    for (uint8_t i = 0; i < EDGE_COUNT; i++) {
+        edges[i] = newEdges[i];
+    }
+    // Keep the current band; the next readings move it if the edges moved
+    pendingCount = 0;
+}
+
+void MoistureBandEngine::reset() {
+    initialized = false;
+    pendingCount = 0;
+}
+
+// Band without hysteresis: number of edges at or below the reading
+uint8_t MoistureBandEngine::classify(uint8_t percent) const {
+    uint8_t index = 0;
+    while (index < EDGE_COUNT && percent >= edges[index]) {
+        index++;
+    }
+    return index;
+}
+
+// Band the reading has clearly entered, or the current band when it is
+// still within the hysteresis margin of an edge
+uint8_t MoistureBandEngine::target(uint8_t percent) const {
+    uint8_t current = (uint8_t)band;
+    uint8_t next = current;
+
+    // Wetter: must clear each edge above the current band by the margin
+    while (next < EDGE_COUNT && percent >= edges[next] + hysteresis) {
+        next++;
+    }
+    if (next != current) {
+        return next;
+    }
+
+    // Drier: must fall below each edge under the current band by the margin
+    while (next > 0 && percent + hysteresis < edges[next - 1]) {
+        next--;
+    }
+    return next;
+}
+
+bool MoistureBandEngine::update(uint8_t percent) {
+    if (!initialized) {
+        band = (MoistureBand)classify(percent);
+        pendingCount = 0;
+        initialized = true;
+        return false;
+    }
+
+    MoistureBand candidate = (MoistureBand)target(percent);
+    if (candidate == band) {
+        pendingCount = 0;
+        return false;
+    }
+
+    // Restart the dwell when the reading heads for a different band
+    if (pendingCount == 0 || candidate != pending) {
+        pending = candidate;
+        pendingCount = 0;
+    }
+    if (++pendingCount < dwellSamples) {
+        return false;
+    }
+
+    band = pending;
+    pendingCount = 0;
+    return true;
+}
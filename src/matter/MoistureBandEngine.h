@@ -0,0 +1,58 @@
+#pragma once
+#include <stdint.h>
+
+// SoilMoistureLevel values from green-thread-enums.xml
+enum class MoistureBand : uint8_t {
+    Critical = 0,
+    VeryDry = 1,
+    Dry = 2,
+    Adequate = 3,
+    Good = 4,
+    Excellent = 5,
+    Saturated = 6
+};
+
+/**
+ * Classifies moisture readings into the seven SoilMoistureLevel bands.
+ *
+ * A reading must pass a band edge by the hysteresis margin, and the new
+ * band must hold for the dwell count of consecutive readings, before the
+ * band changes. update() returns true exactly once per accepted change,
+ * so a reading hovering on an edge never produces a stream of events.
+ * The first reading only establishes the band.
+ */
+class MoistureBandEngine {
+public:
+    static const uint8_t BAND_COUNT = 7;
+    static const uint8_t EDGE_COUNT = BAND_COUNT - 1;
+
+    MoistureBandEngine(uint8_t hysteresis, uint8_t dwellSamples);
+
+    // Derive edges from the alert thresholds: three dry bands below low,
+    // three moist bands between low and high, saturated above high
+    void setThresholds(uint8_t low, uint8_t high);
+    void setEdges(const uint8_t edges[EDGE_COUNT]);  // Ascending, in %
+
+    // Returns true when the reported band changed
+    bool update(uint8_t percent);
+    void reset();
+
+    MoistureBand getBand() const { return band; }
+    bool hasBand() const { return initialized; }
+    bool isSettling() const { return pendingCount > 0; }  // A change is waiting out the dwell
+    uint8_t getHysteresis() const { return hysteresis; }
+    uint8_t getEdge(uint8_t index) const { return edges[index]; }
+
+private:
+    uint8_t edges[EDGE_COUNT];
+    uint8_t hysteresis;
+    uint8_t dwellSamples;
+
+    MoistureBand band = MoistureBand::Critical;
+    MoistureBand pending = MoistureBand::Critical;
+    uint8_t pendingCount = 0;
+    bool initialized = false;
+
+    uint8_t classify(uint8_t percent) const;
+    uint8_t target(uint8_t percent) const;
+};
@@ -0,0 +1,72 @@
+#include "ReportPhase.h"
+
+#if REPORT_PHASE_HW_IDENTITY
+#include <em_system.h>
+#endif
+
+bool readNodeIdentity(uint8_t id[8]) {
+#if REPORT_PHASE_HW_IDENTITY
+    uint64_t unique = SYSTEM_GetUnique();
+    for (uint8_t i = 0; i < 8; i++) {
+        id[i] = (uint8_t)(unique >> (56 - 8 * i));
+    }
+    return true;
+#else
+    memset(id, 0, 8);
+    return false;
+#endif
+}
+
+uint32_t nodeIdentityHash(const uint8_t* id, uint8_t length) {
+    uint32_t hash = 2166136261u;
+    for (uint8_t i = 0; i < length; i++) {
+        hash ^= id[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void ReportPhase::begin(uint32_t identityHash, uint32_t nowMs) {
+    anchorMs = nowMs;
+    phase = (uint16_t)(identityHash ^ (identityHash >> 16));
+    rng = identityHash ? identityHash : 1;  // xorshift must not start at zero
+    lastJitterMs = 0;
+}
+
+uint32_t ReportPhase::firstWake() const {
+    return anchorMs + (uint32_t)(((uint64_t)kReportBootSpreadMs * phase) >> 16);
+}
+
+uint32_t ReportPhase::nextWake(uint32_t nowMs, uint32_t intervalMs) {
+    if (intervalMs == 0) {
+        return nowMs;  // Power management off - measure every pass
+    }
+
+    uint32_t offset = (uint32_t)(((uint64_t)intervalMs * phase) >> 16);
+    uint32_t earliest = (nowMs - anchorMs) + intervalMs / 2;
+
+    // First slot at or after the earliest allowed wake
+    uint32_t cycles = 0;
+    if (earliest > offset) {
+        cycles = (earliest - offset + intervalMs - 1) / intervalMs;
+    }
+    // Re-anchor each time so the arithmetic stays small across millis() rollover
+    anchorMs += cycles * intervalMs;
+
+    uint32_t spread = (intervalMs / 100) * kReportPhaseJitterPercent;
+    spread = min(spread, intervalMs / 4);  // Keep well clear of neighbouring slots
+    lastJitterMs = 0;
+    if (spread > 0) {
+        lastJitterMs = (int32_t)(nextRandom() % (2 * spread + 1)) - (int32_t)spread;
+    }
+
+    return anchorMs + offset + lastJitterMs;
+}
+
+uint32_t ReportPhase::nextRandom() {
+    // xorshift32 - reproducible from the identity, no libc state
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <Arduino.h>
+#include "../config/Config.h"
+
+// The MG24 EUI-64 (also the factory IEEE address Thread derives its
+// extended address from) is only reachable through the Gecko SDK
+#if defined(ARDUINO_ARCH_SILABS) && __has_include(<em_system.h>)
+#define REPORT_PHASE_HW_IDENTITY 1
+#else
+#define REPORT_PHASE_HW_IDENTITY 0
+#endif
+
+// Fills id with the node's EUI-64; returns false when no hardware identity
+// is available and the caller has to supply its own
+bool readNodeIdentity(uint8_t id[8]);
+
+// FNV-1a - spreads near-sequential serials/addresses across the full range
+uint32_t nodeIdentityHash(const uint8_t* id, uint8_t length);
+
+/**
+ * Deterministic report phase for a fleet. Nodes that boot together after a
+ * power cut would otherwise measure and transmit on the same tick forever.
+ * Each node takes a fixed phase - a fraction of the interval derived from
+ * its identity hash - and wakes on the slots anchor + phase + k * interval,
+ * plus +/- kReportPhaseJitterPercent of random jitter so two nodes that
+ * hash to nearby phases don't stay locked together. Jitter is applied
+ * around the slot, not accumulated, so the phase never random-walks.
+ */
+class ReportPhase {
+public:
+    void begin(uint32_t identityHash, uint32_t nowMs);
+
+    // First measurement after boot - within kReportBootSpreadMs
+    uint32_t firstWake() const;
+
+    // Next measurement time after a wake at nowMs. Slots stay on the node's
+    // phase when the interval changes; a wake is never less than half an
+    // interval after the previous one.
+    uint32_t nextWake(uint32_t nowMs, uint32_t intervalMs);
+
+    // Phase as a fraction of the interval, 0..65535
+    uint16_t getPhase() const { return phase; }
+    int32_t getLastJitterMs() const { return lastJitterMs; }
+
+private:
+    uint32_t anchorMs = 0;    // Start of the current interval cycle
+    uint16_t phase = 0;
+    uint32_t rng = 1;
+    int32_t lastJitterMs = 0;
+
+    uint32_t nextRandom();
+};
@@ -0,0 +1,104 @@
+#include "ReportUplink.h"
+
+void ReportUplink::begin(SendFn sendFn, void* ctx, uint32_t seed) {
+    send = sendFn;
+    context = ctx;
+    rng = seed ? seed : 1;
+    head = 0;
+    count = 0;
+    stride = 1;
+    sinceKept = 0;
+    state = LinkState::Online;
+    failures = 0;
+    backingOff = false;
+}
+
+void ReportUplink::enqueue(const QueuedReading& reading) {
+    if (++sinceKept < stride) {
+        dropped++;
+        return;
+    }
+    sinceKept = 0;
+    if (count == kReportQueueDepth) {
+        thin();
+    }
+    queue[(head + count) % kReportQueueDepth] = reading;
+    count++;
+}
+
+void ReportUplink::thin() {
+    // Keep the odd positions - the newest reading stays, the oldest goes.
+    // Sources are never behind their destination, so this compacts in place.
+    uint8_t kept = count / 2;
+    for (uint8_t i = 0; i < kept; i++) {
+        queue[(head + i) % kReportQueueDepth] = queue[(head + 2 * i + 1) % kReportQueueDepth];
+    }
+    dropped += count - kept;
+    count = kept;
+    if (stride < 0x8000) {
+        stride *= 2;
+    }
+}
+
+uint8_t ReportUplink::service(uint32_t nowMs) {
+    if (!send || count == 0) {
+        return 0;
+    }
+    // Signed difference keeps this correct across millis() rollover
+    if (backingOff && (int32_t)(nowMs - nextAttemptMs) < 0) {
+        return 0;
+    }
+    
+    uint8_t sent = 0;
+    while (count > 0 && sent < kReportBatchMax) {
+        uint32_t onMs = 0;
+        attempts++;
+        bool ok = send(queue[head], onMs, context);
+        radioOnMs += onMs;
+        if (!ok) {
+            onFailure(nowMs);
+            return sent;
+        }
+        head = (head + 1) % kReportQueueDepth;
+        count--;
+        sent++;
+        delivered++;
+    }
+    
+    failures = 0;
+    backingOff = false;
+    state = LinkState::Online;
+    if (count == 0) {
+        // Caught up - back to every reading
+        stride = 1;
+        sinceKept = 0;
+    }
+    return sent;
+}
+
+void ReportUplink::onFailure(uint32_t nowMs) {
+    if (failures < UINT8_MAX) failures++;
+    state = failures >= kReportOfflineFailures ? LinkState::Offline : LinkState::Retrying;
+    
+    // base * 2^(failures-1), capped, then jittered
+    uint32_t delay = kReportBackoffBaseMs;
+    for (uint8_t i = 1; i < failures && delay < kReportBackoffMaxMs; i++) {
+        delay <<= 1;
+    }
+    delay = min(delay, kReportBackoffMaxMs);
+    uint32_t spread = delay / 100 * kReportJitterPercent;
+    if (spread > 0) {
+        delay = delay - spread + nextRandom() % (2 * spread + 1);
+    }
+    
+    nextAttemptMs = nowMs + delay;
+    backingOff = true;
+}
+
+uint32_t ReportUplink::nextRandom() {
+    // xorshift32 - reproducible from the seed, no libc state
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
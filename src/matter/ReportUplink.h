@@ -0,0 +1,88 @@
+#pragma once
+#include <Arduino.h>
+#include "../config/Config.h"
+
+// One measurement waiting to be reported
+struct QueuedReading {
+    static const uint16_t NO_MOISTURE = 0xFFFF;  // Probe faulted or not fitted
+    
+    uint32_t timestampS;      // Seconds since boot when measured
+    uint16_t moistureTenths[kMaxMoistureProbes];  // 0.1 % units, one per probe
+    uint16_t batteryMv;
+    uint8_t batteryPercent;
+};
+
+enum class LinkState : uint8_t {
+    Online,       // Last report delivered
+    Retrying,     // Recent failure - next attempt after a short backoff
+    Offline       // kReportOfflineFailures in a row - long backoff, readings queue
+};
+
+/**
+ * Connectivity-aware report scheduler. Readings are queued on every wake;
+ * a report attempt is only made when the backoff allows it, so an outage
+ * costs one failed transmission per backoff period instead of one per
+ * wake. The delay doubles with each consecutive failure up to
+ * kReportBackoffMaxMs, with +/- kReportJitterPercent jitter so nodes that
+ * lost the same router don't retry in lockstep.
+ *
+ * A full queue is thinned rather than trimmed: every other reading goes
+ * and from then on only every stride-th new one is kept, so however long
+ * the outage the queue spans all of it at an even, coarser resolution.
+ * The stride resets once the queue drains.
+ */
+class ReportUplink {
+public:
+    // Delivers one reading; returns true when acknowledged. radioOnMs is
+    // set to the radio time charged for the attempt (measured where the
+    // transport can, kReportRadioMs per report otherwise).
+    typedef bool (*SendFn)(const QueuedReading& reading, uint32_t& radioOnMs, void* context);
+    
+    void begin(SendFn send, void* context, uint32_t seed);
+    
+    void enqueue(const QueuedReading& reading);
+    
+    // Attempt delivery if the backoff allows; returns readings delivered
+    uint8_t service(uint32_t nowMs);
+    
+    // Link came back - the next service() attempts regardless of backoff
+    void retryNow() { backingOff = false; }
+    
+    bool isOnline() const { return state == LinkState::Online; }
+    LinkState getState() const { return state; }
+    uint8_t getQueuedCount() const { return count; }
+    uint8_t getFailureCount() const { return failures; }
+    uint32_t getNextAttemptMs() const { return nextAttemptMs; }
+    
+    // Statistics
+    uint32_t getAttempts() const { return attempts; }
+    uint32_t getDelivered() const { return delivered; }
+    uint32_t getDropped() const { return dropped; }  // Thinned out while the queue was full
+    uint16_t getStride() const { return stride; }    // 1 = every reading queued
+    uint32_t getRadioOnMs() const { return radioOnMs; }
+
+private:
+    SendFn send = nullptr;
+    void* context = nullptr;
+    
+    QueuedReading queue[kReportQueueDepth];
+    uint8_t head = 0;
+    uint8_t count = 0;
+    uint16_t stride = 1;      // Keep every stride-th reading
+    uint16_t sinceKept = 0;   // Readings skipped since the last one kept
+    
+    LinkState state = LinkState::Online;
+    uint8_t failures = 0;
+    uint32_t nextAttemptMs = 0;
+    bool backingOff = false;
+    uint32_t rng = 1;
+    
+    uint32_t attempts = 0;
+    uint32_t delivered = 0;
+    uint32_t dropped = 0;
+    uint32_t radioOnMs = 0;
+    
+    void onFailure(uint32_t nowMs);
+    void thin();
+    uint32_t nextRandom();
+};
@@ -1,30 +1,13 @@
 #include "DisplayFactory.h"
-#include "OledStatusDisplay.h"
-#include "RgbLedStatusDisplay.h"
-#include "SerialStatusDisplay.h"
-#include <Wire.h>
+#include "../hardware/I2cBus.h"
 
-StatusDisplay* DisplayFactory::createPrimaryDisplay() {
-  DisplayType bestType = detectBestDisplay();
-  
-  switch (bestType) {
-    case DisplayType::OLED:
-      return createOledDisplay();
-    case DisplayType::RGB_LED:
-      return createRgbLedDisplay();
-    case DisplayType::Serial:
-    default:
-      return createSerialDisplay();
-  }
-}
-
-StatusDisplay* DisplayFactory::createSecondaryDisplay() {
+bool DisplayFactory::wantsSerialSecondary() {
   // Always add serial as secondary display when USB is connected
   if (isUsbConnected() && kEnableSerialWhenUsbConnected) {
     Serial.println("[Display] Adding Serial as secondary display (USB connected)");
-    return createSerialDisplay();
+    return true;
   }
-  return nullptr; // No secondary display needed
+  return false; // No secondary display needed
 }
 
 DisplayFactory::DisplayType DisplayFactory::detectBestDisplay() {
@@ -47,8 +30,16 @@ bool DisplayFactory::isOledAvailable() {
   Serial.print(kOledI2cAddress, HEX);
   Serial.print("... ");
   
-  Wire.beginTransmission(kOledI2cAddress);
-  uint8_t error = Wire.endTransmission();
+  // Probe through the shared queue and wait for it - detection runs at boot
+  static uint8_t probeStatus;
+  probeStatus = 0xFF;
+  bool queued = i2cBus.probe(kOledI2cAddress, [](uint8_t status, void* context) {
+    *static_cast<uint8_t*>(context) = status;
+  }, &probeStatus);
+  if (queued) {
+    i2cBus.flush(kDisplayDetectionTimeout);
+  }
+  uint8_t error = probeStatus;
   bool available = (error == 0);
   
   if (available) {
@@ -76,20 +67,8 @@ bool DisplayFactory::isUsbConnected() {
   return usbConnected;
 }
 
-StatusDisplay* DisplayFactory::createOledDisplay() {
-  return new OledStatusDisplay();
-}
-
-StatusDisplay* DisplayFactory::createRgbLedDisplay() {
-  return new RgbLedStatusDisplay();
-}
-
-StatusDisplay* DisplayFactory::createSerialDisplay() {
-  return new SerialStatusDisplay();
-}
-
 void DisplayFactory::initializeI2cForDetection() {
-  Wire.begin();
+  i2cBus.begin();
   // Brief delay to ensure I2C is ready
   delay(10);
 }
@@ -1,6 +1,9 @@
 #pragma once
 #include "../config/Config.h"
-#include "StatusDisplay.h"
+#include "DisplayPipeline.h"
+#include "OledStatusDisplay.h"
+#include "RgbLedStatusDisplay.h"
+#include "SerialStatusDisplay.h"
 
 class DisplayFactory {
 public:
@@ -11,19 +14,21 @@ public:
     Serial
   };
   
-  // Main factory method
-  static StatusDisplay* createPrimaryDisplay();
-  static StatusDisplay* createSecondaryDisplay(); // For USB serial support
+  // Main factory method - enables the statically allocated sinks in the
+  // pipeline that match the detected hardware. No displays are allocated.
+  template <typename Pipeline>
+  static void configure(Pipeline& pipeline) {
+    DisplayType primary = detectBestDisplay();
+    pipeline.template setEnabled<OledStatusDisplay>(primary == DisplayType::OLED);
+    pipeline.template setEnabled<RgbLedStatusDisplay>(primary == DisplayType::RGB_LED);
+    pipeline.template setEnabled<SerialStatusDisplay>(primary == DisplayType::Serial || wantsSerialSecondary());
+  }
   
   // Detection methods
   static bool isOledAvailable();
   static bool isUsbConnected();
   static DisplayType detectBestDisplay();
-  
-  // Display creation methods
-  static StatusDisplay* createOledDisplay();
-  static StatusDisplay* createRgbLedDisplay();
-  static StatusDisplay* createSerialDisplay();
+  static bool wantsSerialSecondary(); // For USB serial support
   
 private:
   static void initializeI2cForDetection();
@@ -0,0 +1,124 @@
+#pragma once
+#include "StatusDisplay.h"
+#include "StatusEventBus.h"
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Base for statically composed display sinks. Sinks are not polymorphic:
+// every hook has an empty inline default, so a sink that doesn't implement
+// a hook is compiled out of the fan-out entirely. kEventMask lists the
+// events a sink wants; redeclare it in the sink to narrow the subscription.
+class StatusSink {
+public:
+  static constexpr StatusEventMask kEventMask = kAllStatusEvents;
+
+  void begin() {}
+  void handleEvent(StatusEvent event) {}
+  void showMoisture(float percent) {}
+  void showMessage(const char* msg) {}
+  void showBattery(float voltage, bool isLow = false) {}
+  void update() {}
+  void setPowerState(PowerState state) {}
+  uint32_t takeEnergyMicrojoules() { return 0; }
+  void testRed() {}
+  void testGreen() {}
+  void testBlue() {}
+  void testOff() {}
+};
+
+// Compile-time display pipeline. The sink set is fixed by the template
+// arguments and every sink lives inside the pipeline (no heap). Detection
+// only flips enable bits at boot. Fan-out is a direct, inlinable call per
+// sink; the single virtual entry point exists for consumers that hold a
+// StatusDisplay* (e.g. CommissioningManager), and calls on the concrete
+// pipeline object are devirtualized because the class is final.
+template <typename... Sinks>
+class DisplayPipeline final : public StatusDisplay {
+  static_assert(sizeof...(Sinks) <= 8, "enable mask holds at most 8 sinks");
+
+public:
+  void begin() override { forEach([](auto& sink) { sink.begin(); }); }
+  void handleEvent(StatusEvent event) override { handleEvent(event, 0); }
+  // Condition events carry what they report (battery status, fault code)
+  void handleEvent(StatusEvent event, uint8_t payload) {
+    if (!eventBus.admit(event, payload)) {
+      return;  // Repeat of a latched link state or condition
+    }
+    const StatusEventMask bit = statusEventBit(event);
+    forEach([event, bit](auto& sink) {
+      if (std::decay_t<decltype(sink)>::kEventMask & bit) {
+        sink.handleEvent(event);
+      }
+    });
+  }
+  void showMoisture(float percent) override { forEach([percent](auto& sink) { sink.showMoisture(percent); }); }
+  void showMessage(const char* msg) override { forEach([msg](auto& sink) { sink.showMessage(msg); }); }
+  void showBattery(float voltage, bool isLow = false) override {
+    forEach([voltage, isLow](auto& sink) { sink.showBattery(voltage, isLow); });
+  }
+  void update() override { forEach([](auto& sink) { sink.update(); }); }
+  void setPowerState(PowerState state) override { forEach([state](auto& sink) { sink.setPowerState(state); }); }
+  uint32_t takeEnergyMicrojoules() override {
+    uint32_t total = 0;
+    forEach([&total](auto& sink) { total += sink.takeEnergyMicrojoules(); });
+    return total;
+  }
+  void testRed() override { forEach([](auto& sink) { sink.testRed(); }); }
+  void testGreen() override { forEach([](auto& sink) { sink.testGreen(); }); }
+  void testBlue() override { forEach([](auto& sink) { sink.testBlue(); }); }
+  void testOff() override { forEach([](auto& sink) { sink.testOff(); }); }
+
+  // Sink selection - requests for a type not in the pipeline are ignored
+  template <typename Sink>
+  static constexpr bool contains() { return indexOf<Sink>() < sizeof...(Sinks); }
+
+  template <typename Sink>
+  void setEnabled(bool enabled) {
+    if constexpr (contains<Sink>()) {
+      constexpr uint8_t bit = 1u << indexOf<Sink>();
+      enabledMask = enabled ? (enabledMask | bit) : (enabledMask & ~bit);
+    }
+  }
+
+  template <typename Sink>
+  bool isEnabled() const {
+    if constexpr (contains<Sink>()) {
+      return enabledMask & (1u << indexOf<Sink>());
+    }
+    return false;
+  }
+
+  template <typename Sink>
+  Sink& get() { return std::get<Sink>(sinks); }
+
+  bool hasSinks() const { return enabledMask != 0; }
+
+  StatusEventBus& events() { return eventBus; }
+
+private:
+  StatusEventBus eventBus;
+  std::tuple<Sinks...> sinks;
+  uint8_t enabledMask = 0;
+
+  template <typename Sink, size_t I = 0>
+  static constexpr size_t indexOf() {
+    if constexpr (I == sizeof...(Sinks)) {
+      return I;
+    } else if constexpr (std::is_same<Sink, typename std::tuple_element<I, std::tuple<Sinks...>>::type>::value) {
+      return I;
+    } else {
+      return indexOf<Sink, I + 1>();
+    }
+  }
+
+  template <typename Fn>
+  inline void forEach(Fn&& fn) {
+    forEachImpl(fn, std::index_sequence_for<Sinks...>{});
+  }
+
+  template <typename Fn, size_t... I>
+  inline void forEachImpl(Fn& fn, std::index_sequence<I...>) {
+    ((enabledMask & (1u << I) ? fn(std::get<I>(sinks)) : void()), ...);
+  }
+};
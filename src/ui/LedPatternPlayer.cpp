@@ -0,0 +1,138 @@
+#include "LedPatternPlayer.h"
+
+#if LED_PATTERN_HW_TIMER
+#include <em_cmu.h>
+#include <em_letimer.h>
+
+namespace {
+  constexpr uint32_t kLetimerClockHz = 32768;  // LFRCO, available down to EM2
+  LedPatternPlayer* timerOwner = nullptr;      // Only one player owns LETIMER0
+}
+
+// Runs for a few microseconds per edge; the core returns to EM2 afterwards
+extern "C" void LETIMER0_IRQHandler(void) {
+  uint32_t flags = LETIMER_IntGet(LETIMER0);
+  LETIMER_IntClear(LETIMER0, flags);
+  if (timerOwner) {
+    timerOwner->onTimerEdge();
+  }
+}
+#endif
+
+void LedPatternPlayer::begin(OutputFn outputFn, CompleteFn completeFn, void* ctx) {
+  output = outputFn;
+  onComplete = completeFn;
+  context = ctx;
+  playing = false;
+  pattern = nullptr;
+
+#if LED_PATTERN_HW_TIMER
+  CMU_ClockSelectSet(cmuClock_EM23GRPACLK, cmuSelect_LFRCO);
+  CMU_ClockEnable(cmuClock_LETIMER0, true);
+
+  LETIMER_Init_TypeDef init = LETIMER_INIT_DEFAULT;
+  init.enable = false;
+  init.comp0Top = true;  // Counter reloads from COMP0 - one step per underflow
+  LETIMER_Init(LETIMER0, &init);
+  LETIMER_IntClear(LETIMER0, LETIMER_IF_UF);
+  LETIMER_IntEnable(LETIMER0, LETIMER_IEN_UF);
+  NVIC_ClearPendingIRQ(LETIMER0_IRQn);
+  NVIC_EnableIRQ(LETIMER0_IRQn);
+  timerOwner = this;
+#endif
+}
+
+void LedPatternPlayer::play(const LedPattern* newPattern, uint8_t color, uint32_t nowMs,
+                            uint8_t repeatOverride) {
+  noInterrupts();
+  cancelTimer();
+  pattern = newPattern;
+  patternColor = color;
+  stepIndex = 0;
+  repeatsDone = 0;
+  repeatLimit = repeatOverride ? repeatOverride : (newPattern ? newPattern->repeatCount : 0);
+  playing = (newPattern != nullptr);
+  if (playing) {
+    applyStep(nowMs);
+  }
+  interrupts();
+}
+
+void LedPatternPlayer::stop() {
+  noInterrupts();
+  cancelTimer();
+  playing = false;
+  pattern = nullptr;
+  interrupts();
+}
+
+bool LedPatternPlayer::service(uint32_t nowMs) {
+  // Signed difference keeps this correct across millis() rollover
+  while (playing && (int32_t)(nowMs - nextEdgeMs) >= 0) {
+    applyStep(nextEdgeMs);
+  }
+  return playing;
+}
+
+void LedPatternPlayer::onTimerEdge() {
+  if (playing) {
+    applyStep(nextEdgeMs);
+  }
+}
+
+void LedPatternPlayer::applyStep(uint32_t edgeMs) {
+  const LedPattern* current = pattern;
+  if (stepIndex >= current->stepCount) {
+    stepIndex = 0;
+    repeatsDone++;
+    if (current->stepCount == 0 ||
+        (repeatLimit != 0 && repeatsDone >= repeatLimit)) {
+      finish(edgeMs);
+      return;
+    }
+  }
+
+  LedStep step;
+  memcpy_P(&step, &current->steps[stepIndex], sizeof(LedStep));
+  uint16_t duration = step.durationMs ? step.durationMs : 1;  // Never stall on a zero step
+
+  if (output) {
+    output(step.color == LED_STEP_PATTERN_COLOR ? patternColor : step.color, edgeMs, context);
+  }
+  nextEdgeMs = edgeMs + duration;
+  stepIndex++;
+  scheduleTimer(duration);
+}
+
+void LedPatternPlayer::finish(uint32_t edgeMs) {
+  const LedPattern* finished = pattern;
+  playing = false;
+  cancelTimer();
+  if (output) {
+    output(0, edgeMs, context);  // Patterns always end dark
+  }
+  if (onComplete) {
+    onComplete(finished, context);
+  }
+}
+
+void LedPatternPlayer::scheduleTimer(uint16_t durationMs) {
+#if LED_PATTERN_HW_TIMER
+  uint32_t ticks = ((uint32_t)durationMs * kLetimerClockHz) / 1000;
+  if (ticks == 0) ticks = 1;
+  LETIMER_Enable(LETIMER0, false);
+  LETIMER_CompareSet(LETIMER0, 0, ticks);
+  LETIMER_CounterSet(LETIMER0, ticks);
+  LETIMER_IntClear(LETIMER0, LETIMER_IF_UF);
+  LETIMER_Enable(LETIMER0, true);
+#else
+  (void)durationMs;
+#endif
+}
+
+void LedPatternPlayer::cancelTimer() {
+#if LED_PATTERN_HW_TIMER
+  LETIMER_Enable(LETIMER0, false);
+  LETIMER_IntClear(LETIMER0, LETIMER_IF_UF);
+#endif
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <Arduino.h>
+
+// Hardware timer backend selection. On the MG24 the LETIMER runs from the
+// low-frequency clock and keeps counting in EM2, so patterns keep playing
+// while the CPU sleeps. Other targets fall back to polling from update().
+#if defined(ARDUINO_ARCH_SILABS) && __has_include(<em_letimer.h>)
+#define LED_PATTERN_HW_TIMER 1
+#else
+#define LED_PATTERN_HW_TIMER 0
+#endif
+
+// Step color placeholder - replaced by the color passed to play()
+constexpr uint8_t LED_STEP_PATTERN_COLOR = 0xFF;
+
+// One step of a declarative LED pattern: hold a color for a duration
+struct LedStep {
+  uint8_t color;        // ColorIndex value or LED_STEP_PATTERN_COLOR
+  uint16_t durationMs;
+};
+
+// Pattern descriptor - steps live in PROGMEM
+struct LedPattern {
+  const LedStep* steps;
+  uint8_t stepCount;
+  uint8_t repeatCount;  // 0 = repeat forever
+};
+
+// Plays LedPattern sequences edge by edge. All timing is computed from the
+// scheduled edge times rather than the time the edge was serviced, so the
+// sequence does not drift and can be stepped in virtual time off-target.
+class LedPatternPlayer {
+public:
+  typedef void (*OutputFn)(uint8_t color, uint32_t edgeMs, void* context);
+  typedef void (*CompleteFn)(const LedPattern* pattern, void* context);
+
+  void begin(OutputFn output, CompleteFn onComplete, void* context);
+
+  // Start a pattern; any pattern already playing is replaced silently.
+  // repeatOverride replaces the pattern's own repeat count when non-zero.
+  void play(const LedPattern* pattern, uint8_t patternColor, uint32_t nowMs,
+            uint8_t repeatOverride = 0);
+  void stop();
+
+  bool isPlaying() const { return playing; }
+  const LedPattern* getPattern() const { return pattern; }
+  uint32_t getNextEdgeMs() const { return nextEdgeMs; }
+  bool usesHardwareTimer() const { return LED_PATTERN_HW_TIMER != 0; }
+
+  // Process every edge due at or before nowMs. Safe to call with virtual time.
+  // Returns true while the pattern is still playing.
+  bool service(uint32_t nowMs);
+
+  // Main-loop hook - services edges only when no hardware timer is driving us
+  void poll(uint32_t nowMs) {
+    if (!LED_PATTERN_HW_TIMER) service(nowMs);
+  }
+
+  // Called from the LETIMER interrupt handler
+  void onTimerEdge();
+
+private:
+  OutputFn output = nullptr;
+  CompleteFn onComplete = nullptr;
+  void* context = nullptr;
+
+  const LedPattern* volatile pattern = nullptr;
+  uint8_t patternColor = 0;
+  uint8_t stepIndex = 0;
+  uint8_t repeatsDone = 0;
+  uint8_t repeatLimit = 0;
+  volatile bool playing = false;
+  volatile uint32_t nextEdgeMs = 0;  // Advanced from the LETIMER interrupt
+
+  void applyStep(uint32_t edgeMs);
+  void finish(uint32_t edgeMs);
+  void scheduleTimer(uint16_t durationMs);
+  void cancelTimer();
+};
@@ -1,12 +1,91 @@
 #include "OledStatusDisplay.h"
+#include "../hardware/I2cBus.h"
 #include <U8g2lib.h>
-#include <Wire.h>
 
-U8G2_SSD1306_128X64_NONAME_F_HW_I2C display(U8G2_R0, /* reset=*/U8X8_PIN_NONE);
+// U8g2 byte driver that queues each transfer on the shared I2C bus instead
+// of blocking in Wire. Transfers longer than one queue slot are split with
+// the SSD1306 control byte repeated, which the controller accepts.
+//
+// The driver never waits for the bus: a transfer that finds the queue full
+// is dropped and flagged, and the caller keeps those tiles dirty so update()
+// sends them again. Tile pushes set their own position, so a resend is safe.
+static uint8_t oledTransfer[kI2cMaxPayload];
+static uint8_t oledTransferLength = 0;
+static bool oledTransferDropped = false;
+
+static void queueOledTransfer(u8x8_t* u8x8) {
+  if (!i2cBus.write(u8x8_GetI2CAddress(u8x8) >> 1, oledTransfer, oledTransferLength)) {
+    oledTransferDropped = true;
+  }
+}
+
+static uint8_t oledByteCallback(u8x8_t* u8x8, uint8_t msg, uint8_t argInt, void* argPtr) {
+  switch (msg) {
+    case U8X8_MSG_BYTE_INIT:
+      i2cBus.begin();
+      break;
+    case U8X8_MSG_BYTE_SET_DC:
+      break;
+    case U8X8_MSG_BYTE_START_TRANSFER:
+      oledTransferLength = 0;
+      break;
+    case U8X8_MSG_BYTE_SEND: {
+      const uint8_t* data = static_cast<const uint8_t*>(argPtr);
+      while (argInt-- > 0) {
+        if (oledTransferLength == kI2cMaxPayload) {
+          queueOledTransfer(u8x8);
+          oledTransferLength = 1;  // Keep the control byte for the continuation
+        }
+        oledTransfer[oledTransferLength++] = *data++;
+      }
+      break;
+    }
+    case U8X8_MSG_BYTE_END_TRANSFER:
+      queueOledTransfer(u8x8);
+      break;
+    default:
+      return 0;
+  }
+  return 1;
+}
+
+class OledI2cDisplay : public U8G2 {
+public:
+  OledI2cDisplay() : U8G2() {
+#ifdef OLED_PAGE_BUFFER
+    u8g2_Setup_ssd1306_i2c_128x64_noname_1(&u8g2, U8G2_R0, oledByteCallback, u8x8_gpio_and_delay_arduino);
+#else
+    u8g2_Setup_ssd1306_i2c_128x64_noname_f(&u8g2, U8G2_R0, oledByteCallback, u8x8_gpio_and_delay_arduino);
+#endif
+    u8x8_SetPin_HW_I2C(getU8x8(), U8X8_PIN_NONE, U8X8_PIN_NONE, U8X8_PIN_NONE);
+    setI2CAddress(kOledI2cAddress << 1);
+  }
+};
+
+static OledI2cDisplay display;
+
+// Queue slots needed to push a run of tiles: one command transfer plus
+// data in 24-byte chunks (U8g2 fast I2C CAD)
+static inline uint8_t slotsForTiles(uint8_t tiles) {
+  return 1 + (tiles * 8 + 23) / 24;
+}
+
+// SSD1306 init sequence plus the power-save command, with room to spare
+constexpr uint8_t kOledInitSlots = 4;
+
+// Scene layout (pixels)
+constexpr int16_t kMessageBaseline = 32;
+constexpr int16_t kBatteryX = 110;
+constexpr int16_t kBatteryY = 2;
+constexpr int16_t kValueX = 0, kValueY = 20, kValueW = 60, kValueH = 20;
+constexpr int16_t kBarX = 14, kBarY = 45, kBarW = 100, kBarH = 8;
 
 void OledStatusDisplay::begin() {
-  display.begin();
+  // The init sequence goes out from pushDirtyTiles() once the queue has
+  // room; the first full push then replaces whatever the panel RAM holds
+  panelReady = false;
   display.setFont(u8g2_font_6x10_tf);
+  markAllDirty();
   drawCentered("OLED initialized");
 }
 
@@ -48,37 +127,19 @@ void OledStatusDisplay::handleEvent(StatusEvent event) {
 }
 
 void OledStatusDisplay::showMoisture(float percent) {
-  display.clearBuffer();
-  
-  // Title
-  display.setCursor(0, 12);
-  display.print("Soil Moisture");
-  
-  // Large percentage display
-  display.setFont(u8g2_font_10x20_tf);  // Larger font for percentage
-  display.setCursor(0, 35);
-  display.print(percent, 1);
-  display.print("%");
-  
-  // Progress bar
-  int barWidth = 100;
-  int barHeight = 8;
-  int barX = 14;
-  int barY = 45;
-  
-  // Draw bar outline
-  display.drawFrame(barX, barY, barWidth, barHeight);
-  
-  // Fill bar based on percentage
-  int fillWidth = (percent / 100.0) * (barWidth - 2);
-  if (fillWidth > 0) {
-    display.drawBox(barX + 1, barY + 1, fillWidth, barHeight - 2);
+  int16_t tenths = (int16_t)(constrain(percent, 0.0, 100.0) * 10.0 + 0.5);
+
+  if (screen != Screen::Moisture) {
+    screen = Screen::Moisture;
+    markAllDirty();
+  } else if (tenths != moistureTenths) {
+    // Only the value and the bar change between readings
+    markDirty(kValueX, kValueY, kValueW, kValueH);
+    markDirty(kBarX, kBarY, kBarW, kBarH);
   }
-  
-  // Restore normal font
-  display.setFont(u8g2_font_6x10_tf);
-  
-  display.sendBuffer();
+  moistureTenths = tenths;
+
+  flush();
 }
 
 void OledStatusDisplay::showMessage(const char* msg) {
@@ -86,44 +147,188 @@ void OledStatusDisplay::showMessage(const char* msg) {
 }
 
 void OledStatusDisplay::update() {
-  // No periodic update logic required
+  // Continue a flush that was waiting for I2C queue space
+  pushDirtyTiles();
 }
 
 void OledStatusDisplay::showBattery(float voltage, bool isLow) {
-  // Add battery icon in top-right corner of current display
-  drawBatteryIcon(110, 2, voltage, isLow);
+  // Calculate fill level (assuming 3.0V-4.2V range)
+  float fillPercent = constrain((voltage - 3.0) / 1.2, 0.0, 1.0);
+  uint8_t fill = fillPercent * 10;
+
+  // Blink effect for low battery - toggles at most every 500 ms
+  bool blinkOn = true;
+  if (isLow) {
+    blinkOn = batteryBlinkOn;
+    if (millis() - lastBatteryBlink > 500) {
+      blinkOn = !batteryBlinkOn;
+      lastBatteryBlink = millis();
+    }
+  }
+
+  if (!batteryShown || fill != batteryFill || blinkOn != batteryBlinkOn) {
+    markDirty(kBatteryX, kBatteryY, 14, 6);
+  }
+  batteryShown = true;
+  batteryFill = fill;
+  batteryBlinkOn = blinkOn;
+
+  flush();
 }
 
-void OledStatusDisplay::drawBatteryIcon(int x, int y, float voltage, bool isLow) {
+void OledStatusDisplay::drawBatteryIcon(int x, int y) {
   // Draw battery outline (12x6 pixels)
   display.drawFrame(x, y, 12, 6);
   display.drawBox(x + 12, y + 1, 2, 4);  // Battery terminal
-  
-  // Calculate fill level (assuming 3.0V-4.2V range)
-  float fillPercent = constrain((voltage - 3.0) / 1.2, 0.0, 1.0);
-  int fillWidth = fillPercent * 10;
-  
-  if (isLow) {
-    // Blink effect for low battery (simple implementation)
-    static unsigned long lastBlink = 0;
-    static bool blinkState = false;
-    if (millis() - lastBlink > 500) {
-      blinkState = !blinkState;
-      lastBlink = millis();
+
+  if (batteryBlinkOn && batteryFill > 0) {
+    display.drawBox(x + 1, y + 1, batteryFill, 4);
+  }
+}
+
+void OledStatusDisplay::drawCentered(const char* msg) {
+  if (screen != Screen::Message) {
+    screen = Screen::Message;
+    markAllDirty();
+  } else if (strncmp(message, msg, OLED_MESSAGE_MAX) == 0) {
+    return;  // Same text already on the panel - nothing to send
+  } else {
+    markTextDirty(message);  // Erase the old text
+  }
+
+  strncpy(message, msg, OLED_MESSAGE_MAX);
+  message[OLED_MESSAGE_MAX] = '\0';
+  markTextDirty(message);
+
+  flush();
+}
+
+// Draws the whole scene; the U8g2 page window clips it in page-buffer mode
+void OledStatusDisplay::renderScene() {
+  switch (screen) {
+    case Screen::Message: {
+      int16_t x = (128 - strlen(message) * 6) / 2;
+      display.setCursor(x, kMessageBaseline);
+      display.print(message);
+      break;
     }
-    if (blinkState && fillWidth > 0) {
-      display.drawBox(x + 1, y + 1, fillWidth, 4);
+
+    case Screen::Moisture: {
+      // Title
+      display.setCursor(0, 12);
+      display.print("Soil Moisture");
+
+      // Large percentage display
+      display.setFont(u8g2_font_10x20_tf);  // Larger font for percentage
+      display.setCursor(0, 35);
+      display.print(moistureTenths / 10.0, 1);
+      display.print("%");
+
+      // Draw bar outline and fill based on percentage
+      display.drawFrame(kBarX, kBarY, kBarW, kBarH);
+      int fillWidth = (moistureTenths * (kBarW - 2)) / 1000;
+      if (fillWidth > 0) {
+        display.drawBox(kBarX + 1, kBarY + 1, fillWidth, kBarH - 2);
+      }
+
+      // Restore normal font
+      display.setFont(u8g2_font_6x10_tf);
+      break;
     }
-  } else if (fillWidth > 0) {
-    display.drawBox(x + 1, y + 1, fillWidth, 4);
+
+    case Screen::Blank:
+    default:
+      break;
+  }
+
+  if (batteryShown) {
+    drawBatteryIcon(kBatteryX, kBatteryY);
   }
 }
 
-void OledStatusDisplay::drawCentered(const char* msg) {
+void OledStatusDisplay::markDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
+  int16_t x1 = constrain(x + w - 1, 0, 127);
+  int16_t y1 = constrain(y + h - 1, 0, 63);
+  x = constrain(x, 0, 127);
+  y = constrain(y, 0, 63);
+
+  uint16_t columns = 0;
+  for (uint8_t tx = x / 8; tx <= x1 / 8; tx++) {
+    columns |= (1u << tx);
+  }
+  for (uint8_t ty = y / 8; ty <= y1 / 8; ty++) {
+    dirtyTiles[ty] |= columns;
+  }
+}
+
+void OledStatusDisplay::markTextDirty(const char* msg) {
+  size_t len = strlen(msg);
+  if (len > 0) {
+    // 6x10 font: glyphs reach 8 px above and 2 px below the baseline
+    markDirty((128 - len * 6) / 2, kMessageBaseline - 8, len * 6, 11);
+  }
+}
+
+void OledStatusDisplay::markAllDirty() {
+  for (uint8_t row = 0; row < OLED_TILE_ROWS; row++) {
+    dirtyTiles[row] = 0xFFFF;
+  }
+}
+
+// Sends only the tiles that changed. Full-buffer builds re-render into RAM
+// (cheap) and push dirty tile runs; page-buffer builds render and push each
+// dirty page in turn.
+void OledStatusDisplay::flush() {
+#ifndef OLED_PAGE_BUFFER
   display.clearBuffer();
-  int16_t x = (128 - strlen(msg) * 6) / 2;
-  int16_t y = 32;
-  display.setCursor(x, y);
-  display.print(msg);
-  display.sendBuffer();
+  renderScene();
+#endif
+  pushDirtyTiles();
+}
+
+// Queues as many dirty runs as the I2C queue has room for; update() picks
+// up the rest so a full-screen change never blocks the loop
+void OledStatusDisplay::pushDirtyTiles() {
+  if (!panelReady) {
+    if (i2cBus.freeSlots() < kOledInitSlots) return;
+    oledTransferDropped = false;
+    display.initDisplay();
+    display.setPowerSave(0);
+    if (oledTransferDropped) return;  // Sensor traffic took the room - resend the whole sequence
+    panelReady = true;
+  }
+  
+  for (uint8_t row = 0; row < OLED_TILE_ROWS; row++) {
+#ifdef OLED_PAGE_BUFFER
+    if (dirtyTiles[row] == 0) continue;
+    if (i2cBus.freeSlots() < slotsForTiles(OLED_TILE_COLUMNS)) return;
+    oledTransferDropped = false;
+    display.setBufferCurrTileRow(row);
+    display.clearBuffer();
+    renderScene();
+    display.sendBuffer();
+    if (oledTransferDropped) return;  // Page stays dirty for the next update()
+    dirtyTiles[row] = 0;
+#else
+    uint8_t tx = 0;
+    while (dirtyTiles[row] != 0 && tx < OLED_TILE_COLUMNS) {
+      if (!(dirtyTiles[row] & (1u << tx))) {
+        tx++;
+        continue;
+      }
+      // Send each contiguous run of dirty tiles as one transfer
+      uint8_t start = tx;
+      uint16_t run = 0;
+      while (tx < OLED_TILE_COLUMNS && (dirtyTiles[row] & (1u << tx))) {
+        run |= (1u << tx);
+        tx++;
+      }
+      if (i2cBus.freeSlots() < slotsForTiles(tx - start)) return;
+      oledTransferDropped = false;
+      display.updateDisplayArea(start, row, tx - start, 1);
+      if (oledTransferDropped) return;  // Run stays dirty for the next update()
+      dirtyTiles[row] &= ~run;
+    }
+#endif
+  }
 }
@@ -1,18 +1,52 @@
 // OledStatusDisplay.h
 
 #pragma once
-#include "StatusDisplay.h"
+#include "DisplayPipeline.h"
 
-class OledStatusDisplay : public StatusDisplay {
+// 128x64 panel = 16 x 8 tiles of 8x8 pixels (one tile row = one SSD1306 page)
+constexpr uint8_t OLED_TILE_COLUMNS = 16;
+constexpr uint8_t OLED_TILE_ROWS = 8;
+constexpr uint8_t OLED_MESSAGE_MAX = 21;  // 128 px / 6 px font
+
+class OledStatusDisplay : public StatusSink {
 public:
-  void begin() override;
-  void handleEvent(StatusEvent event) override;
-  void showMoisture(float percent) override;
-  void showMessage(const char* msg) override;
-  void showBattery(float voltage, bool isLow = false) override;
-  void update() override;
+  // Events that have a message on the panel
+  static constexpr StatusEventMask kEventMask = statusEventMask(
+      StatusEvent::BootStarting, StatusEvent::BootSensorInit, StatusEvent::BootNetworkInit,
+      StatusEvent::BootMatterInit, StatusEvent::BootComplete,
+      StatusEvent::ThreadConnected, StatusEvent::ThreadDisconnected,
+      StatusEvent::MatterOnline, StatusEvent::MatterOffline,
+      StatusEvent::BatteryLow, StatusEvent::Error, StatusEvent::MoisturePublished);
+
+  void begin();
+  void handleEvent(StatusEvent event);
+  void showMoisture(float percent);
+  void showMessage(const char* msg);
+  void showBattery(float voltage, bool isLow = false);
+  void update();
 
 private:
+  // Retained scene model - the frame is always re-rendered from this, so
+  // page-buffer builds can redraw any page without a frame buffer
+  enum class Screen : uint8_t { Blank, Message, Moisture };
+  Screen screen = Screen::Blank;
+  char message[OLED_MESSAGE_MAX + 1] = "";
+  int16_t moistureTenths = -1;
+  bool batteryShown = false;
+  bool batteryBlinkOn = true;
+  uint8_t batteryFill = 0;        // 0-10 pixels
+  uint32_t lastBatteryBlink = 0;
+
+  // One bit per tile column for each tile row
+  uint16_t dirtyTiles[OLED_TILE_ROWS] = {};
+  bool panelReady = false;  // Init sequence queued - tiles may follow
+
   void drawCentered(const char* msg);
-  void drawBatteryIcon(int x, int y, float voltage, bool isLow);
+  void drawBatteryIcon(int x, int y);
+  void renderScene();
+  void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+  void markTextDirty(const char* msg);
+  void markAllDirty();
+  void flush();
+  void pushDirtyTiles();
 };
@@ -13,8 +13,16 @@ void RgbLedStatusDisplay::begin() {
   pinMode(PIN_G, OUTPUT);  // Green  
   pinMode(PIN_B, OUTPUT);  // Blue
   
+  player.begin(onPatternOutput, onPatternComplete, this);
+  
+  LedPowerBudget budget;
+  memcpy_P(&budget, &LED_POWER_BUDGET[static_cast<uint8_t>(PowerState::Booting)], sizeof(LedPowerBudget));
+  applyPowerBudget(budget);
+  
   currentState = LEDState::OFF;
-  setColor(false, false, false);
+  noInterrupts();
+  showColor(0, millis());
+  interrupts();
   isInitialized = true;  // Enable update() processing
   LOG_LED("LED off - ready");
 }
@@ -33,9 +41,8 @@ void RgbLedStatusDisplay::handleEvent(StatusEvent event) {
   switch (event) {
     case StatusEvent::BootStarting:
       LOG_LED("BOOT STARTING - setting green with timeout");
-      currentState = LEDState::BOOT_GREEN;
-      moistureBlinker.start(now, BOOT_HOLD_MS, 1);  // Single "blink" for timeout
-      setColor(RGBColor(ColorIndex::GREEN));
+      linkFailed = false;
+      playState(LEDState::BOOT_GREEN, now);
       break;
       
     case StatusEvent::BootSensorInit:
@@ -44,34 +51,32 @@ void RgbLedStatusDisplay::handleEvent(StatusEvent event) {
       // Keep green LED on during boot phases
       if (currentState != LEDState::BOOT_GREEN) {
         LOG_LED("Boot phase - ensuring green is on");
-        currentState = LEDState::BOOT_GREEN;
-        setColor(RGBColor(ColorIndex::GREEN));
+        playState(LEDState::BOOT_GREEN, now);
       }
       break;
       
     case StatusEvent::BootComplete:
       LOG_LED("BOOT COMPLETE - turning off");
-      currentState = LEDState::OFF;
-      setColor(RGBColor(ColorIndex::OFF));
+      playState(LEDState::OFF, now);
       break;
     
     case StatusEvent::ThreadConnectionFailed:
     case StatusEvent::MatterConnectionFailed:
+      linkFailed = true;
+      // fall through
     case StatusEvent::Error:
       if (currentState != LEDState::CONNECTION_FAILURE) {
         LOG_LED("CONNECTION FAILURE - starting red blink");
-        currentState = LEDState::CONNECTION_FAILURE;
-        failureBlinker.start(now, FAILURE_BLINK_MS);
-        setColor(RGBColor(ColorIndex::RED));
+        playState(LEDState::CONNECTION_FAILURE, now);
       }
       break;
     
     case StatusEvent::ThreadConnected:
     case StatusEvent::MatterOnline:
+      linkFailed = false;
       if (currentState == LEDState::CONNECTION_FAILURE) {
         LOG_LED("CONNECTION RESTORED - turning off");
-        currentState = LEDState::OFF;
-        setColor(RGBColor(ColorIndex::OFF));
+        playState(LEDState::OFF, now);
       }
       break;
     
@@ -82,60 +87,44 @@ void RgbLedStatusDisplay::handleEvent(StatusEvent event) {
     
     case StatusEvent::EnteringSleep:
       LOG_LED("FORCE SLEEP - stopping all blinks");
+      linkFailed = false;  // The bus re-sends link state after sleep
       // Force everything off immediately - no exceptions
-      currentState = LEDState::OFF;
-      moistureBlinker.count = 0; // Stop any ongoing moisture blinks
-      failureBlinker.count = 0;  // Stop any ongoing failure blinks  
-      batteryBlinker.count = 0;  // Stop battery blinks
-      setColor(RGBColor(ColorIndex::OFF));
+      playState(LEDState::OFF, now);
       break;
     
     case StatusEvent::BatteryLow:
       LOG_LED("BATTERY LOW - starting flash sequence");
-      // Use dedicated battery blinker to prevent conflicts
-      batteryBlinker.start(now, BATTERY_FLASH_MS, 1);
-      blinkColor = RGBColor(ColorIndex::RED);
+      // Overlay a single flash; the current state pattern resumes afterwards
+      player.play(&BATTERY_PATTERN, 0, now);
       break;
       
     // Commissioning events - future-proof structure
     case StatusEvent::CommissioningButtonPressed:
     case StatusEvent::CommissioningModeActive:
       LOG_LED("COMMISSIONING MODE - fast white blink");
-      currentState = LEDState::COMMISSIONING_READY;
-      stateStartTime = now;
-      commissioningBlinker.start(now, COMMISSIONING_FAST_BLINK_MS);
-      setColor(RGBColor(ColorIndex::WHITE));
+      playState(LEDState::COMMISSIONING_READY, now);
       break;
       
     case StatusEvent::CommissioningInProgress:
       LOG_LED("COMMISSIONING ACTIVE - slow green blink");
-      currentState = LEDState::COMMISSIONING_ACTIVE;
-      stateStartTime = now;
-      commissioningBlinker.start(now, COMMISSIONING_SLOW_BLINK_MS);
-      setColor(RGBColor(ColorIndex::GREEN));
+      playState(LEDState::COMMISSIONING_ACTIVE, now);
       break;
       
     case StatusEvent::CommissioningSuccess:
       LOG_LED("COMMISSIONING SUCCESS - solid green hold");
-      currentState = LEDState::COMMISSIONING_SUCCESS;
-      stateStartTime = now;
-      commissioningBlinker.start(now, COMMISSIONING_SUCCESS_HOLD_MS, 1); // Single timeout
-      setColor(RGBColor(ColorIndex::GREEN));
+      playState(LEDState::COMMISSIONING_SUCCESS, now);
       break;
       
     case StatusEvent::CommissioningFailed:
     case StatusEvent::CommissioningTimeout:
       LOG_LED("COMMISSIONING FAILED - fast red blink");
-      currentState = LEDState::COMMISSIONING_FAILED;
-      stateStartTime = now;
-      commissioningBlinker.start(now, COMMISSIONING_FAST_BLINK_MS, 10); // 10 fast blinks then off
-      setColor(RGBColor(ColorIndex::RED));
+      playState(LEDState::COMMISSIONING_FAILED, now);
       break;
       
     case StatusEvent::FactoryReset:
       LOG_LED("FACTORY RESET - returning to OFF");
-      currentState = LEDState::OFF;
-      setColor(RGBColor(ColorIndex::OFF));
+      linkFailed = false;
+      playState(LEDState::OFF, now);
       break;
       
     default:
@@ -145,13 +134,14 @@ void RgbLedStatusDisplay::handleEvent(StatusEvent event) {
 }
 
 void RgbLedStatusDisplay::showMoisture(float percent) {
+  if (moistureBlinks == 0) {
+    LOG_LED("Moisture blinks suppressed by power budget");
+    return;
+  }
   LOG_LED("Moisture reading - starting blink sequence");
   
-  ColorIndex colorIndex = getMoistureColorIndex(percent);
-  currentState = LEDState::MOISTURE_BLINKING;
-  moistureBlinker.start(millis(), BLINK_DURATION_MS, MOISTURE_BLINK_COUNT);
-  blinkColor = RGBColor(colorIndex);
-  setColor(RGBColor(ColorIndex::OFF)); // Start with LED off
+  blinkColor = RGBColor(getMoistureColorIndex(percent));
+  playState(LEDState::MOISTURE_BLINKING, millis());
 }
 
 void RgbLedStatusDisplay::showMessage(const char* msg) {
@@ -184,156 +174,191 @@ ColorIndex RgbLedStatusDisplay::getMoistureColorIndex(float percent) {
 
 void RgbLedStatusDisplay::update() {
   // Safety check - skip if not initialized
-  if (!isInitialized) {
+  if (!isInitialized || currentState == LEDState::TEST_MODE) {
     return;
   }
   
   uint32_t now = millis();
   
-  // Single structured update with one return point
-  bool continueProcessing = true;
+  // Edges are driven by LETIMER on hardware; this only services the fallback
+  player.poll(now);
   
-  // Skip all state machine logic if in test mode
-  if (currentState == LEDState::TEST_MODE) {
-    continueProcessing = false;
+  // PWM duties are never written from the timer interrupt
+  if (pwmPending) {
+    noInterrupts();
+    writeDuty(colorDuty[activeColor]);
+    pwmPending = false;
+    interrupts();
   }
   
-  // Handle boot timeout (replaces BOOT_GREEN_HOLD state)
-  if (continueProcessing && currentState == LEDState::BOOT_GREEN && moistureBlinker.ready(now)) {
-    if (!moistureBlinker.flip(now)) {
-      // Boot timeout complete
-      currentState = LEDState::OFF;
-      setColor(RGBColor(ColorIndex::OFF));
-      LOG_LED("Boot timeout complete - LED OFF");
+  // Completion is flagged from the timer callback and handled here, outside
+  // interrupt context. Ignore it if another pattern has started since.
+  const LedPattern* finished = finishedPattern;
+  if (finished && !player.isPlaying()) {
+    finishedPattern = nullptr;
+    if (finished == &BATTERY_PATTERN) {
+      // Battery flash overlay done - resume whatever the state was showing,
+      // keeping its start time so the commissioning timeout still runs
+      startPattern(currentState, now);
+    } else {
+      LOG_LED_STATE("Pattern complete - back to idle, state was ", currentState);
+      if (linkFailed) {
+        playState(LEDState::CONNECTION_FAILURE, now);  // Keep showing the outage
+      } else {
+        currentState = LEDState::OFF;
+      }
     }
   }
   
-  // Handle moisture blinks
-  if (continueProcessing && currentState == LEDState::MOISTURE_BLINKING && moistureBlinker.ready(now)) {
-    if (moistureBlinker.phase) {
-      setColor(RGBColor(ColorIndex::OFF));
-    } else {
-      setColor(blinkColor);
-    }
-    
-    if (!moistureBlinker.flip(now)) {
-      // Blink sequence complete
-      currentState = LEDState::OFF;
-      setColor(RGBColor(ColorIndex::OFF));
-      LOG_LED("Moisture blinks complete - LED OFF");
+  // Commissioning timeouts
+  if (now - stateStartTime > COMMISSIONING_TIMEOUT_MS) {
+    if (currentState == LEDState::COMMISSIONING_READY) {
+      LOG_LED("Commissioning timeout - returning to idle");
+      playState(idleState(), now);
+    } else if (currentState == LEDState::COMMISSIONING_ACTIVE) {
+      LOG_LED("Commissioning timeout - failed");
+      playState(LEDState::COMMISSIONING_FAILED, now);
     }
   }
+}
+
+void RgbLedStatusDisplay::playState(LEDState state, uint32_t now) {
+  currentState = state;
+  stateStartTime = now;
+  finishedPattern = nullptr;
+  startPattern(state, now);
+}
+
+void RgbLedStatusDisplay::startPattern(LEDState state, uint32_t now) {
+  const LedPattern* pattern = nullptr;
+  switch (state) {
+    case LEDState::BOOT_GREEN:            pattern = &BOOT_PATTERN; break;
+    case LEDState::MOISTURE_BLINKING:     pattern = &MOISTURE_PATTERN; break;
+    case LEDState::CONNECTION_FAILURE:    pattern = &FAILURE_PATTERN; break;
+    case LEDState::COMMISSIONING_READY:   pattern = &COMMISSIONING_READY_PATTERN; break;
+    case LEDState::COMMISSIONING_ACTIVE:  pattern = &COMMISSIONING_ACTIVE_PATTERN; break;
+    case LEDState::COMMISSIONING_SUCCESS: pattern = &COMMISSIONING_SUCCESS_PATTERN; break;
+    case LEDState::COMMISSIONING_FAILED:  pattern = &COMMISSIONING_FAILED_PATTERN; break;
+    case LEDState::OFF:
+    case LEDState::TEST_MODE:
+    default:
+      break;
+  }
   
-  // Handle connection failure blinks
-  if (continueProcessing && currentState == LEDState::CONNECTION_FAILURE && failureBlinker.ready(now)) {
-    if (failureBlinker.phase) {
-      setColor(RGBColor(ColorIndex::OFF));
-    } else {
-      setColor(RGBColor(ColorIndex::RED));
-    }
-    failureBlinker.flip(now); // Infinite blink
+  if (pattern) {
+    uint8_t repeats = (state == LEDState::MOISTURE_BLINKING) ? moistureBlinks : 0;
+    player.play(pattern, static_cast<uint8_t>(blinkColor.index), now, repeats);
+  } else {
+    player.stop();
+    noInterrupts();
+    showColor(0, now);
+    interrupts();
+  }
+}
+
+// Called from the LETIMER interrupt on hardware - records the step only
+void RgbLedStatusDisplay::onPatternOutput(uint8_t color, uint32_t edgeMs, void* context) {
+  static_cast<RgbLedStatusDisplay*>(context)->showColor(color, edgeMs);
+}
+
+void RgbLedStatusDisplay::showColor(uint8_t color, uint32_t edgeMs) {
+  if (color >= LED_COLOR_COUNT) {
+    color = 0;
   }
+  int32_t lit = (int32_t)(edgeMs - activeSinceMs);
+  if (lit > 0) {
+    colorOnMs[activeColor] += (uint32_t)lit;
+  }
+  activeColor = color;
+  activeSinceMs = edgeMs;
   
-  // Handle commissioning states
-  if (continueProcessing && commissioningBlinker.ready(now)) {
-    switch (currentState) {
-      case LEDState::COMMISSIONING_READY:
-        // Fast white blink - check timeout
-        if (now - stateStartTime > COMMISSIONING_TIMEOUT_MS) {
-          LOG_LED("Commissioning timeout - returning to OFF");
-          currentState = LEDState::OFF;
-          setColor(RGBColor(ColorIndex::OFF));
-        } else {
-          // Continue blinking
-          if (commissioningBlinker.phase) {
-            setColor(RGBColor(ColorIndex::OFF));
-          } else {
-            setColor(RGBColor(ColorIndex::WHITE));
-          }
-          commissioningBlinker.flip(now);
-        }
-        break;
-        
-      case LEDState::COMMISSIONING_ACTIVE:
-        // Slow green blink - check timeout
-        if (now - stateStartTime > COMMISSIONING_TIMEOUT_MS) {
-          LOG_LED("Commissioning timeout - failed");
-          currentState = LEDState::COMMISSIONING_FAILED;
-          commissioningBlinker.start(now, COMMISSIONING_FAST_BLINK_MS, 10);
-          setColor(RGBColor(ColorIndex::RED));
-        } else {
-          // Continue blinking
-          if (commissioningBlinker.phase) {
-            setColor(RGBColor(ColorIndex::OFF));
-          } else {
-            setColor(RGBColor(ColorIndex::GREEN));
-          }
-          commissioningBlinker.flip(now);
-        }
-        break;
-        
-      case LEDState::COMMISSIONING_SUCCESS:
-        // Solid green hold with timeout
-        if (!commissioningBlinker.flip(now)) {
-          LOG_LED("Commissioning success display complete - OFF");
-          currentState = LEDState::OFF;
-          setColor(RGBColor(ColorIndex::OFF));
-        }
-        break;
-        
-      case LEDState::COMMISSIONING_FAILED:
-        // Fast red blinks with count limit
-        if (commissioningBlinker.phase) {
-          setColor(RGBColor(ColorIndex::OFF));
-        } else {
-          setColor(RGBColor(ColorIndex::RED));
-        }
-        
-        if (!commissioningBlinker.flip(now)) {
-          LOG_LED("Commissioning failed display complete - OFF");
-          currentState = LEDState::OFF;
-          setColor(RGBColor(ColorIndex::OFF));
-        }
-        break;
-        
-      default:
-        // Not a commissioning state - continue
-        break;
-    }
+  const ChannelDuty& duty = colorDuty[color];
+  pwmPending = !duty.isGpio();
+  if (!pwmPending) {
+    writeDuty(duty);
   }
+}
+
+void RgbLedStatusDisplay::writeDuty(const ChannelDuty& duty) {
+  writeChannel(PIN_R, duty.r);
+  writeChannel(PIN_G, duty.g);
+  writeChannel(PIN_B, duty.b);
+}
+
+void RgbLedStatusDisplay::onPatternComplete(const LedPattern* pattern, void* context) {
+  static_cast<RgbLedStatusDisplay*>(context)->finishedPattern = pattern;
+}
+
+void RgbLedStatusDisplay::setPowerState(PowerState state) {
+  uint8_t index = static_cast<uint8_t>(state);
+  if (index >= sizeof(LED_POWER_BUDGET) / sizeof(LED_POWER_BUDGET[0])) {
+    return;
+  }
+  LedPowerBudget budget;
+  memcpy_P(&budget, &LED_POWER_BUDGET[index], sizeof(LedPowerBudget));
+  if (budget.moistureBlinks != moistureBlinks || budget.pwm != pwmAllowed) {
+    LOG_LED_STATE("Power budget PWM ", budget.pwm);
+    accumulateCharge(millis());  // Time so far is charged at the old duties
+  }
+  applyPowerBudget(budget);  // Takes effect on the next pattern edge
+}
+
+void RgbLedStatusDisplay::applyPowerBudget(const LedPowerBudget& budget) {
+  moistureBlinks = budget.moistureBlinks;
+  pwmAllowed = budget.pwm;
   
-  // Handle battery flash (independent of state)
-  if (continueProcessing && batteryBlinker.count > 0 && batteryBlinker.ready(now)) {
-    if (batteryBlinker.phase) {
-      // Flash OFF - restore previous state color
-      if (currentState == LEDState::BOOT_GREEN) {
-        setColor(RGBColor(ColorIndex::GREEN));
-      } else if (currentState == LEDState::CONNECTION_FAILURE) {
-        setColor(RGBColor(ColorIndex::RED));
-      } else {
-        setColor(RGBColor(ColorIndex::OFF));
-      }
-    } else {
-      // Flash ON
-      setColor(blinkColor);
-    }
-    
-    if (!batteryBlinker.flip(now)) {
-      // Flash complete
-      batteryBlinker.count = 0; // Reset for next time
+  ChannelDuty duties[LED_COLOR_COUNT];
+  for (uint8_t i = 0; i < LED_COLOR_COUNT; i++) {
+    RGBValues rgb = RGBColor(static_cast<ColorIndex>(i)).getRGB();
+    duties[i] = { toDuty(rgb.r), toDuty(rgb.g), toDuty(rgb.b) };
+    if (!pwmAllowed) {
+      // Round each channel on the perceptual level - orange shows as red
+      duties[i] = { (uint8_t)(rgb.r >= 128 ? 255 : 0), (uint8_t)(rgb.g >= 128 ? 255 : 0),
+                    (uint8_t)(rgb.b >= 128 ? 255 : 0) };
     }
   }
+  noInterrupts();
+  memcpy(colorDuty, duties, sizeof(duties));
+  interrupts();
+}
+
+// Charge is worked out here from the time each color was lit: current x
+// time at that color's duty
+void RgbLedStatusDisplay::accumulateCharge(uint32_t now) {
+  uint32_t onMs[LED_COLOR_COUNT];
+  noInterrupts();
+  int32_t lit = (int32_t)(now - activeSinceMs);
+  if (lit > 0) {
+    colorOnMs[activeColor] += (uint32_t)lit;
+    activeSinceMs = now;
+  }
+  for (uint8_t i = 0; i < LED_COLOR_COUNT; i++) {
+    onMs[i] = colorOnMs[i];
+    colorOnMs[i] = 0;
+  }
+  interrupts();
+  
+  for (uint8_t i = 0; i < LED_COLOR_COUNT; i++) {
+    const ChannelDuty& duty = colorDuty[i];
+    uint32_t currentUa = ((uint32_t)duty.r + duty.g + duty.b) * LED_CHANNEL_CURRENT_UA / 255;
+    chargeNc += (uint64_t)currentUa * onMs[i];  // uA x ms = nC
+  }
+}
+
+uint32_t RgbLedStatusDisplay::takeEnergyMicrojoules() {
+  accumulateCharge(millis());
+  uint64_t charge = chargeNc;
+  chargeNc = 0;
+  return (uint32_t)(charge * LED_SUPPLY_MV / 1000000);  // nC x mV = pJ
 }
 
 // Unified test method for debugging LED hardware
 void RgbLedStatusDisplay::testColor(bool r, bool g, bool b) {
   LOG_LED("TEST MODE - ENTERING");
   // Force stop all ongoing sequences
-  moistureBlinker.count = 0;
-  failureBlinker.count = 0;
-  batteryBlinker.count = 0;
-  commissioningBlinker.count = 0;  // Stop commissioning blinks
+  player.stop();
   currentState = LEDState::TEST_MODE;  // Disable state machine completely
-  setColor(r, g, b);
+  // Test output bypasses the energy accounting
+  writeDuty({ (uint8_t)(r ? 255 : 0), (uint8_t)(g ? 255 : 0), (uint8_t)(b ? 255 : 0) });
   LOG_LED("TEST COMMAND COMPLETED");
 }
@@ -1,5 +1,6 @@
 #pragma once
-#include "StatusDisplay.h"
+#include "DisplayPipeline.h"
+#include "LedPatternPlayer.h"
 #include <Arduino.h>
 
 // Hardware pin definitions (Arduino Nano Matter)
@@ -14,6 +15,10 @@ constexpr uint16_t BLINK_DURATION_MS = 400;       // Moisture blink on/off durat
 constexpr uint16_t FAILURE_BLINK_MS = 1000;       // Connection failure blink duration
 constexpr uint8_t MOISTURE_BLINK_COUNT = 5;       // Number of moisture indication blinks
 
+// LED energy model - used for the per-wake energy report
+constexpr uint16_t LED_CHANNEL_CURRENT_UA = 4000; // Current per channel at full duty
+constexpr uint16_t LED_SUPPLY_MV = 3300;          // LED supply rail
+
 // Commissioning timing constants
 constexpr uint16_t COMMISSIONING_FAST_BLINK_MS = 250;   // Fast white blink when ready
 constexpr uint16_t COMMISSIONING_SLOW_BLINK_MS = 800;   // Slow green blink when in progress
@@ -49,20 +54,41 @@ enum class ColorIndex : uint8_t {
   BLUE = 6     // Wettest
 };
 
-// PROGMEM color table - saves RAM by storing in flash
+// PROGMEM color table - saves RAM by storing in flash.
+// Levels are perceptual (0-255); gamma correction is applied at output time.
 struct RGBValues {
-  bool r, g, b;
-  constexpr RGBValues(bool red = false, bool green = false, bool blue = false) : r(red), g(green), b(blue) {}
+  uint8_t r, g, b;
+  constexpr RGBValues(uint8_t red = 0, uint8_t green = 0, uint8_t blue = 0) : r(red), g(green), b(blue) {}
 };
 
 static const RGBValues PROGMEM COLOR_TABLE[] = {
-  {false, false, false},  // OFF
-  {true, false, false},   // RED
-  {true, true, false},    // ORANGE
-  {true, true, false},    // YELLOW (same as orange for RGB LED)
-  {true, true, true},     // WHITE
-  {false, true, false},   // GREEN
-  {false, false, true}    // BLUE
+  {0, 0, 0},        // OFF
+  {255, 0, 0},      // RED
+  {255, 96, 0},     // ORANGE
+  {255, 200, 0},    // YELLOW
+  {255, 255, 255},  // WHITE
+  {0, 255, 0},      // GREEN
+  {0, 0, 255}       // BLUE
+};
+constexpr uint8_t LED_COLOR_COUNT = sizeof(COLOR_TABLE) / sizeof(COLOR_TABLE[0]);
+
+// Moisture blink budget and output mode per PowerState (indexed by PowerState).
+// Any duty between off and full needs the PWM timer, which runs from HFCLK
+// and holds the core in EM1 while lit. States that sleep therefore drive
+// full on/off only - mixed colors round each channel to on or off, so orange
+// shows as red and nothing is dimmed - and save energy with fewer blinks.
+struct LedPowerBudget {
+  uint8_t moistureBlinks;  // 0 = moisture blinks suppressed
+  bool pwm;                // false = GPIO on/off only, the LETIMER pattern keeps EM2
+};
+
+static const LedPowerBudget PROGMEM LED_POWER_BUDGET[] = {
+  {MOISTURE_BLINK_COUNT, true},   // Booting
+  {MOISTURE_BLINK_COUNT, false},  // Normal
+  {2, false},                     // Extended - shorter
+  {0, false},                     // LowPower - status only
+  {0, false},                     // Critical - status only
+  {MOISTURE_BLINK_COUNT, true}    // UsbPowered
 };
 
 // Moisture percentage thresholds for color lookup (ascending order for binary search)
@@ -83,31 +109,32 @@ struct RGBColor {
   }
 };
 
-// Generic blinker for unified blink logic
-struct Blinker {
-  bool phase = false;
-  uint32_t nextTime = 0;
-  uint16_t period = 0;
-  uint8_t count = 0;
-  uint8_t current = 0;
-  
-  bool ready(uint32_t now) const { return now >= nextTime; }
-  
-  void start(uint32_t now, uint16_t periodMs, uint8_t blinkCount = 0) {
-    phase = false;
-    nextTime = now;
-    period = periodMs;
-    count = blinkCount;
-    current = 0;
-  }
-  
-  bool flip(uint32_t now) {
-    phase = !phase;
-    nextTime = now + period;
-    if (!phase) current++;  // Count full cycles (when going from ON to OFF)
-    return (count == 0) || (current < count); // Continue if infinite or not done
-  }
-};
+// Declarative LED patterns - played by LedPatternPlayer from a hardware timer
+#define LED_STEP(color, ms) { static_cast<uint8_t>(ColorIndex::color), ms }
+#define LED_STEP_BLINK(ms) { LED_STEP_PATTERN_COLOR, ms }
+
+static const LedStep PROGMEM BOOT_STEPS[] = { LED_STEP(GREEN, BOOT_HOLD_MS) };
+static const LedStep PROGMEM MOISTURE_STEPS[] = { LED_STEP_BLINK(BLINK_DURATION_MS), LED_STEP(OFF, BLINK_DURATION_MS) };
+static const LedStep PROGMEM FAILURE_STEPS[] = { LED_STEP(RED, FAILURE_BLINK_MS), LED_STEP(OFF, FAILURE_BLINK_MS) };
+static const LedStep PROGMEM BATTERY_STEPS[] = { LED_STEP(RED, BATTERY_FLASH_MS) };
+static const LedStep PROGMEM COMMISSIONING_READY_STEPS[] = {
+  LED_STEP(WHITE, COMMISSIONING_FAST_BLINK_MS), LED_STEP(OFF, COMMISSIONING_FAST_BLINK_MS) };
+static const LedStep PROGMEM COMMISSIONING_ACTIVE_STEPS[] = {
+  LED_STEP(GREEN, COMMISSIONING_SLOW_BLINK_MS), LED_STEP(OFF, COMMISSIONING_SLOW_BLINK_MS) };
+static const LedStep PROGMEM COMMISSIONING_SUCCESS_STEPS[] = { LED_STEP(GREEN, COMMISSIONING_SUCCESS_HOLD_MS) };
+static const LedStep PROGMEM COMMISSIONING_FAILED_STEPS[] = {
+  LED_STEP(RED, COMMISSIONING_FAST_BLINK_MS), LED_STEP(OFF, COMMISSIONING_FAST_BLINK_MS) };
+
+#define LED_PATTERN(steps, repeat) { steps, sizeof(steps) / sizeof(steps[0]), repeat }
+
+static const LedPattern BOOT_PATTERN = LED_PATTERN(BOOT_STEPS, 1);
+static const LedPattern MOISTURE_PATTERN = LED_PATTERN(MOISTURE_STEPS, MOISTURE_BLINK_COUNT);
+static const LedPattern FAILURE_PATTERN = LED_PATTERN(FAILURE_STEPS, 0);
+static const LedPattern BATTERY_PATTERN = LED_PATTERN(BATTERY_STEPS, 1);
+static const LedPattern COMMISSIONING_READY_PATTERN = LED_PATTERN(COMMISSIONING_READY_STEPS, 0);
+static const LedPattern COMMISSIONING_ACTIVE_PATTERN = LED_PATTERN(COMMISSIONING_ACTIVE_STEPS, 0);
+static const LedPattern COMMISSIONING_SUCCESS_PATTERN = LED_PATTERN(COMMISSIONING_SUCCESS_STEPS, 1);
+static const LedPattern COMMISSIONING_FAILED_PATTERN = LED_PATTERN(COMMISSIONING_FAILED_STEPS, 10);
 
 enum class LEDState : uint8_t {
   OFF,               // Most of the time
@@ -122,16 +149,20 @@ enum class LEDState : uint8_t {
   TEST_MODE          // Manual test override - disable state machine
 };
 
-class RgbLedStatusDisplay : public StatusDisplay {
+class RgbLedStatusDisplay : public StatusSink {
 public:
-  // Constructor initializes blinkers for safety
-  RgbLedStatusDisplay() : moistureBlinker{}, failureBlinker{}, batteryBlinker{}, commissioningBlinker{} {}
-  
-  void begin() override;
-  void handleEvent(StatusEvent event) override;
-  void showMoisture(float percent) override;
-  void showMessage(const char* msg) override;
-  void update() override;
+  // Disconnect notices and publish events carry nothing for the LED
+  static constexpr StatusEventMask kEventMask = kAllStatusEvents &
+      ~statusEventMask(StatusEvent::ThreadDisconnected, StatusEvent::MatterOffline,
+                       StatusEvent::MoisturePublishing, StatusEvent::MoisturePublished);
+
+  void begin();
+  void handleEvent(StatusEvent event);
+  void showMoisture(float percent);
+  void showMessage(const char* msg);
+  void update();
+  void setPowerState(PowerState state);
+  uint32_t takeEnergyMicrojoules();
   
   // Unified test method for debugging LED hardware
   void testColor(bool r, bool g, bool b);
@@ -141,34 +172,67 @@ public:
   void testOff() { testColor(false, false, false); }
 
 private:
-  // Inline constexpr setColor for performance - bounds checked
-  inline void setColor(bool r, bool g, bool b) {
-    // Bounds check: ensure only valid pin states
-    r = r ? true : false;  // Normalize to boolean
-    g = g ? true : false;
-    b = b ? true : false;
-    
-    digitalWrite(PIN_R, r ? LOW : HIGH);  // Active LOW
-    digitalWrite(PIN_G, g ? LOW : HIGH);
-    digitalWrite(PIN_B, b ? LOW : HIGH);
+  // Gamma 2.0 correction of a perceptual level
+  static inline uint8_t toDuty(uint8_t level) {
+    return (uint8_t)(((uint16_t)level * level + 127) / 255);
   }
   
-  inline void setColor(const RGBColor& color) {
-    RGBValues rgb = color.getRGB();
-    setColor(rgb.r, rgb.g, rgb.b);
+  // Full on/off uses plain GPIO so the LETIMER pattern can run in EM2;
+  // intermediate duties need the PWM timer (EM1 while lit) and are only
+  // written from the main loop
+  static inline void writeChannel(uint8_t pin, uint8_t duty) {
+    if (duty == 0) {
+      digitalWrite(pin, HIGH);               // Active LOW - off
+    } else if (duty == 255) {
+      digitalWrite(pin, LOW);
+    } else {
+      analogWrite(pin, 255 - duty);
+    }
   }
   
+  struct ChannelDuty {
+    uint8_t r, g, b;
+    bool isGpio() const { return (r == 0 || r == 255) && (g == 0 || g == 255) && (b == 0 || b == 255); }
+  };
+  
+  // Output a color at edgeMs - records the step for energy accounting and
+  // writes the pins when GPIO can; PWM duties are left to update(). Safe in
+  // interrupt context: one subtraction, one add, three pin writes.
+  void showColor(uint8_t color, uint32_t edgeMs);
+  void writeDuty(const ChannelDuty& duty);
+  void applyPowerBudget(const LedPowerBudget& budget);  // Recomputes colorDuty
+  void accumulateCharge(uint32_t now);                  // Folds colorOnMs into chargeNc
+  
   // Binary search for efficient moisture color lookup
   ColorIndex getMoistureColorIndex(float percent);
   
+  // Pattern playback - callbacks may run in interrupt context
+  void playState(LEDState state, uint32_t now);
+  void startPattern(LEDState state, uint32_t now);  // Pattern only - state and its start time untouched
+  LEDState idleState() const { return linkFailed ? LEDState::CONNECTION_FAILURE : LEDState::OFF; }
+  static void onPatternOutput(uint8_t color, uint32_t edgeMs, void* context);
+  static void onPatternComplete(const LedPattern* pattern, void* context);
+  
   bool isInitialized = false;    // Safety flag - prevents garbage output
   LEDState currentState = LEDState::OFF;
   uint32_t stateStartTime = 0;   // When current state began
+  bool linkFailed = false;       // Failure is latched - the bus sends it once
   
-  // Separate blinkers to prevent conflicts
-  Blinker moistureBlinker;
-  Blinker failureBlinker;
-  Blinker batteryBlinker;        // Dedicated battery blinker
-  Blinker commissioningBlinker;  // Dedicated commissioning blinker
+  LedPatternPlayer player;
   RGBColor blinkColor;           // Current color for moisture blinks
+  
+  // Power budget - duties per color in the current output mode, rebuilt
+  // outside interrupts and only read by the timer callback
+  uint8_t moistureBlinks = MOISTURE_BLINK_COUNT;
+  bool pwmAllowed = true;
+  ChannelDuty colorDuty[LED_COLOR_COUNT] = {};
+  
+  // Energy accounting - the timer callback only records which color was
+  // lit for how long; charge is worked out in update()/takeEnergyMicrojoules()
+  volatile uint8_t activeColor = 0;
+  volatile uint32_t activeSinceMs = 0;
+  volatile uint32_t colorOnMs[LED_COLOR_COUNT] = {};  // Time lit per color since the last fold
+  volatile bool pwmPending = false;  // activeColor needs analogWrite from update()
+  uint64_t chargeNc = 0;             // Folded charge since the last report
+  const LedPattern* volatile finishedPattern = nullptr;  // Set by completion callback
 };
@@ -1,11 +1,11 @@
 #pragma once
-#include "StatusDisplay.h"
+#include "DisplayPipeline.h"
 
-class SerialStatusDisplay : public StatusDisplay {
+class SerialStatusDisplay : public StatusSink {
 public:
-  void begin() override;
-  void handleEvent(StatusEvent event) override;
-  void showMoisture(float percent) override;
-  void showMessage(const char* msg) override;
-  void update() override;
+  void begin();
+  void handleEvent(StatusEvent event);
+  void showMoisture(float percent);
+  void showMessage(const char* msg);
+  void update();
 };
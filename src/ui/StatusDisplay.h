@@ -1,4 +1,5 @@
 #pragma once
+#include "../hardware/PowerManager.h"
 
 enum class StatusEvent {
   BootStarting,
@@ -27,6 +28,23 @@ enum class StatusEvent {
   Error,
 };
 
+constexpr uint8_t kStatusEventCount = static_cast<uint8_t>(StatusEvent::Error) + 1;
+
+// Subscription masks - one bit per StatusEvent
+typedef uint32_t StatusEventMask;
+static_assert(kStatusEventCount <= 32, "StatusEventMask holds at most 32 events");
+
+constexpr StatusEventMask statusEventBit(StatusEvent event) {
+  return StatusEventMask(1) << static_cast<uint8_t>(event);
+}
+
+template <typename... Events>
+constexpr StatusEventMask statusEventMask(Events... events) {
+  return (StatusEventMask(0) | ... | statusEventBit(events));
+}
+
+constexpr StatusEventMask kAllStatusEvents = (StatusEventMask(1) << kStatusEventCount) - 1;
+
 class StatusDisplay {
 public:
   virtual void begin() = 0;
@@ -36,6 +54,10 @@ public:
   virtual void showBattery(float voltage, bool isLow = false) {};  // Optional battery display
   virtual void update() = 0;
   
+  // Power-aware output (optional implementation)
+  virtual void setPowerState(PowerState state) {};   // Scale output to the power budget
+  virtual uint32_t takeEnergyMicrojoules() { return 0; }  // Energy used since last call
+  
   // Test methods for debugging (optional implementation)
   virtual void testRed() {};    // Test red color/output
   virtual void testGreen() {};  // Test green color/output  
@@ -0,0 +1,99 @@
+#include "StatusEventBus.h"
+
+bool StatusEventBus::admit(StatusEvent event, uint8_t payload) {
+  uint8_t group;
+  if (linkGroupOf(event, group)) {
+    if (latched[group] == index(event)) {
+      bump(suppressed[index(event)]);
+      return false;
+    }
+    latched[group] = index(event);
+  }
+
+  uint8_t condition;
+  if (conditionOf(event, condition)) {
+    if (conditionPayload[condition] == payload) {
+      bump(suppressed[index(event)]);
+      return false;
+    }
+    conditionPayload[condition] = payload;
+  }
+
+  switch (event) {
+    case StatusEvent::BootStarting:
+    case StatusEvent::FactoryReset:
+      // Conditions are re-evaluated from scratch
+      for (uint8_t i = 0; i < CONDITION_COUNT; i++) {
+        conditionPayload[i] = NO_CONDITION;
+      }
+      resetLatches();
+      break;
+    case StatusEvent::EnteringSleep:
+      // Sinks drop back to idle - the next link event must get through
+      resetLatches();
+      break;
+    default:
+      break;
+  }
+
+  bump(posted[index(event)]);
+  return true;
+}
+
+void StatusEventBus::clear(StatusEvent event) {
+  uint8_t condition;
+  if (conditionOf(event, condition)) {
+    conditionPayload[condition] = NO_CONDITION;
+  }
+}
+
+void StatusEventBus::resetLatches() {
+  for (uint8_t group = 0; group < LINK_GROUP_COUNT; group++) {
+    latched[group] = NO_LATCH;
+  }
+}
+
+void StatusEventBus::clearCounts() {
+  for (uint8_t i = 0; i < kStatusEventCount; i++) {
+    posted[i] = 0;
+    suppressed[i] = 0;
+  }
+}
+
+uint32_t StatusEventBus::getTotalSuppressed() const {
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < kStatusEventCount; i++) {
+    total += suppressed[i];
+  }
+  return total;
+}
+
+bool StatusEventBus::linkGroupOf(StatusEvent event, uint8_t& group) {
+  switch (event) {
+    case StatusEvent::ThreadConnected:
+    case StatusEvent::ThreadDisconnected:
+    case StatusEvent::ThreadConnectionFailed:
+      group = THREAD_GROUP;
+      return true;
+    case StatusEvent::MatterOnline:
+    case StatusEvent::MatterOffline:
+    case StatusEvent::MatterConnectionFailed:
+      group = MATTER_GROUP;
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool StatusEventBus::conditionOf(StatusEvent event, uint8_t& condition) {
+  switch (event) {
+    case StatusEvent::BatteryLow:
+      condition = BATTERY_CONDITION;
+      return true;
+    case StatusEvent::Error:
+      condition = ERROR_CONDITION;
+      return true;
+    default:
+      return false;
+  }
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "StatusDisplay.h"
+
+// Front end of the display pipeline's event fan-out. Link events describe a
+// state rather than an occurrence, and loop() re-posts them every cycle while
+// the node is offline. The bus latches the last event of each link group and
+// drops repeats, so sinks only see transitions. Condition events (BatteryLow,
+// Error) are latched per type together with their payload - the battery
+// status or fault code - and pass again only when the payload changes or
+// after clear() reports the condition gone. One-shot events always pass.
+// Per-event counters give the posted/suppressed rates for diagnostics.
+class StatusEventBus {
+public:
+  // Returns false when the event repeats the latched state of its group,
+  // or a condition event repeats its latched payload
+  bool admit(StatusEvent event, uint8_t payload = 0);
+
+  // The condition behind a latched event ended - the next one passes
+  void clear(StatusEvent event);
+
+  // Forget latched link states - call when the sinks were reset to idle
+  void resetLatches();
+  void clearCounts();
+
+  uint16_t getPostedCount(StatusEvent event) const { return posted[index(event)]; }
+  uint16_t getSuppressedCount(StatusEvent event) const { return suppressed[index(event)]; }
+  uint32_t getTotalSuppressed() const;
+
+private:
+  enum LinkGroup : uint8_t { THREAD_GROUP, MATTER_GROUP, LINK_GROUP_COUNT };
+  enum Condition : uint8_t { BATTERY_CONDITION, ERROR_CONDITION, CONDITION_COUNT };
+  static constexpr uint8_t NO_LATCH = 0xFF;
+  static constexpr uint16_t NO_CONDITION = 0xFFFF;  // Outside any payload
+
+  uint8_t latched[LINK_GROUP_COUNT] = { NO_LATCH, NO_LATCH };
+  uint16_t conditionPayload[CONDITION_COUNT] = { NO_CONDITION, NO_CONDITION };
+  uint16_t posted[kStatusEventCount] = {};      // Saturating counters
+  uint16_t suppressed[kStatusEventCount] = {};
+
+  static uint8_t index(StatusEvent event) { return static_cast<uint8_t>(event); }
+  static bool linkGroupOf(StatusEvent event, uint8_t& group);
+  static bool conditionOf(StatusEvent event, uint8_t& condition);
+  static void bump(uint16_t& counter) { if (counter != UINT16_MAX) counter++; }
+};
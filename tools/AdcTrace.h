@@ -0,0 +1,162 @@
+#pragma once
+// Recorded ADC trace for host tools, played back as the node's analog
+// inputs. Traces are sparser than the firmware's wakes, so reads interpolate
+// between the samples around them and add +/-1 count of reproducible dither
+// for the ADC noise a held value lacks - otherwise the sensor fault detector
+// would see a stuck probe. A trace may carry the soil temperature, played
+// back as the TMP117 reading.
+//
+// Formats (times are rebased to the first sample):
+//   CSV    time_ms,moisture_raw,battery_raw[,temperature_centi_c] - '#' comments
+//          and a header line allowed; the temperature column is all or nothing
+//   Binary "GTTR", u16 version, u16 record size, then records (little-endian)
+//          version 1, size 8:  u32 time_ms, u16 moisture_raw, u16 battery_raw
+//          version 2, size 10: the same, then i16 temperature_centi_c
+#include <Arduino.h>
+#include <stdio.h>
+#include <vector>
+#include "../src/config/Config.h"
+
+struct TraceSample {
+    uint32_t timeMs;
+    uint16_t moistureRaw;
+    uint16_t batteryRaw;
+    int16_t temperatureCentiC;  // Zero in traces without temperature
+};
+
+class AdcTrace {
+public:
+    std::vector<TraceSample> samples;
+    bool hasTemperature = false;
+
+    bool load(const char* path) {
+        FILE* file = fopen(path, "rb");
+        if (!file) {
+            perror(path);
+            return false;
+        }
+        char magic[4] = {};
+        size_t got = fread(magic, 1, sizeof(magic), file);
+        rewind(file);
+        bool ok = (got == 4 && memcmp(magic, "GTTR", 4) == 0) ? loadBinary(file) : loadCsv(file);
+        fclose(file);
+        if (!ok || samples.size() < 2) {
+            fprintf(stderr, "%s: not a trace (need at least two samples)\n", path);
+            return false;
+        }
+        // Rebase; out-of-order samples would stall the playback cursor
+        uint32_t start = samples[0].timeMs;
+        for (size_t i = 0; i < samples.size(); i++) {
+            samples[i].timeMs -= start;
+            if (i > 0 && samples[i].timeMs < samples[i - 1].timeMs) {
+                fprintf(stderr, "%s: sample %zu goes back in time\n", path, i);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint32_t getEndMs() const { return samples.back().timeMs; }
+
+    // Interpolated input level in ADC counts; times must not go backwards
+    double level(uint8_t pin, uint32_t nowMs) {
+        double t;
+        const TraceSample& from = span(nowMs, t);
+        const TraceSample& to = samples[min(cursor + 1, samples.size() - 1)];
+        return pin == kMoisturePin ? from.moistureRaw + t * (to.moistureRaw - from.moistureRaw)
+                                   : from.batteryRaw + t * (to.batteryRaw - from.batteryRaw);
+    }
+
+    // Interpolated soil temperature, rounded to the TMP117's 0.01 degC output
+    bool temperature(uint32_t nowMs, int16_t& centiC) {
+        if (!hasTemperature) {
+            return false;
+        }
+        double t;
+        const TraceSample& from = span(nowMs, t);
+        const TraceSample& to = samples[min(cursor + 1, samples.size() - 1)];
+        centiC = (int16_t)lround(from.temperatureCentiC + t * (to.temperatureCentiC - from.temperatureCentiC));
+        return true;
+    }
+
+    // One ADC conversion at the shim's current time
+    int read(uint8_t pin) {
+        return constrain((int)lround(level(pin, millis())) + nextDither(), 0, 1023);
+    }
+
+    static int analogThunk(uint8_t pin, void* context) {
+        return static_cast<AdcTrace*>(context)->read(pin);
+    }
+    static bool temperatureThunk(uint32_t nowMs, int16_t& centiC, void* context) {
+        return static_cast<AdcTrace*>(context)->temperature(nowMs, centiC);
+    }
+
+private:
+    size_t cursor = 0;
+    uint32_t dither = 0x2545F491;
+
+    // Sample at or before nowMs, and how far nowMs is towards the next (0..1)
+    const TraceSample& span(uint32_t nowMs, double& t) {
+        while (cursor + 1 < samples.size() && samples[cursor + 1].timeMs <= nowMs) {
+            cursor++;
+        }
+        const TraceSample& from = samples[cursor];
+        const TraceSample& to = samples[min(cursor + 1, samples.size() - 1)];
+        t = 0;
+        if (to.timeMs > from.timeMs) {
+            t = min(1.0, (double)(nowMs - from.timeMs) / (to.timeMs - from.timeMs));
+        }
+        return from;
+    }
+
+    int nextDither() {
+        dither ^= dither << 13;
+        dither ^= dither >> 17;
+        dither ^= dither << 5;
+        return (int)(dither % 3) - 1;
+    }
+
+    bool loadBinary(FILE* file) {
+        uint8_t header[8];
+        if (fread(header, 1, sizeof(header), file) != sizeof(header) || header[5] != 0 || header[7] != 0) {
+            return false;
+        }
+        size_t recordSize = header[4] == 1 ? 8 : header[4] == 2 ? 10 : 0;
+        if (recordSize == 0 || header[6] != recordSize) {
+            return false;
+        }
+        hasTemperature = recordSize == 10;
+        uint8_t record[10];
+        while (fread(record, 1, recordSize, file) == recordSize) {
+            TraceSample sample;
+            sample.timeMs = record[0] | (record[1] << 8) | (record[2] << 16) | ((uint32_t)record[3] << 24);
+            sample.moistureRaw = record[4] | (record[5] << 8);
+            sample.batteryRaw = record[6] | (record[7] << 8);
+            sample.temperatureCentiC = hasTemperature ? (int16_t)(record[8] | (record[9] << 8)) : 0;
+            samples.push_back(sample);
+        }
+        return true;
+    }
+
+    bool loadCsv(FILE* file) {
+        char line[128];
+        size_t withTemperature = 0;
+        while (fgets(line, sizeof(line), file)) {
+            unsigned long timeMs;
+            unsigned moisture, battery;
+            int temperature = 0;
+            int fields = line[0] == '#' ? 0 : sscanf(line, "%lu,%u,%u,%d", &timeMs, &moisture, &battery, &temperature);
+            if (fields < 3) {
+                continue;  // Comment or header
+            }
+            withTemperature += fields == 4;
+            samples.push_back({(uint32_t)timeMs, (uint16_t)min(moisture, 1023u), (uint16_t)min(battery, 1023u),
+                               (int16_t)constrain(temperature, -27315, 32767)});
+        }
+        if (withTemperature != 0 && withTemperature != samples.size()) {
+            return false;
+        }
+        hasTemperature = withTemperature != 0;
+        return true;
+    }
+};
@@ -0,0 +1,128 @@
+#pragma once
+// Host models of the I2C climate sensors, attached to the host Wire.
+// Timing follows the datasheets closely enough to catch a driver that
+// reads early: the SHT4x NACKs while it converts, and the TMP117 result
+// register holds its reset value until the first conversion ends. Both
+// count early reads so a check can fail on them.
+#include <Wire.h>
+#include "../src/hardware/ClimateSensors.h"
+
+class Sht4xModel : public HostI2cDevice {
+public:
+  float temperatureC = 21.5;
+  float humidityPercent = 48.0;
+  uint32_t conversionUs = 4500;  // Medium repeatability, max
+  bool corruptCrc = false;       // Flip a CRC bit on the next result
+  uint32_t measurements = 0;
+  uint32_t earlyReads = 0;
+
+  bool write(const uint8_t* data, uint8_t length) override {
+    if (converting()) {
+      return false;
+    }
+    if (length >= 1 && (data[0] == 0xFD || data[0] == 0xF6 || data[0] == 0xE0)) {
+      startUs = micros();
+      started = true;
+      hasResult = true;
+      measurements++;
+    }
+    return true;
+  }
+
+  bool read(uint8_t* data, uint8_t length) override {
+    if (converting()) {
+      earlyReads++;
+      return false;
+    }
+    if (!hasResult || length != 6) {
+      return false;
+    }
+    uint16_t rawTemperature = (uint16_t)lround((temperatureC + 45.0) * 65535.0 / 175.0);
+    uint16_t rawHumidity = (uint16_t)lround((humidityPercent + 6.0) * 65535.0 / 125.0);
+    data[0] = rawTemperature >> 8;
+    data[1] = rawTemperature & 0xFF;
+    data[2] = Sht4xSensor::crc8(data, 2);
+    data[3] = rawHumidity >> 8;
+    data[4] = rawHumidity & 0xFF;
+    data[5] = Sht4xSensor::crc8(data + 3, 2);
+    if (corruptCrc) {
+      data[5] ^= 0x01;
+      corruptCrc = false;
+    }
+    hasResult = false;
+    return true;
+  }
+
+private:
+  uint32_t startUs = 0;
+  bool started = false;
+  bool hasResult = false;
+
+  bool converting() const { return started && micros() - startUs < conversionUs; }
+};
+
+class Tmp117Model : public HostI2cDevice {
+public:
+  float temperatureC = 18.25;
+  uint32_t conversionUs = 15500;  // One-shot, no averaging
+  uint32_t conversions = 0;
+  uint32_t earlyReads = 0;
+
+  bool write(const uint8_t* data, uint8_t length) override {
+    if (length >= 1) {
+      pointer = data[0];
+    }
+    if (length == 3 && pointer == 0x01) {
+      config = (uint16_t)(data[1] << 8) | data[2];
+      if (((config >> 10) & 0x3) == 0x3) {
+        startUs = micros();
+        pending = true;
+        conversions++;
+      }
+    }
+    return true;
+  }
+
+  bool read(uint8_t* data, uint8_t length) override {
+    if (length != 2) {
+      return false;
+    }
+    complete();
+    uint16_t value = config;
+    if (pointer == 0x00) {
+      value = (uint16_t)result;
+      if (pending) {
+        earlyReads++;
+      }
+    }
+    data[0] = value >> 8;
+    data[1] = value & 0xFF;
+    return true;
+  }
+
+private:
+  uint8_t pointer = 0;
+  uint16_t config = 0x0220;       // Power-on default: continuous, 8 averages
+  int16_t result = (int16_t)0x8000;  // Reset value until a conversion completes
+  uint32_t startUs = 0;
+  bool pending = false;
+
+  void complete() {
+    if (pending && micros() - startUs >= conversionUs) {
+      result = (int16_t)lround(temperatureC / 0.0078125);
+      pending = false;
+    }
+  }
+};
+
+// Any other device on the bus - the OLED in the sketch - accepting every write
+class AckAllModel : public HostI2cDevice {
+public:
+  uint32_t writes = 0;
+
+  bool write(const uint8_t* data, uint8_t length) override {
+    writes++;
+    return true;
+  }
+  bool read(uint8_t* data, uint8_t length) override { return false; }
+};
@@ -0,0 +1,38 @@
+#pragma once
+// Host stand-in for the Thread/Matter path a report travels. Delivery
+// fails during an injected outage window and otherwise with lossPercent
+// probability; each attempt reports how long the radio stayed on.
+#include "../src/matter/ReportUplink.h"
+
+class NetworkStandIn {
+public:
+  uint8_t lossPercent = 2;         // Random loss outside the outage
+  uint32_t latencyMs = 40;         // Radio-on time of an acknowledged report
+  uint32_t ackTimeoutMs = 2000;    // Radio-on time of a lost report (MAC retries + ack wait)
+  uint32_t outageStartMs = 0;
+  uint32_t outageEndMs = 0;        // Empty window = no outage
+  uint32_t rng = 0x12345678;
+
+  bool inOutage(uint32_t nowMs) const {
+    return nowMs >= outageStartMs && nowMs < outageEndMs;
+  }
+
+  bool deliver(uint32_t nowMs, uint32_t& radioOnMs) {
+    bool lost = inOutage(nowMs) || (nextRandom() % 100) < lossPercent;
+    radioOnMs = lost ? ackTimeoutMs : latencyMs;
+    return !lost;
+  }
+
+  // ReportUplink::SendFn thunk - context is the stand-in
+  static bool send(const QueuedReading& reading, uint32_t& radioOnMs, void* context) {
+    return static_cast<NetworkStandIn*>(context)->deliver(millis(), radioOnMs);
+  }
+
+private:
+  uint32_t nextRandom() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+  }
+};
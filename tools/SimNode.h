@@ -0,0 +1,198 @@
+#pragma once
+// One complete sensor node for host tools: the firmware modules wired the
+// way Green_Thread.ino wires them, and its measurement cycle from loop()
+// run in virtual time. The owner supplies the analog inputs, the report
+// transport and an event listener; the node meters its own energy.
+//
+// Times are the node's local millis(). Module state is per node, but the
+// shim's clock and analog hook are global - wake() points them at this
+// node before running, so several nodes can be stepped one at a time.
+// In threshold-wake mode the owner feeds comparator.sample() between wakes
+// and wakes the node early when thresholdWake.takeTrigger() fires. An
+// optional temperature source stands in for the TMP117 soil probe.
+#include <Arduino.h>
+#include "../src/config/ConfigStore.h"
+#include "../src/hardware/SensorManager.h"
+#include "../src/hardware/BatteryMonitor.h"
+#include "../src/hardware/CalibrationManager.h"
+#include "../src/hardware/PowerManager.h"
+#include "../src/hardware/EnergyBudget.h"
+#include "../src/hardware/AutoCalibrator.h"
+#include "../src/hardware/ThresholdWake.h"
+#include "../src/hardware/TemperatureCompensator.h"
+#include "../src/matter/GreenThreadSoilSensorCluster.h"
+#include "../src/matter/IcdPolicy.h"
+#include "../src/matter/ReportPhase.h"
+#include "../src/matter/ReportUplink.h"
+
+class SimNode {
+public:
+    static const uint32_t kWakeWorkMs = 60;  // MCU + ADC bursts + cluster update per wake
+
+    ConfigStore configStore;
+    CalibrationManager calibrationManager;
+    SensorManager sensorManager;
+    BatteryMonitor batteryMonitor;
+    PowerManager powerManager;
+    EnergyBudget energyBudget;
+    AutoCalibrator autoCalibrator;
+    TemperatureCompensator temperatureCompensator;
+    SimulatedComparator comparator;
+    ThresholdWake thresholdWake;
+    SimulatedIcdStack icdBackend;
+    ReportUplink reportUplink;
+    ReportPhase reportPhase;
+    GreenThreadSoilSensorCluster cluster;
+
+    // Soil temperature at nowMs in centi-degC; false when there is none
+    typedef bool (*TemperatureFn)(uint32_t nowMs, int16_t& centiC, void* context);
+
+    SimNode() : cluster(&sensorManager, &batteryMonitor, &calibrationManager, &powerManager) {}
+
+    void setTemperatureSource(TemperatureFn fn, void* context) {
+        temperatureFn = fn;
+        temperatureContext = context;
+    }
+
+    // Boot sequence from setup(); returns the first wake
+    uint32_t begin(uint32_t nowMs, uint32_t identityHash, HostAnalogReadFn analog, void* analogContext,
+                   ReportUplink::SendFn send, void* sendContext,
+                   GreenThreadSoilSensorCluster::EventListener events, void* eventContext) {
+        analogFn = analog;
+        this->analogContext = analogContext;
+        this->send = send;
+        this->sendContext = sendContext;
+        select(nowMs);
+
+        configStore.begin();
+        calibrationManager.begin();
+        powerManager.setConfigStore(&configStore);
+        powerManager.setEnergyBudget(&energyBudget);
+        powerManager.setIcdBackend(&icdBackend);
+        powerManager.begin();
+        energyBudget.begin(millis());
+        sensorManager.setCalibrationManager(&calibrationManager);
+        temperatureCompensator.begin(&configStore, temperatureFn != nullptr);  // A temperature source is the soil probe
+        sensorManager.setTemperatureCompensator(&temperatureCompensator);
+        sensorManager.begin();
+        autoCalibrator.begin(&calibrationManager, &configStore);
+        thresholdWake.begin(&comparator, &calibrationManager);
+        batteryMonitor.begin();
+        batteryMonitor.setCalibrationManager(&calibrationManager);
+
+        cluster.setConfigStore(&configStore);
+        cluster.setAutoCalibrator(&autoCalibrator);
+        cluster.setReportUplink(&reportUplink);
+        cluster.setEventListener(events, eventContext);
+        reportPhase.begin(identityHash, millis());
+        reportUplink.begin(sendThunk, this, identityHash);
+        cluster.begin();
+
+        lastWakeEndMs = millis();
+        return reportPhase.firstWake();
+    }
+
+    // One measurement cycle from loop(); returns the next wake
+    uint32_t wake(uint32_t nowMs) {
+        select(nowMs);
+        uint32_t now = millis();
+
+        // Sleep since the last wake closed
+        chargeUc += (double)kSleepCurrentUa * (uint32_t)(now - lastWakeEndMs) / 1000.0;
+
+        calibrationManager.service(now, powerManager.getCurrentState());
+        configStore.service(now, powerManager.getCurrentState());
+        powerManager.onMeasurementWake(now);  // The ICD stand-in counts the polls up to and on this wake
+        thresholdWake.onMeasurementWake();
+        uint32_t polled = icdBackend.getPollCount() - icdPollsCharged;
+        icdPollsCharged = icdBackend.getPollCount();
+
+        float voltage = batteryMonitor.readVoltage();
+        uint8_t batteryPercent = batteryMonitor.updateStateOfCharge(voltage);
+        float stateVoltage = (voltage > 0 && batteryMonitor.hasStateOfCharge()) ? batteryMonitor.getRestingVoltage() : voltage;
+        uint32_t icdPolls = icdPollsPerWake(icdBackend.getParameters(), powerManager.getCurrentSleepInterval());
+        energyBudget.beginWake(now, 0, reportUplink.getRadioOnMs(), icdPolls, voltage);
+        energyBudget.update(now, batteryPercent, powerManager.getConfiguration().normalSleepInterval,
+                            powerManager.getConfiguration().maxSleepInterval);
+        if (batteryMonitor.hasStateOfCharge()) {
+            powerManager.updatePowerState(stateVoltage, false);
+        }
+
+        int16_t soilTemperature;
+        if (temperatureFn && temperatureFn(millis(), soilTemperature, temperatureContext)) {
+            sensorManager.setSoilTemperature(soilTemperature);
+        }
+        sensorManager.readMoisture();
+        if (!sensorManager.isFaulted()) {
+            autoCalibrator.addSample(sensorManager.getCompensatedRaw());
+        }
+        cluster.update();
+        uint32_t interval = thresholdWake.afterMeasurement(cluster.getMoistureBands(), sensorManager.getLastRaw(),
+                                                           sensorManager.getCompensatedRaw(), sensorManager.isFaulted(),
+                                                           powerManager.getCurrentSleepInterval());
+        uint32_t next = reportPhase.nextWake(now, interval);
+
+        QueuedReading reading;
+        reading.timestampS = now / 1000;
+        for (uint8_t probe = 0; probe < kMaxMoistureProbes; probe++) {
+            bool reported = probe < kMoistureProbeCount && !sensorManager.isFaulted(probe);
+            reading.moistureTenths[probe] = reported ? (uint16_t)(constrain(sensorManager.getMoisture(probe), 0.0f, 100.0f) * 10.0f + 0.5f)
+                                                     : QueuedReading::NO_MOISTURE;
+        }
+        reading.batteryMv = voltage > 0 ? (uint16_t)(voltage * 1000.0f) : 0;
+        reading.batteryPercent = batteryPercent;
+        reportUplink.enqueue(reading);
+        hostMillis += kWakeWorkMs;
+        double radioBeforeMs = radioOnMs;
+        reportUplink.service(millis());  // Radio time extends the wake
+
+        uint32_t awake = millis() - now;
+        energyBudget.endWake(millis());
+        chargeUc += EnergyBudget::cycleChargeUc(awake, (uint32_t)(radioOnMs - radioBeforeMs), polled);
+        awakeMs += awake;
+        lastWakeEndMs = millis();
+        wakes++;
+
+        // Never schedule into the wake that just ran
+        if ((int32_t)(next - millis()) < 0) {
+            next = millis();
+        }
+        return next;
+    }
+
+    // Metered totals
+    uint32_t getWakes() const { return wakes; }
+    double getAwakeMs() const { return awakeMs; }
+    double getRadioOnMs() const { return radioOnMs; }
+    double getChargeUc() const { return chargeUc; }  // Awake, radio, polls + sleep, up to the last wake
+    uint32_t getIcdPolls() const { return icdBackend.getPollCount(); }  // Data polls counted in virtual time
+
+private:
+    HostAnalogReadFn analogFn = nullptr;
+    void* analogContext = nullptr;
+    TemperatureFn temperatureFn = nullptr;
+    void* temperatureContext = nullptr;
+    ReportUplink::SendFn send = nullptr;
+    void* sendContext = nullptr;
+
+    uint32_t lastWakeEndMs = 0;
+    uint32_t icdPollsCharged = 0;
+    uint32_t wakes = 0;
+    double awakeMs = 0;
+    double radioOnMs = 0;
+    double chargeUc = 0;
+
+    void select(uint32_t nowMs) {
+        hostMillis = nowMs;
+        hostAnalogRead = analogFn;
+        hostAnalogContext = analogContext;
+    }
+
+    static bool sendThunk(const QueuedReading& reading, uint32_t& onMs, void* context) {
+        SimNode* node = static_cast<SimNode*>(context);
+        bool ok = node->send(reading, onMs, node->sendContext);
+        node->radioOnMs += onMs;
+        hostMillis += onMs;  // The wake lasts while the radio is on
+        return ok;
+    }
+};
@@ -0,0 +1,113 @@
+// Calibration journal wear over a year of saves at several save rates,
+// through CalibrationManager and its coalescing. Checks that a reboot
+// recovers the newest record and that page erases follow the page-aligned
+// slot layout, then prints the erase count per page against flash
+// endurance.
+//
+// Build from the repository root:
+//   g++ -std=gnu++17 -O2 -Itools/host tools/calibration_wear_check.cpp src/hardware/CalibrationManager.cpp src/hardware/CalibrationJournal.cpp -o /tmp/calibration_wear_check
+// Run:
+//   /tmp/calibration_wear_check
+// Exit status: 0 when every check passes, 1 otherwise.
+#include <Arduino.h>
+#include <stdio.h>
+#include "../src/hardware/CalibrationManager.h"
+
+uint32_t hostMillis = 0;
+
+static const uint32_t kDayMs = 86400000UL;
+static const uint32_t kEnduranceCycles = 10000;  // Conservative page erase endurance
+static const uint32_t kSlotsPerPage = kCalibJournalPageSize / sizeof(CalibrationData);
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-56s %s\n", what, ok ? "ok" : "FAIL");
+    if (!ok) {
+        failures++;
+    }
+}
+
+struct YearResult {
+    uint32_t saves;
+    uint32_t writes;
+    uint32_t erases;
+    uint32_t erasesPerPage;
+};
+
+// One year of calibration edits savesPerDay times a day, each committed
+// once the coalescing window has passed; editsPerSave edits land inside one
+// window. The host NVM carries over, so counts are taken as differences.
+static YearResult runYear(uint32_t savesPerDay, uint8_t editsPerSave) {
+    CalibrationManager calibration;
+    calibration.begin();
+    uint32_t writes0 = calibration.getWriteCount();
+    uint32_t erases0 = calibration.getEraseCount();
+
+    YearResult result = {};
+    uint32_t stepMs = kDayMs / savesPerDay;
+    int dry = 900;
+    for (uint32_t day = 0; day < 365; day++) {
+        for (uint32_t i = 0; i < savesPerDay; i++) {
+            for (uint8_t edit = 0; edit < editsPerSave; edit++) {
+                dry = dry == 900 ? 901 : 900;
+                calibration.setMoistureCalibration(dry, 300);
+                calibration.saveCalibration();
+                hostMillis += 1000;
+            }
+            hostMillis += stepMs - editsPerSave * 1000;
+            calibration.service(hostMillis, PowerState::Normal);
+            result.saves++;
+        }
+    }
+    calibration.flush(PowerState::Normal);
+
+    result.writes = calibration.getWriteCount() - writes0;
+    result.erases = calibration.getEraseCount() - erases0;
+    result.erasesPerPage = (result.erases + kCalibJournalPages - 1) / kCalibJournalPages;
+
+    // A reboot finds the last edit
+    CalibrationManager rebooted;
+    rebooted.begin();
+    int recoveredDry, recoveredWet;
+    rebooted.getMoistureCalibration(recoveredDry, recoveredWet);
+    check(recoveredDry == dry && recoveredWet == 300, "reboot recovers the newest record");
+    check(rebooted.getWriteCount() == calibration.getWriteCount(), "journal sequence survives the reboot");
+    return result;
+}
+
+int main() {
+    printf("Journal: %u pages of %u bytes, %u-byte records, %u slots per page (%u bytes unused)\n\n",
+           kCalibJournalPages, kCalibJournalPageSize, (unsigned)sizeof(CalibrationData), kSlotsPerPage,
+           (unsigned)(kCalibJournalPageSize - kSlotsPerPage * sizeof(CalibrationData)));
+
+    const struct { const char* name; uint32_t savesPerDay; uint8_t editsPerSave; } rates[] = {
+        {"daily", 1, 1},
+        {"hourly", 24, 1},
+        {"hourly, 3 edits coalesced", 24, 3},
+        {"every 15 min", 96, 1},
+        {"every wake (25 s)", kDayMs / kNormalSleepInterval, 1},
+    };
+    YearResult results[sizeof(rates) / sizeof(rates[0])];
+    for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+        printf("%s\n", rates[i].name);
+        results[i] = runYear(rates[i].savesPerDay, rates[i].editsPerSave);
+        check(results[i].writes == results[i].saves, "one journal write per coalesced save");
+        // Each page is entered once per kSlotsPerPage writes - a slot never
+        // straddles two pages and costs a second erase
+        uint32_t expected = (results[i].writes + kSlotsPerPage - 1) / kSlotsPerPage;
+        check(results[i].erases >= expected - 1 && results[i].erases <= expected + 1,
+              "page erases = writes / slots per page");
+    }
+
+    printf("\n%-28s %8s %8s %8s %10s %14s\n", "save rate", "saves", "writes", "erases", "per page",
+           "years to 10k");
+    for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+        const YearResult& r = results[i];
+        printf("%-28s %8u %8u %8u %10u %14.1f\n", rates[i].name, r.saves, r.writes, r.erases, r.erasesPerPage,
+               r.erasesPerPage ? (double)kEnduranceCycles / r.erasesPerPage : 0.0);
+    }
+
+    printf("\n%s\n", failures ? "FAILED" : "All checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,155 @@
+// Runs the climate sensor drivers through I2cBus against the I2C stand-in:
+// readings, early reads, missing and failing sensors, a busy bus and a
+// late conversion. Then compares the time a wake spends on them with the
+// conversions overlapping the ADC work against running them after it.
+//
+// Build from the repository root:
+//   g++ -std=gnu++17 -O2 -Itools/host tools/climate_sensor_check.cpp src/hardware/ClimateSensors.cpp src/hardware/I2cBus.cpp -o /tmp/climate_sensor_check
+// Run:
+//   /tmp/climate_sensor_check
+// Exit status: 0 when every check passes, 1 otherwise.
+#include <Arduino.h>
+#include <stdio.h>
+#include "I2cStandIn.h"
+#include "../src/hardware/ClimateSensors.h"
+#include "../src/hardware/I2cBus.h"
+
+uint32_t hostMillis = 0;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-56s %s\n", what, ok ? "ok" : "FAIL");
+    if (!ok) {
+        failures++;
+    }
+}
+
+// Fresh bus, models and drivers for each scenario
+struct Bench {
+    Sht4xModel sht;
+    Tmp117Model tmp;
+    AckAllModel oled;
+    ClimateSensors sensors;
+
+    Bench(bool withSht = true, bool withTmp = true) {
+        hostMillis = 1000;
+        Wire.detach(kSht4xI2cAddress);
+        Wire.detach(kTmp117I2cAddress);
+        if (withSht) Wire.attach(kSht4xI2cAddress, &sht);
+        if (withTmp) Wire.attach(kTmp117I2cAddress, &tmp);
+        Wire.attach(kOledI2cAddress, &oled);
+        i2cBus.begin();
+        sensors.begin();
+    }
+
+    // One measurement wake as the sketch runs it; returns the wake length
+    uint32_t wake(uint32_t adcWorkMs) {
+        uint32_t start = millis();
+        sensors.start();
+        delay(adcWorkMs);
+        sensors.finish();
+        return millis() - start;
+    }
+};
+
+static bool near(int32_t value, float expected, float tolerance) {
+    return fabs(value - expected) <= tolerance;
+}
+
+int main() {
+    printf("Both sensors fitted\n");
+    {
+        Bench bench;
+        check(bench.sensors.air.isPresent() && bench.sensors.soil.isPresent(), "both detected at boot");
+        bench.sht.temperatureC = 23.47;
+        bench.sht.humidityPercent = 61.3;
+        bench.tmp.temperatureC = -3.5;
+        bench.wake(2);
+        check(bench.sensors.air.hasReading() && bench.sensors.soil.hasReading(), "both read in one wake");
+        check(near(bench.sensors.air.getTemperatureCentiC(), 2347, 1), "SHT4x temperature within 0.01 degC");
+        check(near(bench.sensors.air.getHumidityCentiPercent(), 6130, 1), "SHT4x humidity within 0.01 %RH");
+        check(near(bench.sensors.soil.getTemperatureCentiC(), -350, 1), "TMP117 negative temperature within 0.01 degC");
+        check(bench.sht.earlyReads == 0 && bench.tmp.earlyReads == 0, "no read before the conversion ended");
+        check(bench.sht.measurements == 1 && bench.tmp.conversions == 1, "one conversion per sensor per wake");
+        check(!bench.sensors.isBusy() && i2cBus.isIdle(), "bus and drivers idle after finish()");
+    }
+
+    printf("Soil probe missing\n");
+    {
+        Bench bench(true, false);
+        check(bench.sensors.air.isPresent() && !bench.sensors.soil.isPresent(), "only the SHT4x detected");
+        uint32_t wakeMs = bench.wake(0);
+        check(bench.sensors.air.hasReading() && !bench.sensors.soil.hasReading(), "air read, soil skipped");
+        check(wakeMs <= kSht4xConversionMs + 1, "wake waits for the SHT4x only");
+    }
+
+    printf("Corrupt CRC\n");
+    {
+        Bench bench;
+        bench.sht.corruptCrc = true;
+        bench.wake(2);
+        check(!bench.sensors.air.hasReading() && bench.sensors.air.getErrorCount() == 1, "reading dropped and counted");
+        bench.wake(2);
+        check(bench.sensors.air.hasReading(), "next wake reads again");
+    }
+
+    printf("Sensor unplugged after boot\n");
+    {
+        Bench bench;
+        Wire.detach(kTmp117I2cAddress);
+        uint32_t wakeMs = bench.wake(2);
+        check(!bench.sensors.soil.hasReading() && bench.sensors.soil.getErrorCount() == 1, "trigger NACK counted");
+        check(wakeMs < kClimateTimeoutMs, "finish() does not wait out the timeout");
+        Wire.attach(kTmp117I2cAddress, &bench.tmp);
+        bench.wake(2);
+        check(bench.sensors.soil.hasReading(), "reads again once it answers");
+    }
+
+    printf("Busy bus\n");
+    {
+        Bench bench;
+        uint8_t tile[16] = {};
+        for (uint8_t i = 0; i < kI2cQueueDepth - 2; i++) {
+            i2cBus.write(kOledI2cAddress, tile, sizeof(tile));
+        }
+        bench.sensors.start();
+        check(bench.sensors.air.getState() == I2cSensor::State::Converting &&
+              bench.sensors.soil.getState() == I2cSensor::State::Converting, "triggers out behind queued display traffic");
+        bench.sensors.finish();
+        check(bench.sensors.air.hasReading() && bench.sensors.soil.hasReading(), "both read");
+    }
+
+    printf("Conversion outlasts the wake\n");
+    {
+        Bench bench;
+        bench.sensors.start();
+        check(!bench.sensors.finish(5), "finish() gives up at its timeout");
+        for (int pass = 0; pass < 40 && bench.sensors.isBusy(); pass++) {
+            delay(1);
+            i2cBus.poll();
+            bench.sensors.service(millis());
+        }
+        check(bench.sensors.soil.hasReading(), "reading lands on a later loop pass");
+        check(bench.tmp.earlyReads == 0, "still never read early");
+    }
+
+    // Wake length with the conversions overlapping the ADC work against
+    // running them first and the ADC work after
+    printf("\n%-12s %14s %14s %10s\n", "ADC work ms", "overlapped ms", "sequential ms", "saved ms");
+    const uint32_t workMs[] = {0, 2, 5, 10, 20};
+    for (uint32_t work : workMs) {
+        Bench overlapped;
+        uint32_t withOverlap = overlapped.wake(work);
+        Bench sequential;
+        uint32_t start = millis();
+        sequential.sensors.start();
+        sequential.sensors.finish();
+        delay(work);
+        uint32_t withoutOverlap = millis() - start;
+        printf("%-12u %14u %14u %10d\n", work, withOverlap, withoutOverlap, (int)(withoutOverlap - withOverlap));
+    }
+
+    printf("\n%s\n", failures ? "FAILED" : "All checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,145 @@
+// Status display fan-out: the DisplayPipeline the sketch uses against the
+// virtual composite it replaced (CompositeStatusDisplay holding
+// factory-allocated sinks). Both fan out to three sinks of which only the
+// LED-like one handles events, as in the sketch. Prints RAM per design and
+// host nanoseconds per event; the fan-out of each design sits in its own
+// noinline function so its code size can be read from the binary.
+//
+// The pipeline is a structural change - no heap, sinks fixed at compile
+// time, event latching in one place - not a speed-up. On the host the two
+// designs measure within noise of each other per event (11.04 vs 11.17 ns
+// when committed) and the pipeline holds more RAM (120 bytes static
+// against 64 on the heap, most of it the event bus counters). There are
+// no MG24 numbers.
+//
+// Build from the repository root:
+//   g++ -std=gnu++17 -Os -Itools/host tools/display_pipeline_bench.cpp src/ui/StatusEventBus.cpp -o /tmp/display_pipeline_bench
+// Run:
+//   /tmp/display_pipeline_bench [events]
+// Fan-out code size (host x86, not the MG24 - use arm-none-eabi-size on the
+// Arduino build output for target flash):
+//   nm -C --size-sort -S /tmp/display_pipeline_bench | grep -E "FanOut|handleEvent|vtable"
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "../src/ui/DisplayPipeline.h"
+
+uint32_t hostMillis = 0;
+
+static const StatusEvent kEvents[] = {
+    StatusEvent::MoisturePublishing, StatusEvent::MoisturePublished,
+    StatusEvent::EnteringSleep, StatusEvent::BootComplete,  // One-shots - the bus passes every one
+};
+static const uint32_t kEventKinds = sizeof(kEvents) / sizeof(kEvents[0]);
+
+// --- Previous design: virtual sinks behind a virtual composite ---
+
+class VirtualLed : public StatusDisplay {
+public:
+    uint32_t handled = 0;
+    void begin() override {}
+    void handleEvent(StatusEvent event) override { handled += static_cast<uint8_t>(event); }
+    void showMoisture(float) override {}
+    void showMessage(const char*) override {}
+    void update() override {}
+};
+
+class VirtualQuiet : public StatusDisplay {
+public:
+    void begin() override {}
+    void handleEvent(StatusEvent) override {}
+    void showMoisture(float) override {}
+    void showMessage(const char*) override {}
+    void update() override {}
+};
+
+// CompositeStatusDisplay generalised to the three sinks it could not hold
+class VirtualComposite : public StatusDisplay {
+public:
+    StatusDisplay* sinks[3] = {};
+    void begin() override {}
+    void handleEvent(StatusEvent event) override {
+        for (StatusDisplay* sink : sinks) {
+            if (sink) {
+                sink->handleEvent(event);
+            }
+        }
+    }
+    void showMoisture(float) override {}
+    void showMessage(const char*) override {}
+    void update() override {}
+};
+
+// --- Current design: statically composed sinks ---
+
+class PipelineLed : public StatusSink {
+public:
+    uint32_t handled = 0;
+    void handleEvent(StatusEvent event) { handled += static_cast<uint8_t>(event); }
+};
+
+class PipelineOled : public StatusSink {};
+class PipelineSerial : public StatusSink {};
+
+typedef DisplayPipeline<PipelineLed, PipelineOled, PipelineSerial> Pipeline;
+
+// The sketch held a StatusDisplay* set up at boot; it now calls the pipeline object
+__attribute__((noinline)) static void virtualFanOut(StatusDisplay* display, StatusEvent event) {
+    display->handleEvent(event);
+}
+
+__attribute__((noinline)) static void pipelineFanOut(Pipeline& display, StatusEvent event) {
+    display.handleEvent(event);
+}
+
+template <typename Fn>
+static double nsPerEvent(uint32_t events, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < events; i++) {
+        fn(kEvents[i % kEventKinds]);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / events;
+}
+
+int main(int argc, char** argv) {
+    uint32_t events = argc > 1 ? strtoul(argv[1], nullptr, 10) : 20000000;
+
+    // Allocated at runtime as DisplayFactory::create*() did
+    VirtualComposite* composite = new VirtualComposite();
+    VirtualLed* led = new VirtualLed();
+    composite->sinks[0] = led;
+    composite->sinks[1] = new VirtualQuiet();
+    composite->sinks[2] = new VirtualQuiet();
+    StatusDisplay* display = composite;
+
+    static Pipeline pipeline;
+    pipeline.setEnabled<PipelineLed>(true);
+    pipeline.setEnabled<PipelineOled>(true);
+    pipeline.setEnabled<PipelineSerial>(true);
+
+    size_t virtualRam = sizeof(VirtualComposite) + sizeof(VirtualLed) + 2 * sizeof(VirtualQuiet);
+    size_t busRam = sizeof(StatusEventBus);
+    printf("RAM (host, 64-bit pointers)\n");
+    printf("  virtual composite  %4zu bytes on the heap, plus a vtable per class in flash\n", virtualRam);
+    printf("  pipeline           %4zu bytes static, %zu of them the event bus counters\n\n", sizeof(Pipeline),
+           busRam);
+
+    // Warm up, then time each design on the same event sequence
+    nsPerEvent(events / 10, [display](StatusEvent e) { virtualFanOut(display, e); });
+    nsPerEvent(events / 10, [](StatusEvent e) { pipelineFanOut(pipeline, e); });
+    double virtualNs = nsPerEvent(events, [display](StatusEvent e) { virtualFanOut(display, e); });
+    double pipelineNs = nsPerEvent(events, [](StatusEvent e) { pipelineFanOut(pipeline, e); });
+
+    printf("Per event, %u events over 3 sinks (1 with a handler)\n", events);
+    printf("  virtual composite  %6.2f ns\n", virtualNs);
+    printf("  pipeline           %6.2f ns (event bus admission included)\n", pipelineNs);
+
+    // Both LED sinks saw every event - keeps the work from being optimised out
+    if (led->handled != pipeline.get<PipelineLed>().handled) {
+        printf("FAIL: sinks saw different events\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+// EnergyBudget across the reset that ends every sleep on hardware: the same
+// wake sequence is run once with one controller that never resets, and once
+// with a fresh controller per wake that only has retained RAM to go on,
+// millis() starting from zero and the uplink's radio total restarting. Both
+// must reach an estimate, agree on the charge per wake, elapsed time and
+// solved interval, and a reset without suspend() must start over.
+//
+// Build from the repository root:
+//   g++ -std=gnu++17 -O2 -Itools/host tools/energy_budget_check.cpp src/hardware/EnergyBudget.cpp src/hardware/CalibrationJournal.cpp -o /tmp/energy_budget_check
+// Run:
+//   /tmp/energy_budget_check
+// Exit status: 0 when every check passes, 1 otherwise.
+#include <Arduino.h>
+#include <math.h>
+#include <stdio.h>
+#include "../src/hardware/EnergyBudget.h"
+
+uint32_t hostMillis = 0;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-56s %s\n", what, ok ? "ok" : "FAIL");
+    if (!ok) {
+        failures++;
+    }
+}
+
+static const uint32_t kWakes = 200;
+static const uint32_t kAwakeMs = 60;
+static const uint32_t kRadioMs = 40;
+static const uint32_t kPollsPerWake = 3;
+static const float kVoltage = 3.7f;
+static const uint8_t kStateOfCharge = 20;  // Low enough that the solved interval beats the configured one
+static const uint32_t kConfiguredMs = kNormalSleepInterval;
+static const uint32_t kLongestMs = 24UL * 3600UL * 1000UL;
+
+struct Outcome {
+    bool estimate;
+    float wakeChargeUc;
+    uint32_t elapsedSeconds;
+    uint32_t intervalMs;
+};
+
+// One controller, millis() running on through every sleep
+static Outcome runContinuous() {
+    EnergyBudget budget;
+    uint32_t now = 0;
+    uint32_t radioTotal = 0;
+    budget.begin(now);
+    for (uint32_t i = 0; i < kWakes; i++) {
+        budget.beginWake(now, 0, radioTotal, kPollsPerWake, kVoltage);
+        budget.update(now, kStateOfCharge, kConfiguredMs, kLongestMs);
+        radioTotal += kRadioMs;
+        now += kAwakeMs;
+        budget.endWake(now);
+        now += budget.getInterval() - kAwakeMs;
+    }
+    return {budget.hasEstimate(), budget.getWakeChargeUc(), budget.getElapsedSeconds(), budget.getInterval()};
+}
+
+// A fresh controller per wake, as after setup(); suspend() before each sleep
+static Outcome runWithResets() {
+    Outcome outcome = {};
+    for (uint32_t i = 0; i < kWakes; i++) {
+        EnergyBudget budget;
+        uint32_t now = 0;
+        budget.begin(now);
+        budget.beginWake(now, 0, 0, kPollsPerWake, kVoltage);
+        budget.update(now, kStateOfCharge, kConfiguredMs, kLongestMs);
+        now += kAwakeMs;
+        budget.endWake(now);
+        outcome = {budget.hasEstimate(), budget.getWakeChargeUc(), budget.getElapsedSeconds(), budget.getInterval()};
+        budget.suspend(now, budget.getInterval() - kAwakeMs, kRadioMs);
+    }
+    return outcome;
+}
+
+static bool near(float a, float b, float tolerance) {
+    return fabsf(a - b) <= tolerance * fabsf(b);
+}
+
+int main() {
+    Outcome continuous = runContinuous();
+    Outcome resets = runWithResets();
+
+    printf("After %u wakes        continuous    reset per sleep\n", kWakes);
+    printf("  charge per wake     %9.1f uC  %9.1f uC\n", continuous.wakeChargeUc, resets.wakeChargeUc);
+    printf("  elapsed             %9u s   %9u s\n", continuous.elapsedSeconds, resets.elapsedSeconds);
+    printf("  interval            %9u ms  %9u ms\n", continuous.intervalMs, resets.intervalMs);
+
+    printf("Resume\n");
+    check(continuous.estimate, "continuous run reaches an estimate");
+    check(resets.estimate, "reset per sleep reaches an estimate");
+    check(near(resets.wakeChargeUc, continuous.wakeChargeUc, 0.01f), "same charge per wake, radio time included");
+    check(near(resets.elapsedSeconds, continuous.elapsedSeconds, 0.01f), "sleeps count as elapsed time");
+    check(near(resets.intervalMs, continuous.intervalMs, 0.01f), "same solved interval");
+    check(resets.intervalMs > kConfiguredMs, "interval stretched past the configured one");
+
+    printf("Start over\n");
+    {
+        EnergyBudget resumed;
+        resumed.begin(0);  // The last run ended in suspend()
+        check(resumed.hasEstimate(), "boot after suspend() resumes");
+        EnergyBudget again;
+        again.begin(0);
+        check(!again.hasEstimate(), "a second reset without suspend() starts over");
+    }
+
+    printf("%s\n", failures ? "FAILED" : "all checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,160 @@
+// Peak concurrent transmissions for a fleet that boots together after a
+// power cut: fixed-interval reporting against ReportPhase staggering.
+// Every node shares one collision domain (the worst case - one router).
+//
+// Build and run from the repository root:
+//   g++ -std=gnu++17 -O2 -Itools/host tools/fleet_phase_sim.cpp src/matter/ReportPhase.cpp -o /tmp/fleet_phase_sim
+//   /tmp/fleet_phase_sim [nodes] [hours]
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "../src/matter/ReportPhase.h"
+
+uint32_t hostMillis = 0;
+
+static const double kTxMs = 15.0;          // CSMA + report frame + ack on 802.15.4
+static const double kBootSkewMs = 50.0;    // Nodes come up within this window after power returns
+static const double kClockPpm = 30.0;      // Crystal tolerance - local clocks drift apart
+
+enum class Strategy { Fixed, JitterOnly, PhaseOnly, PhaseJitter };
+
+struct Node {
+    double bootMs;   // Global time the node booted
+    double rate;     // Local ms per global ms
+    uint8_t id[8];
+};
+
+struct Result {
+    uint32_t transmissions;
+    uint32_t peak;          // Most transmissions on air at once
+    uint32_t bootPeak;      // Same, first minute after power returns
+    uint32_t lastHourPeak;  // Same, once clock drift has had the whole run
+    uint32_t overlapped;    // Transmissions that overlapped any other
+};
+
+static uint32_t rng = 0x2545F491;
+static uint32_t nextRandom() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static double uniform() { return (nextRandom() & 0xFFFFFF) / (double)0x1000000; }
+
+// Transmission start times (global ms) of one node over the horizon
+static void schedule(const Node& node, Strategy strategy, double horizonMs, std::vector<double>& starts) {
+    uint32_t hash = nodeIdentityHash(node.id, sizeof(node.id));
+    const uint32_t interval = kNormalSleepInterval;
+    ReportPhase phase;
+    phase.begin(hash, 0);
+    uint32_t jitterRng = hash ? hash : 1;
+
+    uint32_t local = 0;
+    switch (strategy) {
+        case Strategy::PhaseOnly:
+        case Strategy::PhaseJitter:
+            local = phase.firstWake();
+            break;
+        default:
+            break;  // Old firmware measured as soon as it booted
+    }
+
+    for (;;) {
+        double global = node.bootMs + local / node.rate;
+        if (global >= horizonMs) break;
+        starts.push_back(global);
+
+        switch (strategy) {
+            case Strategy::Fixed:
+                local += interval;
+                break;
+            case Strategy::JitterOnly: {
+                // Seeded per-node jitter accumulated on the interval - no phase
+                jitterRng ^= jitterRng << 13;
+                jitterRng ^= jitterRng >> 17;
+                jitterRng ^= jitterRng << 5;
+                uint32_t spread = (interval / 100) * kReportPhaseJitterPercent;
+                local += interval - spread + jitterRng % (2 * spread + 1);
+                break;
+            }
+            case Strategy::PhaseOnly: {
+                uint32_t next = phase.nextWake(local, interval);
+                local = next - phase.getLastJitterMs();  // Slot without the jitter
+                break;
+            }
+            case Strategy::PhaseJitter:
+                local = phase.nextWake(local, interval);
+                break;
+        }
+    }
+}
+
+static Result run(const std::vector<Node>& fleet, Strategy strategy, double horizonMs) {
+    std::vector<double> starts;
+    for (const Node& node : fleet) {
+        schedule(node, strategy, horizonMs, starts);
+    }
+    std::sort(starts.begin(), starts.end());
+
+    Result result = {};
+    result.transmissions = starts.size();
+    // Sweep: a transmission is on air for kTxMs after it starts
+    size_t oldest = 0;
+    std::vector<bool> overlapped(starts.size(), false);
+    for (size_t i = 0; i < starts.size(); i++) {
+        while (starts[oldest] + kTxMs <= starts[i]) oldest++;
+        uint32_t onAir = i - oldest + 1;
+        if (onAir > 1) {
+            for (size_t j = oldest; j <= i; j++) overlapped[j] = true;
+        }
+        result.peak = max(result.peak, onAir);
+        if (starts[i] < 60000.0) {
+            result.bootPeak = max(result.bootPeak, onAir);
+        }
+        if (starts[i] >= horizonMs - 3600000.0) {
+            result.lastHourPeak = max(result.lastHourPeak, onAir);
+        }
+    }
+    for (bool o : overlapped) {
+        result.overlapped += o;
+    }
+    return result;
+}
+
+int main(int argc, char** argv) {
+    uint32_t nodes = argc > 1 ? atoi(argv[1]) : 500;
+    double hours = argc > 2 ? atof(argv[2]) : 24.0;
+    double horizonMs = hours * 3600000.0;
+
+    // Sequential EUI-64s from one vendor block - the worst case for a weak hash
+    std::vector<Node> fleet(nodes);
+    for (uint32_t i = 0; i < nodes; i++) {
+        Node& node = fleet[i];
+        node.bootMs = uniform() * kBootSkewMs;
+        node.rate = 1.0 + (uniform() * 2.0 - 1.0) * kClockPpm * 1e-6;
+        uint64_t eui = 0x34107AFFFE000000ull + i;
+        for (uint8_t b = 0; b < 8; b++) {
+            node.id[b] = (uint8_t)(eui >> (56 - 8 * b));
+        }
+    }
+
+    printf("%u nodes, %.0f h, %u ms interval, %.0f ms on air, boot skew %.0f ms, +/-%.0f ppm\n\n",
+           nodes, hours, kNormalSleepInterval, kTxMs, kBootSkewMs, kClockPpm);
+    printf("%-16s %10s %6s %10s %10s %11s\n", "strategy", "transmits", "peak", "boot peak",
+           "last hour", "overlapped");
+
+    const struct { Strategy strategy; const char* name; } strategies[] = {
+        {Strategy::Fixed, "fixed"},
+        {Strategy::JitterOnly, "jitter only"},
+        {Strategy::PhaseOnly, "phase only"},
+        {Strategy::PhaseJitter, "phase + jitter"},
+    };
+    for (const auto& s : strategies) {
+        Result r = run(fleet, s.strategy, horizonMs);
+        printf("%-16s %10u %6u %10u %10u %10.1f%%\n", s.name, r.transmissions, r.peak, r.bootPeak,
+               r.lastHourPeak, 100.0 * r.overlapped / r.transmissions);
+    }
+    return 0;
+}
@@ -0,0 +1,280 @@
+// Fleet load simulator: N complete sensor nodes - the firmware's sensor,
+// battery, power, calibration, uplink and GreenThreadSoilSensorCluster
+// modules - each with its own simulated soil and battery trace, run in
+// virtual time. Every report attempt and cluster event is recorded and
+// summarised as hub-side load (messages per minute, burst sizes) and
+// per-node energy.
+//
+// Nodes (tools/SimNode.h) step in global time order, each on its own
+// drifting clock. The host NVM stand-ins are process-wide: every node
+// boots from the same erased image, as a freshly flashed fleet would.
+//
+// Build and run from the repository root:
+//   g++ -std=gnu++17 -O2 -Itools/host tools/fleet_sim.cpp src/hardware/SensorManager.cpp src/hardware/SensorFaultDetector.cpp src/hardware/BatteryMonitor.cpp src/hardware/StateOfCharge.cpp src/hardware/CalibrationManager.cpp src/hardware/CalibrationJournal.cpp src/hardware/PowerManager.cpp src/hardware/EnergyBudget.cpp src/hardware/AutoCalibrator.cpp src/hardware/P2Quantile.cpp src/hardware/ThresholdWake.cpp src/hardware/TemperatureCompensator.cpp src/config/ConfigStore.cpp src/matter/GreenThreadSoilSensorCluster.cpp src/matter/MoistureBandEngine.cpp src/matter/DryForecaster.cpp src/matter/IcdPolicy.cpp src/matter/ReportUplink.cpp src/matter/ReportPhase.cpp src/matter/ConnectivityMonitor.cpp -o /tmp/fleet_sim
+//   /tmp/fleet_sim [nodes] [days] [records.csv]
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <memory>
+#include <queue>
+#include <vector>
+#include "SimNode.h"
+#include "NetworkStandIn.h"
+
+uint32_t hostMillis = 0;
+
+static const double kBootSkewMs = 50.0;       // Fleet powers up together
+static const double kClockPpm = 30.0;
+static const double kBurstWindowMs = 1000.0;  // Messages in the same window arrive as one burst at the hub
+static const uint8_t kFloatingProbePercent = 1;
+static const float kCellResistanceOhm = 0.15f;
+
+static uint32_t rng = 0x9E3779B9;
+static uint32_t nextRandom() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+static double uniform() { return (nextRandom() & 0xFFFFFF) / (double)0x1000000; }
+static double uniform(double lo, double hi) { return lo + (hi - lo) * uniform(); }
+
+enum class RecordKind : uint8_t { Report, Event };
+
+struct Record {
+    double globalMs;
+    uint16_t node;
+    RecordKind kind;
+    uint8_t id;       // Event ID; 1 = delivered / 0 = lost for reports
+};
+
+static std::vector<Record> records;
+
+// Alkaline cell open-circuit voltage against remaining charge
+static const float kCellCurve[][2] = {
+    {0.00f, 0.90f}, {0.10f, 1.10f}, {0.30f, 1.20f}, {0.50f, 1.27f},
+    {0.70f, 1.35f}, {0.90f, 1.45f}, {1.00f, 1.58f},
+};
+
+static float cellVoltage(float remaining) {
+    remaining = constrain(remaining, 0.0f, 1.0f);
+    for (size_t i = 1; i < sizeof(kCellCurve) / sizeof(kCellCurve[0]); i++) {
+        if (remaining <= kCellCurve[i][0]) {
+            float t = (remaining - kCellCurve[i - 1][0]) / (kCellCurve[i][0] - kCellCurve[i - 1][0]);
+            return kCellCurve[i - 1][1] + t * (kCellCurve[i][1] - kCellCurve[i - 1][1]);
+        }
+    }
+    return kCellCurve[6][1];
+}
+
+struct Node {
+    uint16_t index;
+    double bootMs;
+    double rate;          // Local ms per global ms
+    uint8_t id[8];
+    SimNode firmware;
+    NetworkStandIn network;
+
+    // Soil trace: exponential dry-down towards a residual, watered some
+    // hours after crossing the gardener's trigger point
+    double soilPercent;
+    double dryTimeConstantH;
+    double wateringTrigger;
+    double wateringAtMs = -1;
+    double lastSoilMs = 0;
+    bool floatingProbe;
+    double probeFailsAtMs;
+
+    // Battery trace - drained by the firmware's metered wakes
+    double capacityUc;
+    double initialUsedUc;
+
+    double globalTime(uint32_t local) const { return bootMs + local / rate; }
+    uint32_t localTime(double global) const { return (uint32_t)((global - bootMs) * rate); }
+    double remaining() const { return 1.0 - (initialUsedUc + firmware.getChargeUc()) / capacityUc; }
+
+    void advanceSoil(double globalMs) {
+        double hours = (globalMs - lastSoilMs) / 3600000.0;
+        lastSoilMs = globalMs;
+        soilPercent = 3.0 + (soilPercent - 3.0) * exp(-hours / dryTimeConstantH);
+        if (wateringAtMs < 0 && soilPercent < wateringTrigger) {
+            wateringAtMs = globalMs + uniform(0.0, 12.0) * 3600000.0;
+        }
+        if (wateringAtMs >= 0 && globalMs >= wateringAtMs) {
+            soilPercent = uniform(85.0, 95.0);
+            wateringAtMs = -1;
+        }
+    }
+
+    int readAnalog(uint8_t pin) {
+        if (pin == kMoisturePin) {
+            if (floatingProbe && lastSoilMs >= probeFailsAtMs) {
+                return nextRandom() % 1024;
+            }
+            double noisy = soilPercent + uniform(-0.6, 0.6) + uniform(-0.6, 0.6);
+            double raw = kDefaultMoistureDry - (kDefaultMoistureDry - kDefaultMoistureWet) * noisy / 100.0;
+            return constrain((int)(raw + 0.5), 0, 1023);
+        }
+        // Battery through the divider, sagging under the sample load
+        float volts = kBatteryCells * (cellVoltage(remaining()) - kBatterySampleLoadUa * 1e-6f * kCellResistanceOhm);
+        return constrain((int)(volts / kBatteryVoltageDivider * kAdcReference + uniform(-1.0, 1.0)), 0, 1023);
+    }
+
+    static int analogThunk(uint8_t pin, void* context) { return static_cast<Node*>(context)->readAnalog(pin); }
+
+    static bool sendThunk(const QueuedReading& reading, uint32_t& onMs, void* context) {
+        Node* node = static_cast<Node*>(context);
+        bool ok = node->network.deliver(millis(), onMs);
+        records.push_back({node->globalTime(millis()), node->index, RecordKind::Report, (uint8_t)ok});
+        return ok;
+    }
+
+    static void eventThunk(uint8_t eventId, const uint8_t* data, size_t length, void* context) {
+        Node* node = static_cast<Node*>(context);
+        records.push_back({node->globalTime(millis()), node->index, RecordKind::Event, eventId});
+    }
+
+    // Returns the first wake in global time
+    double boot() {
+        uint32_t hash = nodeIdentityHash(id, sizeof(id));
+        network.rng = hash ? hash : 1;
+        return globalTime(firmware.begin(localTime(bootMs), hash, analogThunk, this,
+                                         sendThunk, this, eventThunk, this));
+    }
+
+    // Returns the next wake in global time
+    double wake(double globalMs) {
+        advanceSoil(globalMs);
+        return globalTime(firmware.wake(localTime(globalMs)));
+    }
+};
+
+static double percentile(std::vector<uint32_t>& values, double p) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    size_t index = std::min(values.size() - 1, (size_t)(p * (values.size() - 1) + 0.5));
+    return values[index];
+}
+
+int main(int argc, char** argv) {
+    uint32_t nodeCount = argc > 1 ? atoi(argv[1]) : 200;
+    double days = argc > 2 ? atof(argv[2]) : 3.0;
+    const char* csvPath = argc > 3 ? argv[3] : nullptr;
+    double horizonMs = days * 86400000.0;
+
+    std::vector<std::unique_ptr<Node>> fleet;
+    typedef std::pair<double, uint16_t> Wake;
+    std::priority_queue<Wake, std::vector<Wake>, std::greater<Wake>> schedule;
+
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        std::unique_ptr<Node> node(new Node());
+        node->index = i;
+        node->bootMs = uniform() * kBootSkewMs;
+        node->rate = 1.0 + uniform(-1.0, 1.0) * kClockPpm * 1e-6;
+        uint64_t eui = 0x34107AFFFE000000ull + i;
+        for (uint8_t b = 0; b < 8; b++) {
+            node->id[b] = (uint8_t)(eui >> (56 - 8 * b));
+        }
+        node->soilPercent = uniform(30.0, 90.0);
+        node->dryTimeConstantH = uniform(48.0, 144.0);
+        node->wateringTrigger = uniform(15.0, 30.0);
+        node->lastSoilMs = node->bootMs;
+        node->floatingProbe = (nextRandom() % 100) < kFloatingProbePercent;
+        node->probeFailsAtMs = uniform(0.0, horizonMs);
+        node->capacityUc = kBatteryCapacityMah * 3600.0 * 1000.0;
+        node->initialUsedUc = node->capacityUc * uniform(0.0, 0.4);  // Packs of mixed age
+        schedule.push(Wake(node->boot(), i));
+        fleet.push_back(std::move(node));
+    }
+
+    while (!schedule.empty()) {
+        Wake due = schedule.top();
+        schedule.pop();
+        if (due.first >= horizonMs) continue;
+        schedule.push(Wake(fleet[due.second]->wake(due.first), due.second));
+    }
+
+    std::sort(records.begin(), records.end(),
+              [](const Record& a, const Record& b) { return a.globalMs < b.globalMs; });
+
+    // Hub load: messages per minute and back-to-back bursts
+    std::vector<uint32_t> perMinute((size_t)(horizonMs / 60000.0) + 1, 0);
+    std::vector<uint32_t> bursts;
+    uint32_t reports = 0, lost = 0, eventCount = 0;
+    uint32_t eventsById[8] = {};
+    int64_t lastWindow = -1;
+    for (const Record& r : records) {
+        perMinute[(size_t)(r.globalMs / 60000.0)]++;
+        int64_t window = (int64_t)(r.globalMs / kBurstWindowMs);
+        if (window == lastWindow) {
+            bursts.back()++;
+        } else {
+            bursts.push_back(1);
+        }
+        lastWindow = window;
+        if (r.kind == RecordKind::Report) {
+            reports++;
+            lost += (r.id == 0);
+        } else {
+            eventCount++;
+            eventsById[r.id & 7]++;
+        }
+    }
+
+    printf("%u nodes, %.1f days, boot skew %.0f ms, +/-%.0f ppm, %u%% floating probes\n\n",
+           nodeCount, days, kBootSkewMs, kClockPpm, kFloatingProbePercent);
+    printf("Messages: %u reports (%u lost), %u events\n", reports, lost, eventCount);
+    printf("Events by ID: threshold %u, battery %u, power %u, calibration %u, error %u, forecast %u\n",
+           eventsById[0], eventsById[1], eventsById[2], eventsById[3], eventsById[4], eventsById[5]);
+    std::vector<uint32_t> minutes = perMinute;
+    double total = 0;
+    for (uint32_t m : perMinute) total += m;
+    printf("Messages/min: mean %.1f, p50 %.0f, p99 %.0f, max %.0f\n",
+           total / perMinute.size(), percentile(minutes, 0.5), percentile(minutes, 0.99),
+           percentile(minutes, 1.0));
+    printf("Bursts (per %.0f ms window): %zu, mean size %.2f, p99 %.0f, max %.0f\n\n",
+           kBurstWindowMs, bursts.size(), (double)records.size() / std::max<size_t>(bursts.size(), 1),
+           percentile(bursts, 0.99), percentile(bursts, 1.0));
+
+    // Per-node energy
+    double minMah = 1e9, maxMah = 0, sumMah = 0, sumRadio = 0;
+    uint32_t minDays = UINT32_MAX, maxDays = 0, totalWakes = 0;
+    double totalPolls = 0;
+    uint32_t minInterval = UINT32_MAX, maxInterval = 0;
+    for (const auto& node : fleet) {
+        double mahPerDay = node->firmware.getChargeUc() / 1000.0 / 3600.0 / days;
+        minMah = std::min(minMah, mahPerDay);
+        maxMah = std::max(maxMah, mahPerDay);
+        sumMah += mahPerDay;
+        sumRadio += node->firmware.getRadioOnMs() / 1000.0 / days;
+        totalWakes += node->firmware.getWakes();
+        totalPolls += node->firmware.getIcdPolls();
+        uint32_t interval = node->firmware.powerManager.getCurrentSleepInterval();
+        minInterval = std::min(minInterval, interval);
+        maxInterval = std::max(maxInterval, interval);
+        uint32_t projected = node->firmware.energyBudget.getProjectedDays();
+        minDays = std::min(minDays, projected);
+        maxDays = std::max(maxDays, projected);
+    }
+    printf("Per node: %.3f mAh/day (min %.3f, max %.3f), radio on %.1f s/day, %.0f wakes/day, %.0f ICD polls/day\n",
+           sumMah / nodeCount, minMah, maxMah, sumRadio / nodeCount, totalWakes / days / nodeCount,
+           totalPolls / days / nodeCount);
+    printf("Final interval: %.1f..%.1f s\n", minInterval / 1000.0, maxInterval / 1000.0);
+    printf("Projected lifetime: %u..%u days (target %u)\n", minDays, maxDays, kTargetLifetimeDays);
+
+    if (csvPath) {
+        FILE* csv = fopen(csvPath, "w");
+        if (!csv) {
+            perror(csvPath);
+            return 1;
+        }
+        fprintf(csv, "time_ms,node,kind,value\n");
+        for (const Record& r : records) {
+            fprintf(csv, "%.1f,%u,%s,%u\n", r.globalMs, r.node,
+                    r.kind == RecordKind::Report ? "report" : "event", r.id);
+        }
+        fclose(csv);
+        printf("Wrote %zu records to %s\n", records.size(), csvPath);
+    }
+    return 0;
+}
@@ -0,0 +1,65 @@
+#pragma once
+// Minimal Arduino surface for host-side tools. Only what the firmware
+// modules built by tools/ actually use - not a general emulation.
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (s)
+#define memcpy_P memcpy
+#define strcpy_P strcpy
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+#define A0 0
+#define A1 1
+#define A2 2
+#define A3 3
+#define A6 6
+#define INPUT 0
+#define OUTPUT 1
+#define DEC 10
+#define HEX 16
+#define constrain(x, lo, hi) ((x) < (lo) ? (lo) : ((x) > (hi) ? (hi) : (x)))
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// Virtual clock - tools advance it explicitly
+extern uint32_t hostMillis;
+inline uint32_t millis() { return hostMillis; }
+inline uint32_t micros() { return hostMillis * 1000; }
+inline void delay(uint32_t ms) { hostMillis += ms; }
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+inline void pinMode(uint8_t pin, uint8_t mode) {}
+
+// Analog inputs - tools route reads to their simulated hardware
+typedef int (*HostAnalogReadFn)(uint8_t pin, void* context);
+inline HostAnalogReadFn hostAnalogRead = nullptr;
+inline void* hostAnalogContext = nullptr;
+inline int analogRead(uint8_t pin) {
+  return hostAnalogRead ? hostAnalogRead(pin, hostAnalogContext) : 0;
+}
+
+// Firmware logging is discarded - tools print their own results
+struct HostSerial {
+  void begin(unsigned long baud) {}
+  template <typename T> size_t print(const T& value, int format = DEC) { return 0; }
+  template <typename T> size_t println(const T& value, int format = DEC) { return 0; }
+  size_t println() { return 0; }
+  void flush() {}
+};
+inline HostSerial Serial;
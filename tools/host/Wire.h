@@ -0,0 +1,66 @@
+#pragma once
+// Wire surface used by I2cBus, routed to device models attached by
+// address (see tools/I2cStandIn.h). An empty address NACKs, as on a bus
+// with nothing fitted there.
+#include <Arduino.h>
+
+class HostI2cDevice {
+public:
+  virtual ~HostI2cDevice() = default;
+  // False NACKs the transfer
+  virtual bool write(const uint8_t* data, uint8_t length) = 0;
+  virtual bool read(uint8_t* data, uint8_t length) = 0;
+};
+
+class TwoWire {
+public:
+  static const uint8_t BUFFER_SIZE = 32;
+
+  void attach(uint8_t address, HostI2cDevice* device) { devices[address & 0x7F] = device; }
+  void detach(uint8_t address) { devices[address & 0x7F] = nullptr; }
+
+  void begin() {}
+  void setClock(uint32_t hz) {}
+
+  void beginTransmission(uint8_t address) {
+    txAddress = address & 0x7F;
+    txLength = 0;
+  }
+  size_t write(const uint8_t* data, size_t length) {
+    size_t accepted = min(length, (size_t)(BUFFER_SIZE - txLength));
+    memcpy(txBuffer + txLength, data, accepted);
+    txLength += accepted;
+    return accepted;
+  }
+  uint8_t endTransmission(bool stop = true) {
+    transfers++;
+    HostI2cDevice* device = devices[txAddress];
+    return device && device->write(txBuffer, txLength) ? 0 : 2;
+  }
+
+  uint8_t requestFrom(uint8_t address, uint8_t length) {
+    transfers++;
+    HostI2cDevice* device = devices[address & 0x7F];
+    rxIndex = 0;
+    rxLength = 0;
+    if (device && length <= BUFFER_SIZE && device->read(rxBuffer, length)) {
+      rxLength = length;
+    }
+    return rxLength;
+  }
+  int read() { return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1; }
+
+  uint32_t getTransfers() const { return transfers; }
+
+private:
+  HostI2cDevice* devices[128] = {};
+  uint8_t txAddress = 0;
+  uint8_t txBuffer[BUFFER_SIZE];
+  uint8_t txLength = 0;
+  uint8_t rxBuffer[BUFFER_SIZE];
+  uint8_t rxLength = 0;
+  uint8_t rxIndex = 0;
+  uint32_t transfers = 0;
+};
+
+inline TwoWire Wire;
@@ -0,0 +1,173 @@
+// LedPatternPlayer stepped in virtual time: every output edge must land on
+// its scheduled time however late the player is serviced, repeats and
+// completion must follow the pattern, and millis() rollover must not bend
+// the sequence. This is the fallback path; on hardware LETIMER calls the
+// same applyStep() at each scheduled edge.
+//
+// Build from the repository root:
+//   g++ -std=gnu++17 -O2 -Itools/host tools/led_pattern_check.cpp src/ui/LedPatternPlayer.cpp -o /tmp/led_pattern_check
+// Run:
+//   /tmp/led_pattern_check
+// Exit status: 0 when every check passes, 1 otherwise.
+#include <Arduino.h>
+#include <stdio.h>
+#include <vector>
+#include "../src/ui/LedPatternPlayer.h"
+
+uint32_t hostMillis = 0;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-56s %s\n", what, ok ? "ok" : "FAIL");
+    if (!ok) {
+        failures++;
+    }
+}
+
+struct Edge {
+    uint8_t color;
+    uint32_t edgeMs;
+};
+
+struct Recorder {
+    std::vector<Edge> edges;
+    const LedPattern* completed = nullptr;
+    uint32_t completions = 0;
+
+    static void outputThunk(uint8_t color, uint32_t edgeMs, void* context) {
+        static_cast<Recorder*>(context)->edges.push_back({color, edgeMs});
+    }
+
+    static void completeThunk(const LedPattern* pattern, void* context) {
+        Recorder* recorder = static_cast<Recorder*>(context);
+        recorder->completed = pattern;
+        recorder->completions++;
+    }
+};
+
+// 100 ms on in the pattern color, 50 ms red, 250 ms dark
+static const LedStep kBlinkSteps[] PROGMEM = {
+    {LED_STEP_PATTERN_COLOR, 100},
+    {1, 50},
+    {0, 250},
+};
+static const LedPattern kBlink = {kBlinkSteps, 3, 2};
+static const uint32_t kBlinkPeriodMs = 400;
+
+static const LedStep kZeroSteps[] PROGMEM = {
+    {2, 0},
+    {0, 10},
+};
+static const LedPattern kZero = {kZeroSteps, 2, 1};
+static const LedPattern kForever = {kBlinkSteps, 3, 0};
+
+// The edges kBlink must produce from startMs for the given repeat count,
+// ending with the dark edge that finishes the pattern
+static std::vector<Edge> expectedBlink(uint32_t startMs, uint8_t patternColor, uint8_t repeats) {
+    std::vector<Edge> edges;
+    uint32_t t = startMs;
+    for (uint8_t r = 0; r < repeats; r++) {
+        edges.push_back({patternColor, t});
+        edges.push_back({1, t + 100});
+        edges.push_back({0, t + 150});
+        t += kBlinkPeriodMs;
+    }
+    edges.push_back({0, t});
+    return edges;
+}
+
+static bool sameEdges(const std::vector<Edge>& a, const std::vector<Edge>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].color != b[i].color || a[i].edgeMs != b[i].edgeMs) {
+            printf("    edge %zu: color %u at %u, expected color %u at %u\n", i, a[i].color, a[i].edgeMs,
+                   b[i].color, b[i].edgeMs);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Plays kBlink from startMs and services it every stepMs until it ends
+static Recorder playBlink(uint32_t startMs, uint32_t stepMs, uint8_t repeatOverride = 0) {
+    Recorder recorder;
+    LedPatternPlayer player;
+    player.begin(Recorder::outputThunk, Recorder::completeThunk, &recorder);
+    player.play(&kBlink, 5, startMs, repeatOverride);
+    uint32_t t = startMs;
+    for (int guard = 0; player.isPlaying() && guard < 100000; guard++) {
+        t += stepMs;
+        player.service(t);
+    }
+    return recorder;
+}
+
+int main() {
+    printf("Edge times\n");
+    {
+        Recorder recorder = playBlink(1000, 1);
+        check(sameEdges(recorder.edges, expectedBlink(1000, 5, 2)), "serviced every 1 ms: edges on schedule");
+        check(recorder.completions == 1 && recorder.completed == &kBlink, "completes once, reporting its pattern");
+    }
+    {
+        Recorder recorder = playBlink(1000, 37);
+        check(sameEdges(recorder.edges, expectedBlink(1000, 5, 2)), "serviced every 37 ms: no drift from late service");
+    }
+    {
+        Recorder recorder = playBlink(1000, 5000);
+        check(sameEdges(recorder.edges, expectedBlink(1000, 5, 2)), "one late service catches up every edge");
+    }
+    {
+        Recorder recorder = playBlink(1000, 7, 4);
+        check(sameEdges(recorder.edges, expectedBlink(1000, 5, 4)), "repeat override replaces the pattern count");
+    }
+    {
+        uint32_t start = 0xFFFFFFFFUL - 500;
+        Recorder recorder = playBlink(start, 13);
+        check(sameEdges(recorder.edges, expectedBlink(start, 5, 2)), "edges carry across millis() rollover");
+    }
+
+    printf("Scheduling\n");
+    {
+        Recorder recorder;
+        LedPatternPlayer player;
+        player.begin(Recorder::outputThunk, Recorder::completeThunk, &recorder);
+        player.play(&kBlink, 5, 2000);
+        check(player.getNextEdgeMs() == 2100, "next edge is the first step's end");
+        player.service(2099);
+        check(recorder.edges.size() == 1, "nothing fires before the edge");
+        player.service(2100);
+        check(recorder.edges.size() == 2 && player.getNextEdgeMs() == 2150, "edge fires at its time, next one scheduled");
+    }
+    {
+        Recorder recorder;
+        LedPatternPlayer player;
+        player.begin(Recorder::outputThunk, Recorder::completeThunk, &recorder);
+        player.play(&kZero, 5, 3000);
+        player.service(3000);
+        check(player.getNextEdgeMs() == 3001, "a zero-length step lasts 1 ms");
+        player.service(3100);
+        check(!player.isPlaying() && recorder.edges.back().edgeMs == 3011, "pattern with a zero step still ends on time");
+    }
+    {
+        Recorder recorder;
+        LedPatternPlayer player;
+        player.begin(Recorder::outputThunk, Recorder::completeThunk, &recorder);
+        player.play(&kForever, 5, 0);
+        player.service(kBlinkPeriodMs * 1000);
+        check(player.isPlaying() && recorder.completions == 0, "repeat count 0 plays forever");
+        check(player.getNextEdgeMs() == kBlinkPeriodMs * 1000 + 100, "forever pattern still on its period");
+        player.play(&kBlink, 6, 500000);
+        check(recorder.completions == 0 && recorder.edges.back().edgeMs == 500000,
+              "replacing a pattern restarts it silently");
+        player.stop();
+        player.service(600000);
+        check(!player.isPlaying() && recorder.completions == 0, "stop ends without a completion");
+    }
+
+    printf("%s\n", failures ? "FAILED" : "all checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,115 @@
+// Radio-on time against outage length: ReportUplink backoff vs retrying
+// on every measurement wake. The widest gap between delivered readings
+// shows how much of the outage the thinned queue still covers.
+//
+// Build and run from the repository root:
+//   g++ -std=gnu++17 -O2 -Itools/host tools/report_backoff_bench.cpp src/matter/ReportUplink.cpp -o /tmp/report_backoff_bench
+//   /tmp/report_backoff_bench
+#include <Arduino.h>
+#include <stdio.h>
+#include "NetworkStandIn.h"
+
+uint32_t hostMillis = 0;
+
+static const uint32_t kWakeMs = kNormalSleepInterval;
+static const uint32_t kRecoveryMs = 3600000;  // Simulate an hour after the outage ends
+
+struct Result {
+  uint32_t radioOnMs;
+  uint32_t attempts;
+  uint32_t delivered;
+  uint32_t dropped;
+  uint32_t recoveryMs;  // Outage end to the first delivery after it
+  uint32_t maxGapS;     // Widest gap between delivered readings
+};
+
+// Stand-in that also tracks the delivered readings' timestamps
+struct TrackedNetwork {
+  NetworkStandIn net;
+  bool delivered = false;
+  uint32_t lastTimestampS = 0;
+  uint32_t maxGapS = 0;
+
+  static bool send(const QueuedReading& reading, uint32_t& radioOnMs, void* context) {
+    TrackedNetwork* tracked = static_cast<TrackedNetwork*>(context);
+    if (!tracked->net.deliver(millis(), radioOnMs)) {
+      return false;
+    }
+    if (tracked->delivered && reading.timestampS - tracked->lastTimestampS > tracked->maxGapS) {
+      tracked->maxGapS = reading.timestampS - tracked->lastTimestampS;
+    }
+    tracked->delivered = true;
+    tracked->lastTimestampS = reading.timestampS;
+    return true;
+  }
+};
+
+// Baseline: every wake tries to flush the queue until the first failure
+static Result runNaive(uint32_t outageMs) {
+  NetworkStandIn net;
+  net.outageStartMs = kWakeMs;
+  net.outageEndMs = kWakeMs + outageMs;
+  Result result = {};
+  result.recoveryMs = UINT32_MAX;
+  uint32_t queued = 0;
+
+  for (hostMillis = 0; hostMillis < net.outageEndMs + kRecoveryMs; hostMillis += kWakeMs) {
+    if (queued == kReportQueueDepth) {
+      result.dropped++;
+    } else {
+      queued++;
+    }
+    for (uint8_t sent = 0; queued > 0 && sent < kReportBatchMax; sent++) {
+      uint32_t onMs;
+      result.attempts++;
+      bool ok = net.deliver(hostMillis, onMs);
+      result.radioOnMs += onMs;
+      if (!ok) break;
+      queued--;
+      result.delivered++;
+      if (hostMillis >= net.outageEndMs && result.recoveryMs == UINT32_MAX) {
+        result.recoveryMs = hostMillis - net.outageEndMs;
+      }
+    }
+  }
+  return result;
+}
+
+static Result runUplink(uint32_t outageMs) {
+  TrackedNetwork tracked;
+  NetworkStandIn& net = tracked.net;
+  net.outageStartMs = kWakeMs;
+  net.outageEndMs = kWakeMs + outageMs;
+  ReportUplink uplink;
+  uplink.begin(TrackedNetwork::send, &tracked, 0xC0FFEE);
+
+  uint32_t recoveryMs = UINT32_MAX;
+  for (hostMillis = 0; hostMillis < net.outageEndMs + kRecoveryMs; hostMillis += kWakeMs) {
+    QueuedReading reading = { hostMillis / 1000, {500}, 3000, 80 };
+    uplink.enqueue(reading);
+    if (uplink.service(hostMillis) > 0 && hostMillis >= net.outageEndMs && recoveryMs == UINT32_MAX) {
+      recoveryMs = hostMillis - net.outageEndMs;
+    }
+  }
+  return { uplink.getRadioOnMs(), uplink.getAttempts(), uplink.getDelivered(), uplink.getDropped(), recoveryMs,
+           tracked.maxGapS };
+}
+
+int main() {
+  static const uint32_t outagesMin[] = { 0, 10, 60, 360, 1440 };
+
+  printf("wake every %lu s, 2%% background loss, 2 s radio-on per lost report\n\n",
+         (unsigned long)(kWakeMs / 1000));
+  printf("outage | retry every wake           | backoff + queue\n");
+  printf(" (min) | radio s  tries  recover s | radio s  tries  recover s  thinned  max gap min\n");
+  for (uint32_t minutes : outagesMin) {
+    Result naive = runNaive(minutes * 60000UL);
+    Result backoff = runUplink(minutes * 60000UL);
+    printf("%6lu | %7.1f %6lu %10lu | %7.1f %6lu %10lu %8lu %12.1f\n",
+           (unsigned long)minutes,
+           naive.radioOnMs / 1000.0, (unsigned long)naive.attempts, (unsigned long)(naive.recoveryMs / 1000),
+           backoff.radioOnMs / 1000.0, (unsigned long)backoff.attempts,
+           (unsigned long)(backoff.recoveryMs / 1000), (unsigned long)backoff.dropped, backoff.maxGapS / 60.0);
+  }
+  return 0;
+}
@@ -0,0 +1,187 @@
+// Moisture temperature compensation over a trace with soil temperature: the
+// same trace replayed through a full SimNode with compensation off, with the
+// trace's own coefficient configured, and learning it. The reference run
+// replays the trace with the drift taken out, so its band events are the
+// ones the soil itself caused; anything past them is temperature. Each mode
+// runs with periodic sampling and in threshold-wake mode, where a spurious
+// crossing also costs a wake.
+//
+// Build from the repository root:
+//   g++ -std=gnu++17 -O2 -Itools/host tools/temp_comp_bench.cpp src/hardware/SensorManager.cpp src/hardware/SensorFaultDetector.cpp src/hardware/BatteryMonitor.cpp src/hardware/StateOfCharge.cpp src/hardware/CalibrationManager.cpp src/hardware/CalibrationJournal.cpp src/hardware/PowerManager.cpp src/hardware/EnergyBudget.cpp src/hardware/AutoCalibrator.cpp src/hardware/P2Quantile.cpp src/hardware/ThresholdWake.cpp src/hardware/TemperatureCompensator.cpp src/config/ConfigStore.cpp src/matter/GreenThreadSoilSensorCluster.cpp src/matter/MoistureBandEngine.cpp src/matter/DryForecaster.cpp src/matter/IcdPolicy.cpp src/matter/ReportUplink.cpp src/matter/ReportPhase.cpp src/matter/ConnectivityMonitor.cpp -o /tmp/temp_comp_bench
+// Run:
+//   /tmp/temp_comp_bench [trace] [counts_per_degC]
+//   (default tools/traces/diurnal_14d.csv, which drifts 3.0 counts/degC)
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "AdcTrace.h"
+#include "SimNode.h"
+
+uint32_t hostMillis = 0;
+
+static const uint32_t kComparatorStepMs = 1000;
+static const uint32_t kBenchIdentity = 0x5EED0001;
+static const double kDefaultCoefficient = 3.0;  // diurnal_14d.csv
+
+enum class BenchMode { Reference, Off, Configured, Learn };
+
+struct Run {
+    BenchMode mode;
+    bool threshold;
+    AdcTrace* truth = nullptr;  // Drift-free trace the reported moisture is scored against
+    uint32_t wakes = 0;
+    uint32_t crossingWakes = 0;
+    uint32_t bandEvents = 0;
+    uint32_t alertChanges = 0;
+    uint8_t lastAlert = 0xFF;
+    double squaredError = 0;
+    uint32_t scored = 0;
+    double chargeMah = 0;
+    int16_t coefficientQ8 = 0;
+    int32_t trustedAtMs = -1;
+
+    static bool sendThunk(const QueuedReading& reading, uint32_t& radioOnMs, void* context) {
+        Run* run = static_cast<Run*>(context);
+        radioOnMs = kReportRadioMs;
+        if (reading.moistureTenths[0] != QueuedReading::NO_MOISTURE) {
+            double truthRaw = run->truth->level(kMoisturePin, millis());
+            double truthPercent = constrain(100.0 * (kDefaultMoistureDry - truthRaw) /
+                                            (kDefaultMoistureDry - kDefaultMoistureWet), 0.0, 100.0);
+            double error = reading.moistureTenths[0] / 10.0 - truthPercent;
+            run->squaredError += error * error;
+            run->scored++;
+        }
+        return true;
+    }
+
+    static void eventThunk(uint8_t eventId, const uint8_t* data, size_t length, void* context) {
+        Run* run = static_cast<Run*>(context);
+        if (eventId != GreenThreadSoilSensorCluster::EVENT_MOISTURE_THRESHOLD_CROSSED || length < 3) {
+            return;
+        }
+        run->bandEvents++;
+        if (data[2] != run->lastAlert) {
+            if (run->lastAlert != 0xFF) {
+                run->alertChanges++;
+            }
+            run->lastAlert = data[2];
+        }
+    }
+};
+
+// The trace with the drift taken out and no temperature left to compensate
+static void removeDrift(AdcTrace& trace, double coefficient) {
+    for (TraceSample& sample : trace.samples) {
+        double raw = sample.moistureRaw - coefficient * (sample.temperatureCentiC - kTempCompReferenceCentiC) / 100.0;
+        sample.moistureRaw = (uint16_t)constrain(lround(raw), 0L, 1023L);
+        sample.temperatureCentiC = 0;
+    }
+    trace.hasTemperature = false;
+}
+
+static bool replay(const char* path, double coefficient, Run& run) {
+    AdcTrace trace, truth;
+    if (!trace.load(path) || !truth.load(path)) {
+        return false;
+    }
+    removeDrift(truth, coefficient);
+    if (run.mode == BenchMode::Reference) {
+        removeDrift(trace, coefficient);
+    }
+    run.truth = &truth;
+
+    SimNode node;
+    node.setTemperatureSource(AdcTrace::temperatureThunk, &trace);
+    uint32_t next = node.begin(0, kBenchIdentity, AdcTrace::analogThunk, &trace,
+                               Run::sendThunk, &run, Run::eventThunk, &run);
+    node.thresholdWake.setEnabled(run.threshold);
+    switch (run.mode) {
+        case BenchMode::Off:
+        case BenchMode::Reference:
+            node.temperatureCompensator.setMode(TempCompMode::Off);
+            break;
+        case BenchMode::Configured:
+            node.temperatureCompensator.setMode(TempCompMode::Configured);
+            node.temperatureCompensator.setConfiguredCoefficient(0, (int16_t)lround(coefficient * 256.0));
+            break;
+        case BenchMode::Learn:
+            node.temperatureCompensator.setMode(TempCompMode::Learn);
+            node.temperatureCompensator.reset();  // The host store outlives the node - no fit from the last run
+            break;
+    }
+
+    uint32_t endMs = trace.getEndMs();
+    while ((int32_t)(endMs - next) >= 0) {
+        if (node.thresholdWake.isArmed()) {
+            for (uint32_t t = millis() + kComparatorStepMs; (int32_t)(next - t) > 0; t += kComparatorStepMs) {
+                node.comparator.sample((uint16_t)lround(trace.level(kMoisturePin, t)));
+                if (node.thresholdWake.takeTrigger()) {
+                    next = t;
+                    run.crossingWakes++;
+                    break;
+                }
+            }
+        }
+        next = node.wake(next);
+        if (run.trustedAtMs < 0 && run.mode == BenchMode::Learn && node.temperatureCompensator.isLearned(0)) {
+            run.trustedAtMs = (int32_t)millis();
+        }
+    }
+
+    run.wakes = node.getWakes();
+    run.chargeMah = node.getChargeUc() / 3600.0 / 1000.0;
+    run.coefficientQ8 = node.temperatureCompensator.getCoefficient(0);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : "tools/traces/diurnal_14d.csv";
+    double coefficient = argc > 2 ? atof(argv[2]) : kDefaultCoefficient;
+    AdcTrace trace;
+    if (!trace.load(path)) {
+        return 2;
+    }
+    if (!trace.hasTemperature) {
+        fprintf(stderr, "%s: no temperature column - nothing to compensate\n", path);
+        return 2;
+    }
+    printf("%s: %.1f days, drift %.2f counts/degC from %.1f degC\n\n", path, trace.getEndMs() / 86400000.0,
+           coefficient, kTempCompReferenceCentiC / 100.0);
+
+    const struct { const char* name; BenchMode mode; } modes[] = {
+        {"reference", BenchMode::Reference},
+        {"off", BenchMode::Off},
+        {"configured", BenchMode::Configured},
+        {"learn", BenchMode::Learn},
+    };
+    for (bool threshold : {false, true}) {
+        printf("%s sampling\n", threshold ? "Threshold-wake" : "Periodic");
+        printf("%-11s %8s %9s %11s %8s %9s %10s %10s %9s\n", "mode", "wakes", "crossing", "band events",
+               "alerts", "spurious", "rms err %", "charge mAh", "coeff");
+        uint32_t referenceEvents = 0;
+        for (const auto& m : modes) {
+            Run run;
+            run.mode = m.mode;
+            run.threshold = threshold;
+            if (!replay(path, coefficient, run)) {
+                return 2;
+            }
+            if (m.mode == BenchMode::Reference) {
+                referenceEvents = run.bandEvents;
+            }
+            printf("%-11s %8u %9u %11u %8u %9d %10.2f %10.3f %9.2f\n", m.name, run.wakes, run.crossingWakes,
+                   run.bandEvents, run.alertChanges, (int)run.bandEvents - (int)referenceEvents,
+                   run.scored ? sqrt(run.squaredError / run.scored) : 0.0, run.chargeMah, run.coefficientQ8 / 256.0);
+            if (m.mode == BenchMode::Learn) {
+                if (run.trustedAtMs >= 0) {
+                    printf("  learned coefficient trusted after %.1f h\n", run.trustedAtMs / 3600000.0);
+                } else {
+                    printf("  learned coefficient never trusted\n");
+                }
+            }
+        }
+        printf("\n");
+    }
+    printf("spurious = band events past the reference run, which replays the trace with the drift removed\n");
+    return 0;
+}
@@ -0,0 +1,142 @@
+// Wake-on-threshold against periodic sampling: the same ADC trace replayed
+// through a full SimNode in both modes. In threshold mode the comparator
+// model watches the interpolated probe level every kComparatorStepMs while
+// the node sleeps, and a crossing wakes it early.
+//
+// Build from the repository root:
+//   g++ -std=gnu++17 -O2 -Itools/host tools/threshold_wake_bench.cpp src/hardware/SensorManager.cpp src/hardware/SensorFaultDetector.cpp src/hardware/BatteryMonitor.cpp src/hardware/StateOfCharge.cpp src/hardware/CalibrationManager.cpp src/hardware/CalibrationJournal.cpp src/hardware/PowerManager.cpp src/hardware/EnergyBudget.cpp src/hardware/AutoCalibrator.cpp src/hardware/P2Quantile.cpp src/hardware/ThresholdWake.cpp src/hardware/TemperatureCompensator.cpp src/config/ConfigStore.cpp src/matter/GreenThreadSoilSensorCluster.cpp src/matter/MoistureBandEngine.cpp src/matter/DryForecaster.cpp src/matter/IcdPolicy.cpp src/matter/ReportUplink.cpp src/matter/ReportPhase.cpp src/matter/ConnectivityMonitor.cpp -o /tmp/threshold_wake_bench
+// Run:
+//   /tmp/threshold_wake_bench [trace]   (default tools/traces/synthetic_14d.csv)
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "AdcTrace.h"
+#include "SimNode.h"
+
+uint32_t hostMillis = 0;
+
+static const uint32_t kComparatorStepMs = 1000;
+static const double kComparatorCurrentUa = 1.0;  // Both ACMPs at low accuracy in EM2 (datasheet order)
+static const uint32_t kBenchIdentity = 0x5EED0001;
+
+struct AlertChange {
+    uint32_t timeMs;
+    uint8_t alertType;  // 0 = low, 1 = high, 2 = normal
+};
+
+struct Run {
+    uint32_t wakes = 0;
+    uint32_t crossingWakes = 0;
+    uint32_t bandEvents = 0;
+    uint32_t dryForecasts = 0;
+    uint32_t reports = 0;
+    double armedMs = 0;
+    double chargeMah = 0;
+    std::vector<AlertChange> alerts;
+    uint8_t lastAlert = 0xFF;
+
+    static bool sendThunk(const QueuedReading& reading, uint32_t& radioOnMs, void* context) {
+        static_cast<Run*>(context)->reports++;
+        radioOnMs = kReportRadioMs;
+        return true;
+    }
+
+    static void eventThunk(uint8_t eventId, const uint8_t* data, size_t length, void* context) {
+        Run* run = static_cast<Run*>(context);
+        typedef GreenThreadSoilSensorCluster Cluster;
+        if (eventId == Cluster::EVENT_DRY_FORECAST) {
+            run->dryForecasts++;
+        }
+        if (eventId != Cluster::EVENT_MOISTURE_THRESHOLD_CROSSED || length < 3) {
+            return;
+        }
+        run->bandEvents++;
+        if (data[2] != run->lastAlert) {
+            if (run->lastAlert != 0xFF) {
+                run->alerts.push_back({millis(), data[2]});
+            }
+            run->lastAlert = data[2];
+        }
+    }
+};
+
+static bool replay(const char* path, bool threshold, Run& run) {
+    AdcTrace trace;
+    if (!trace.load(path)) {
+        return false;
+    }
+    SimNode node;
+    uint32_t next = node.begin(0, kBenchIdentity, AdcTrace::analogThunk, &trace,
+                               Run::sendThunk, &run, Run::eventThunk, &run);
+    node.thresholdWake.setEnabled(threshold);
+
+    uint32_t endMs = trace.getEndMs();
+    while ((int32_t)(endMs - next) >= 0) {
+        if (node.thresholdWake.isArmed()) {
+            // Comparator watches the probe until the scheduled wake
+            uint32_t from = millis();
+            for (uint32_t t = from + kComparatorStepMs; (int32_t)(next - t) > 0; t += kComparatorStepMs) {
+                node.comparator.sample((uint16_t)lround(trace.level(kMoisturePin, t)));
+                if (node.thresholdWake.takeTrigger()) {
+                    next = t;
+                    run.crossingWakes++;
+                    break;
+                }
+            }
+            run.armedMs += next - from;
+        }
+        next = node.wake(next);
+    }
+
+    run.wakes = node.getWakes();
+    double comparatorUc = kComparatorCurrentUa * run.armedMs / 1000.0;
+    run.chargeMah = (node.getChargeUc() + comparatorUc) / 3600.0 / 1000.0;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : "tools/traces/synthetic_14d.csv";
+    Run periodic, threshold;
+    if (!replay(path, false, periodic) || !replay(path, true, threshold)) {
+        return 2;
+    }
+    AdcTrace trace;
+    trace.load(path);
+    double days = trace.getEndMs() / 86400000.0;
+
+    printf("%s: %.1f days, heartbeat %u s, comparator %u levels, %.1f uA while armed\n\n",
+           path, days, kThresholdWakeHeartbeatMs / 1000, kThresholdWakeLevels, kComparatorCurrentUa);
+    printf("%-10s %10s %10s %9s %11s %8s %10s %10s\n", "mode", "wakes", "wakes/day", "crossing",
+           "band events", "alerts", "forecasts", "charge mAh");
+    const struct { const char* name; const Run& run; } rows[] = {{"periodic", periodic}, {"threshold", threshold}};
+    for (const auto& row : rows) {
+        const Run& r = row.run;
+        printf("%-10s %10u %10.0f %9u %11u %8zu %10u %10.3f\n", row.name, r.wakes, r.wakes / days,
+               r.crossingWakes, r.bandEvents, r.alerts.size(), r.dryForecasts, r.chargeMah);
+    }
+    printf("\nWakes: %.1f%% of periodic, charge: %.1f%% of periodic\n",
+           100.0 * threshold.wakes / periodic.wakes, 100.0 * threshold.chargeMah / periodic.chargeMah);
+
+    // Alert changes (low/normal/high) should match one for one; the delay is
+    // how much later threshold mode reported each one
+    if (periodic.alerts.size() != threshold.alerts.size()) {
+        printf("Alert changes differ: %zu periodic, %zu threshold\n", periodic.alerts.size(), threshold.alerts.size());
+        return 0;
+    }
+    double totalDelayS = 0, maxDelayS = 0;
+    for (size_t i = 0; i < periodic.alerts.size(); i++) {
+        if (periodic.alerts[i].alertType != threshold.alerts[i].alertType) {
+            printf("Alert change %zu differs in type\n", i);
+            return 0;
+        }
+        double delayS = ((double)threshold.alerts[i].timeMs - periodic.alerts[i].timeMs) / 1000.0;
+        totalDelayS += delayS;
+        maxDelayS = max(maxDelayS, delayS);
+    }
+    if (!periodic.alerts.empty()) {
+        printf("Alert delay vs periodic: mean %.0f s, max %.0f s over %zu changes\n",
+               totalDelayS / periodic.alerts.size(), maxDelayS, periodic.alerts.size());
+    }
+    return 0;
+}
@@ -0,0 +1,180 @@
+// Replays a recorded ADC trace through the firmware pipeline - SensorManager
+// and BatteryMonitor into GreenThreadSoilSensorCluster, reports through
+// ReportUplink into MatterStandardClusters - in virtual time, and compares
+// the resulting traffic and energy against a stored golden output. A
+// firmware change that raises wakes, reports, events or energy beyond the
+// tolerance, or changes threshold/forecast/error behaviour, fails.
+//
+// The firmware's own scheduler picks the wake times; inputs are played
+// back by AdcTrace, which also documents the trace formats. Reports are
+// always acknowledged after kReportRadioMs (Config.h), the radio time the
+// firmware charges per report.
+//
+// Golden files hold one "metric value" pair per line.
+//
+// Build from the repository root:
+//   g++ -std=gnu++17 -O2 -Itools/host tools/trace_replay.cpp src/hardware/SensorManager.cpp src/hardware/SensorFaultDetector.cpp src/hardware/BatteryMonitor.cpp src/hardware/StateOfCharge.cpp src/hardware/CalibrationManager.cpp src/hardware/CalibrationJournal.cpp src/hardware/PowerManager.cpp src/hardware/EnergyBudget.cpp src/hardware/AutoCalibrator.cpp src/hardware/P2Quantile.cpp src/hardware/ThresholdWake.cpp src/hardware/TemperatureCompensator.cpp src/config/ConfigStore.cpp src/matter/GreenThreadSoilSensorCluster.cpp src/matter/MatterStandardClusters.cpp src/matter/MoistureBandEngine.cpp src/matter/DryForecaster.cpp src/matter/IcdPolicy.cpp src/matter/ReportUplink.cpp src/matter/ReportPhase.cpp src/matter/ConnectivityMonitor.cpp -o /tmp/trace_replay
+// Run:
+//   /tmp/trace_replay <trace> [golden] [--update] [--tolerance percent]
+// Exit status: 0 pass, 1 regression against the golden, 2 bad input.
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "AdcTrace.h"
+#include "SimNode.h"
+#include "../src/matter/MatterStandardClusters.h"
+
+uint32_t hostMillis = 0;
+
+static const uint32_t kReplayIdentity = 0x5EED0001;  // Fixed phase and jitter - runs are reproducible
+
+// Budget metrics may not grow past the tolerance; exact ones may not change
+enum class MetricKind { Budget, Exact };
+
+struct Metric {
+    const char* name;
+    MetricKind kind;
+    double value;
+};
+
+struct Replay {
+    AdcTrace trace;
+    MatterStandardClusters standardClusters;
+    uint32_t reports = 0;
+    uint32_t events = 0;
+    uint32_t eventsById[8] = {};
+
+    // publishReading() from the sketch
+    static bool sendThunk(const QueuedReading& reading, uint32_t& radioOnMs, void* context) {
+        Replay* replay = static_cast<Replay*>(context);
+        for (uint8_t probe = 0; probe < kMoistureProbeCount; probe++) {
+            if (reading.moistureTenths[probe] != QueuedReading::NO_MOISTURE) {
+                replay->standardClusters.updateMoisture(reading.moistureTenths[probe] / 10.0, probe);
+            }
+        }
+        replay->standardClusters.updateBattery(reading.batteryMv / 1000.0, reading.batteryPercent);
+        replay->reports++;
+        radioOnMs = kReportRadioMs;
+        return true;
+    }
+
+    static void eventThunk(uint8_t eventId, const uint8_t* data, size_t length, void* context) {
+        Replay* replay = static_cast<Replay*>(context);
+        replay->events++;
+        replay->eventsById[eventId & 7]++;
+    }
+};
+
+static bool readGolden(const char* path, const char* name, double& value) {
+    FILE* file = fopen(path, "r");
+    if (!file) return false;
+    char line[128], key[64];
+    double parsed;
+    bool found = false;
+    while (!found && fgets(line, sizeof(line), file)) {
+        if (line[0] != '#' && sscanf(line, "%63s %lf", key, &parsed) == 2 && strcmp(key, name) == 0) {
+            value = parsed;
+            found = true;
+        }
+    }
+    fclose(file);
+    return found;
+}
+
+int main(int argc, char** argv) {
+    const char* tracePath = nullptr;
+    const char* goldenPath = nullptr;
+    bool update = false;
+    double tolerancePercent = 1.0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--update") == 0) {
+            update = true;
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerancePercent = atof(argv[++i]);
+        } else if (!tracePath) {
+            tracePath = argv[i];
+        } else {
+            goldenPath = argv[i];
+        }
+    }
+    if (!tracePath || (update && !goldenPath)) {
+        fprintf(stderr, "usage: %s <trace> [golden] [--update] [--tolerance percent]\n", argv[0]);
+        return 2;
+    }
+
+    Replay replay;
+    if (!replay.trace.load(tracePath)) {
+        return 2;
+    }
+    uint32_t endMs = replay.trace.getEndMs();
+
+    replay.standardClusters.begin();
+    SimNode node;
+    if (replay.trace.hasTemperature) {
+        node.setTemperatureSource(AdcTrace::temperatureThunk, &replay.trace);
+    }
+    uint32_t next = node.begin(0, kReplayIdentity, AdcTrace::analogThunk, &replay.trace,
+                               Replay::sendThunk, &replay, Replay::eventThunk, &replay);
+    while ((int32_t)(endMs - next) >= 0) {
+        next = node.wake(next);
+    }
+
+    typedef GreenThreadSoilSensorCluster Cluster;
+    const Metric metrics[] = {
+        {"wakes", MetricKind::Budget, (double)node.getWakes()},
+        {"reports", MetricKind::Budget, (double)replay.reports},
+        {"events", MetricKind::Budget, (double)replay.events},
+        {"radio_on_ms", MetricKind::Budget, node.getRadioOnMs()},
+        {"awake_ms", MetricKind::Budget, node.getAwakeMs()},
+        {"charge_mah", MetricKind::Budget, node.getChargeUc() / 3600.0 / 1000.0},
+        {"threshold_crossings", MetricKind::Exact, (double)replay.eventsById[Cluster::EVENT_MOISTURE_THRESHOLD_CROSSED]},
+        {"dry_forecasts", MetricKind::Exact, (double)replay.eventsById[Cluster::EVENT_DRY_FORECAST]},
+        {"system_errors", MetricKind::Exact, (double)replay.eventsById[Cluster::EVENT_SYSTEM_ERROR]},
+    };
+
+    printf("%s: %zu samples, %.1f days replayed, %.0f ICD polls/day\n\n", tracePath, replay.trace.samples.size(),
+           endMs / 86400000.0, node.getIcdPolls() / (endMs / 86400000.0));
+
+    if (update) {
+        FILE* golden = fopen(goldenPath, "w");
+        if (!golden) {
+            perror(goldenPath);
+            return 2;
+        }
+        fprintf(golden, "# Golden replay output for %s - regenerate with --update\n", tracePath);
+        for (const Metric& m : metrics) {
+            fprintf(golden, "%s %.3f\n", m.name, m.value);
+        }
+        fclose(golden);
+    }
+
+    int failures = 0;
+    printf("%-20s %14s %14s  %s\n", "metric", "value", "golden", "result");
+    for (const Metric& m : metrics) {
+        double expected;
+        if (!goldenPath || !readGolden(goldenPath, m.name, expected)) {
+            printf("%-20s %14.3f %14s\n", m.name, m.value, "-");
+            continue;
+        }
+        const char* result = "ok";
+        if (m.kind == MetricKind::Exact) {
+            if (fabs(m.value - expected) > 0.0005) {
+                result = "CHANGED";
+                failures++;
+            }
+        } else if (m.value > expected * (1.0 + tolerancePercent / 100.0) + 0.0005) {
+            result = "REGRESSED";
+            failures++;
+        } else if (m.value < expected - 0.0005) {
+            result = "improved - refresh with --update";
+        }
+        printf("%-20s %14.3f %14.3f  %s\n", m.name, m.value, expected, result);
+    }
+
+    if (failures > 0) {
+        printf("\n%d metric(s) outside the golden output (budget tolerance %.1f%%)\n", failures, tolerancePercent);
+        return 1;
+    }
+    return 0;
+}